@@ -4,6 +4,7 @@
 #include "common/Acceleration/AccelerationTypes.h"
 #include "common/Acceleration/AccelerationStructure.h"
 #include "common/Acceleration/AccelerationNode.h"
+#include "common/Acceleration/TraceQuery.h"
 #include "common/Acceleration/Naive/NaiveAcceleration.h"
 #include "common/Acceleration/BVH/BVHAcceleration.h"
 #include "common/Acceleration/UniformGrid/UniformGridAcceleration.h"
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "common/Acceleration/AccelerationNode.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 
 std::atomic<uint64_t> AccelerationNode::globalIdCount(0);
 
@@ -6,3 +7,15 @@ AccelerationNode::AccelerationNode():
     uniqueId(++globalIdCount)
 {
 }
+
+uint64_t AccelerationNode::TracePacket(const SceneObject* parentObject, RayPacket& packet, uint64_t laneMask) const
+{
+    uint64_t hitMask = 0;
+    while (laneMask) {
+        const int lane = RayPacket::PopLane(laneMask);
+        if (Trace(parentObject, packet.rays[lane], packet.outputs[lane])) {
+            hitMask |= uint64_t(1) << lane;
+        }
+    }
+    return hitMask;
+}
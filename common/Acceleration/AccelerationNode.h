@@ -12,6 +12,12 @@ public:
 
     virtual Box GetBoundingBox() const = 0;
     virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const = 0;
+    // Closest hit query for the rays of the packet selected by laneMask. Returns the lanes that found a closer hit.
+    // Nodes without a packet path trace the lanes one at a time.
+    virtual uint64_t TracePacket(const class SceneObject* parentObject, struct RayPacket& packet, uint64_t laneMask) const;
+    // Structure holding the nodes below this one (scene objects and meshes), so that queries that look past the closest hit
+    // can traverse it themselves. parentObject is updated to the object whose space the nested nodes are in.
+    virtual const class AccelerationStructure* GetNestedAcceleration(const class SceneObject*& parentObject) const { return nullptr; }
     virtual uint64_t GetUniqueId() const { return uniqueId; }
     virtual std::string GetHumanIdentifier() const { return ""; }
 private:
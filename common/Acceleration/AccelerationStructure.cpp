@@ -1,5 +1,6 @@
 #include "common/Acceleration/AccelerationStructure.h"
 #include "common/Scene/SceneObject.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 
 AccelerationStructure::AccelerationStructure()
 {
@@ -7,4 +8,21 @@ AccelerationStructure::AccelerationStructure()
 
 AccelerationStructure::~AccelerationStructure()
 {
+}
+
+bool AccelerationStructure::Trace(const SceneObject* sceneObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    return outputIntersection ? TraceClosestHit(sceneObject, inputRay, *outputIntersection) : TraceAnyHit(sceneObject, inputRay, nullptr);
+}
+
+uint64_t AccelerationStructure::TracePacket(const SceneObject* sceneObject, RayPacket& packet, uint64_t laneMask) const
+{
+    uint64_t hitMask = 0;
+    while (laneMask) {
+        const int lane = RayPacket::PopLane(laneMask);
+        if (Trace(sceneObject, packet.rays[lane], packet.outputs[lane])) {
+            hitMask |= uint64_t(1) << lane;
+        }
+    }
+    return hitMask;
 }
\ No newline at end of file
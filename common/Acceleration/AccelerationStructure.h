@@ -21,7 +21,20 @@ public:
         InternalInitialization();
     }
 
-    virtual bool Trace(const class SceneObject* sceneObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const = 0;
+    // Closest hit if outputIntersection is given, any hit otherwise. The check happens once here rather than at every step
+    // of the traversal.
+    bool Trace(const class SceneObject* sceneObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const;
+
+    // One traversal per query policy, see TraceQuery.h. All of them only consider hits up to the ray's max T.
+    virtual bool TraceClosestHit(const class SceneObject* sceneObject, class Ray* inputRay, struct IntersectionState& outputIntersection) const = 0;
+    // anyHit, if given, receives the hit that ended the query, which need not be the closest one.
+    virtual bool TraceAnyHit(const class SceneObject* sceneObject, class Ray* inputRay, struct IntersectionState* anyHit) const = 0;
+    virtual bool TraceAllHits(const class SceneObject* sceneObject, class Ray* inputRay, class HitCollector& collector) const = 0;
+    // Closest hit that the filter accepts; the filter sees candidates in no particular order.
+    virtual bool TraceFilteredHit(const class SceneObject* sceneObject, class Ray* inputRay, struct IntersectionState& outputIntersection, const class HitFilter& filter) const = 0;
+
+    // See AccelerationNode::TracePacket. Structures without a packet path trace the lanes one at a time.
+    virtual uint64_t TracePacket(const class SceneObject* sceneObject, struct RayPacket& packet, uint64_t laneMask) const;
 protected:
     std::vector<std::shared_ptr<AccelerationNode>> nodes;
 
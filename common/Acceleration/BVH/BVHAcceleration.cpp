@@ -1,6 +1,9 @@
 #include "common/Acceleration/BVH/BVHAcceleration.h"
 #include "common/Acceleration/BVH/Internal/BVHNode.h"
+#include "common/Acceleration/TraceQuery.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
+#include "common/Scene/SceneObject.h"
 #include "common/Intersection/IntersectionState.h"
 
 BVHAcceleration::BVHAcceleration():
@@ -8,9 +11,34 @@ BVHAcceleration::BVHAcceleration():
 {
 }
 
-bool BVHAcceleration::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+bool BVHAcceleration::TraceClosestHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection) const
 {
-    return rootNode->Trace(parentObject, inputRay, outputIntersection);
+    ClosestHitQuery query(outputIntersection);
+    return rootNode->Trace(parentObject, inputRay, query);
+}
+
+bool BVHAcceleration::TraceAnyHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState* anyHit) const
+{
+    AnyHitQuery query(anyHit);
+    return rootNode->Trace(parentObject, inputRay, query);
+}
+
+bool BVHAcceleration::TraceAllHits(const SceneObject* parentObject, Ray* inputRay, HitCollector& collector) const
+{
+    AllHitsQuery query(collector);
+    return rootNode->Trace(parentObject, inputRay, query);
+}
+
+bool BVHAcceleration::TraceFilteredHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection, const HitFilter& filter) const
+{
+    FilteredHitQuery query(outputIntersection, filter);
+    return rootNode->Trace(parentObject, inputRay, query);
+}
+
+uint64_t BVHAcceleration::TracePacket(const SceneObject* parentObject, RayPacket& packet, uint64_t laneMask) const
+{
+    RayPacketFrame frame(packet, laneMask, parentObject ? parentObject->GetWorldToObjectMatrix() : glm::mat4(1.f));
+    return rootNode->TracePacket(parentObject, packet, frame, laneMask);
 }
 
 void BVHAcceleration::InternalInitialization()
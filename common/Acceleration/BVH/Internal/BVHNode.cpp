@@ -1,7 +1,16 @@
 #include "common/Acceleration/BVH/Internal/BVHNode.h"
 #include "common/Acceleration/AccelerationNode.h"
+#include "common/Acceleration/TraceQuery.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Intersection/IntersectionState.h"
 
+namespace
+{
+// Below this many active rays the SIMD box test does more work than tracing the remaining rays on their own.
+const int MINIMUM_PACKET_LANES = 4;
+const int PACKET_STACK_SIZE = 128;
+}
+
 BVHNode::BVHNode(std::vector<std::shared_ptr<AccelerationNode>>& childObjects, int maximumChildren, int nodesOnLeaves, int splitDim):
     isLeafNode(false)
 {
@@ -48,34 +57,83 @@ void BVHNode::CreateParentNode(std::vector<std::shared_ptr<class AccelerationNod
     }
 }
 
-bool BVHNode::Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const
+template<typename Query>
+bool BVHNode::Trace(const SceneObject* parentObject, Ray* inputRay, Query& query) const
 {
-    float previousIntersectionT = outputIntersection ? outputIntersection->intersectionT : 0.f;
-    if (!boundingBox.Trace(parentObject, inputRay, outputIntersection)) {
-        if (outputIntersection) {
-            outputIntersection->intersectionT = previousIntersectionT;
-        }
-        return false;
+    // Box::Trace overwrites the T of the state it culls against.
+    IntersectionState* cullingState = query.GetCullingState();
+    const float previousIntersectionT = cullingState ? cullingState->intersectionT : 0.f;
+    const bool hitBox = boundingBox.Trace(parentObject, inputRay, cullingState);
+    if (cullingState) {
+        cullingState->intersectionT = previousIntersectionT;
     }
-
-    if (outputIntersection) {
-        outputIntersection->intersectionT = previousIntersectionT;
+    if (!hitBox) {
+        return false;
     }
 
     bool hitObject = false;
-    // Merge these two branches....
     if (isLeafNode) {
-        for (size_t i = 0; i < leafNodes.size(); ++i) {
-            hitObject |= leafNodes[i]->Trace(parentObject, inputRay, outputIntersection);
+        for (size_t i = 0; i < leafNodes.size() && !query.IsFinished(); ++i) {
+            hitObject |= query.TraceLeaf(*leafNodes[i], parentObject, inputRay, AcceptAnyHit());
         }
     } else {
-        for (size_t i = 0; i < childBVHNodes.size(); ++i) {
-            hitObject |= childBVHNodes[i]->Trace(parentObject, inputRay, outputIntersection);
+        for (size_t i = 0; i < childBVHNodes.size() && !query.IsFinished(); ++i) {
+            hitObject |= childBVHNodes[i]->Trace(parentObject, inputRay, query);
         }
     }
     return hitObject;
 }
 
+uint64_t BVHNode::TracePacket(const SceneObject* parentObject, RayPacket& packet, RayPacketFrame& frame, uint64_t laneMask) const
+{
+    // All rays share one traversal stack; every entry remembers which rays are still interested in that node.
+    std::array<std::pair<const BVHNode*, uint64_t>, PACKET_STACK_SIZE> stack;
+    int stackSize = 0;
+    stack[stackSize++] = std::make_pair(this, laneMask);
+
+    uint64_t hitMask = 0;
+    while (stackSize > 0) {
+        const BVHNode* node = stack[stackSize - 1].first;
+        uint64_t activeMask = stack[--stackSize].second;
+
+        // Once the packet has diverged, finish the subtree one ray at a time.
+        if (RayPacket::CountLanes(activeMask) < MINIMUM_PACKET_LANES) {
+            for (uint64_t remaining = activeMask; remaining;) {
+                const int lane = RayPacket::PopLane(remaining);
+                ClosestHitQuery query(*packet.outputs[lane]);
+                if (node->Trace(parentObject, packet.rays[lane], query)) {
+                    hitMask |= uint64_t(1) << lane;
+                }
+            }
+            frame.UpdateClosestT(packet, activeMask);
+            continue;
+        }
+
+        activeMask = node->boundingBox.TracePacket(frame, activeMask);
+        if (!activeMask) {
+            continue;
+        }
+
+        if (node->isLeafNode) {
+            for (size_t i = 0; i < node->leafNodes.size(); ++i) {
+                hitMask |= node->leafNodes[i]->TracePacket(parentObject, packet, activeMask);
+            }
+            frame.UpdateClosestT(packet, activeMask);
+            continue;
+        }
+
+        // Push in reverse so that children are visited in the same order as BVHNode::Trace.
+        for (size_t i = node->childBVHNodes.size(); i-- > 0;) {
+            if (stackSize < PACKET_STACK_SIZE) {
+                stack[stackSize++] = std::make_pair(node->childBVHNodes[i].get(), activeMask);
+            } else {
+                hitMask |= node->childBVHNodes[i]->TracePacket(parentObject, packet, frame, activeMask);
+            }
+        }
+    }
+    return hitMask;
+}
+
 std::string BVHNode::PrintContents() const
 {
     std::ostringstream ss;
@@ -89,4 +147,9 @@ std::string BVHNode::PrintContents() const
         }
     }
     return ss.str();
-}
\ No newline at end of file
+}
+
+template bool BVHNode::Trace<ClosestHitQuery>(const SceneObject*, Ray*, ClosestHitQuery&) const;
+template bool BVHNode::Trace<AnyHitQuery>(const SceneObject*, Ray*, AnyHitQuery&) const;
+template bool BVHNode::Trace<AllHitsQuery>(const SceneObject*, Ray*, AllHitsQuery&) const;
+template bool BVHNode::Trace<FilteredHitQuery>(const SceneObject*, Ray*, FilteredHitQuery&) const;
@@ -7,7 +7,10 @@ class BVHNode : public std::enable_shared_from_this <BVHNode>
 {
 public:
     BVHNode(std::vector<std::shared_ptr<class AccelerationNode>>& childObjects, int maximumChildren, int nodesOnLeaves, int splitDim = 0);
-    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const;
+    // Instantiated for the query policies of TraceQuery.h.
+    template<typename Query>
+    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, Query& query) const;
+    uint64_t TracePacket(const class SceneObject* parentObject, struct RayPacket& packet, struct RayPacketFrame& frame, uint64_t laneMask) const;
 private:
     void CreateLeafNode(std::vector<std::shared_ptr<class AccelerationNode>>& childObjects);
     void CreateParentNode(std::vector<std::shared_ptr<class AccelerationNode>>& childObjects, int maximumChildren, int nodesOnLeaves, int splitDim);
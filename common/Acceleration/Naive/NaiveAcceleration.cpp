@@ -1,5 +1,7 @@
 #include "common/Acceleration/Naive/NaiveAcceleration.h"
+#include "common/Acceleration/TraceQuery.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Intersection/IntersectionState.h"
 
 void NaiveAcceleration::AddNode(std::shared_ptr<AccelerationNode> node)
@@ -7,16 +9,35 @@ void NaiveAcceleration::AddNode(std::shared_ptr<AccelerationNode> node)
     nodes.push_back(std::move(node));
 }
 
-bool NaiveAcceleration::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+bool NaiveAcceleration::TraceClosestHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection) const
 {
-    bool hasHit = false;
+    ClosestHitQuery query(outputIntersection);
+    return TraceLeafNodes(nodes, parentObject, inputRay, query, AcceptAnyHit());
+}
+
+bool NaiveAcceleration::TraceAnyHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState* anyHit) const
+{
+    AnyHitQuery query(anyHit);
+    return TraceLeafNodes(nodes, parentObject, inputRay, query, AcceptAnyHit());
+}
+
+bool NaiveAcceleration::TraceAllHits(const SceneObject* parentObject, Ray* inputRay, HitCollector& collector) const
+{
+    AllHitsQuery query(collector);
+    return TraceLeafNodes(nodes, parentObject, inputRay, query, AcceptAnyHit());
+}
+
+bool NaiveAcceleration::TraceFilteredHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection, const HitFilter& filter) const
+{
+    FilteredHitQuery query(outputIntersection, filter);
+    return TraceLeafNodes(nodes, parentObject, inputRay, query, AcceptAnyHit());
+}
+
+uint64_t NaiveAcceleration::TracePacket(const SceneObject* parentObject, RayPacket& packet, uint64_t laneMask) const
+{
+    uint64_t hitMask = 0;
     for (size_t i = 0; i < nodes.size(); ++i) {
-        bool hit = nodes[i]->Trace(parentObject, inputRay, outputIntersection);
-        // early exit when we just want to know whether or not we hit.
-        if (hit && !outputIntersection) {
-            return true; 
-        }
-        hasHit |= hit;
-    }  
-    return hasHit;
+        hitMask |= nodes[i]->TracePacket(parentObject, packet, laneMask);
+    }
+    return hitMask;
 }
\ No newline at end of file
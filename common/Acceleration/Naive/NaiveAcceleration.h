@@ -9,5 +9,9 @@ public:
     // Only implemented for naive acceleration since it's trivial...
     void AddNode(std::shared_ptr<AccelerationNode> node);
 
-    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual bool TraceClosestHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState& outputIntersection) const override;
+    virtual bool TraceAnyHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* anyHit) const override;
+    virtual bool TraceAllHits(const class SceneObject* parentObject, class Ray* inputRay, class HitCollector& collector) const override;
+    virtual bool TraceFilteredHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState& outputIntersection, const class HitFilter& filter) const override;
+    virtual uint64_t TracePacket(const class SceneObject* parentObject, struct RayPacket& packet, uint64_t laneMask) const override;
 };
\ No newline at end of file
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Acceleration/AccelerationNode.h"
+#include "common/Acceleration/AccelerationStructure.h"
+#include "common/Intersection/IntersectionState.h"
+
+// Receives the hits of AccelerationStructure::TraceAllHits in no particular order. Return false to end the query early.
+class HitCollector
+{
+public:
+    virtual ~HitCollector() {}
+    virtual bool CollectHit(const IntersectionState& hit) = 0;
+};
+
+// Decides which hits AccelerationStructure::TraceFilteredHit may return, e.g. an alpha test against the hit's texture.
+class HitFilter
+{
+public:
+    virtual ~HitFilter() {}
+    virtual bool AcceptHit(const IntersectionState& hit) const = 0;
+};
+
+// Query policies for the traversal templates of the acceleration structures (BVHNode::Trace, VoxelGrid::Trace and
+// TraceLeafNodes). The traversal only decides which leaf nodes a ray reaches; the policy decides what a leaf hit means:
+//   GetCullingState - hit record that bounding boxes are culled against, nullptr if every hit up to the ray's max T counts.
+//   TraceLeaf       - tests one leaf node; accept(hit) lets the traversal reject hits (the grid rejects hits outside the
+//                     current voxel). Returns whether the query recorded a hit.
+//   IsFinished      - whether the traversal can stop.
+//   NeedsClosestHit - whether only the closest recorded hit matters, so that front to back traversals (the grid) can stop
+//                     at the first hit.
+// Every policy call is resolved at compile time, so each query compiles to its own loop. Queries that look past the
+// closest hit follow leaf nodes into the structures nested below them (AccelerationNode::GetNestedAcceleration); leaf
+// primitives still report only their closest hit.
+
+// Accepts every hit; used by traversals that have no reason to reject one.
+struct AcceptAnyHit
+{
+    bool operator()(const IntersectionState& hit) const
+    {
+        return true;
+    }
+};
+
+struct ClosestHitQuery
+{
+    explicit ClosestHitQuery(IntersectionState& output) :
+        closestHit(output)
+    {
+    }
+
+    IntersectionState* GetCullingState() const
+    {
+        return &closestHit;
+    }
+
+    bool TraceLeaf(const AccelerationNode& node, const SceneObject* parentObject, Ray* inputRay, const AcceptAnyHit&)
+    {
+        return node.Trace(parentObject, inputRay, &closestHit);
+    }
+
+    template<typename Accept>
+    bool TraceLeaf(const AccelerationNode& node, const SceneObject* parentObject, Ray* inputRay, const Accept& accept)
+    {
+        IntersectionState candidate;
+        candidate.TestAndCopyLimits(&closestHit);
+        if (!node.Trace(parentObject, inputRay, &candidate) || !accept(candidate)) {
+            return false;
+        }
+        closestHit = candidate;
+        return true;
+    }
+
+    bool IsFinished() const
+    {
+        return false;
+    }
+
+    bool NeedsClosestHit() const
+    {
+        return true;
+    }
+
+    IntersectionState& closestHit;
+};
+
+// Any hit up to the ray's max T. If given a hit record, the query also fills it in with the hit that ended it; that
+// hit is not necessarily the closest one.
+struct AnyHitQuery
+{
+    explicit AnyHitQuery(IntersectionState* output = nullptr) :
+        anyHit(output), foundHit(false)
+    {
+    }
+
+    IntersectionState* GetCullingState() const
+    {
+        return nullptr;
+    }
+
+    // Any hit before the ray's max T answers the query, so accept is never needed.
+    template<typename Accept>
+    bool TraceLeaf(const AccelerationNode& node, const SceneObject* parentObject, Ray* inputRay, const Accept&)
+    {
+        if (!anyHit) {
+            foundHit = node.Trace(parentObject, inputRay, nullptr);
+            return foundHit;
+        }
+
+        // Tracing the leaf with a hit record would look for its closest hit, so nested structures are traced as any
+        // hit queries of their own.
+        const SceneObject* nestedParent = parentObject;
+        if (const AccelerationStructure* nested = node.GetNestedAcceleration(nestedParent)) {
+            foundHit = nested->TraceAnyHit(nestedParent, inputRay, anyHit);
+            return foundHit;
+        }
+
+        IntersectionState hit;
+        foundHit = node.Trace(parentObject, inputRay, &hit);
+        if (foundHit) {
+            *anyHit = hit;
+        }
+        return foundHit;
+    }
+
+    bool IsFinished() const
+    {
+        return foundHit;
+    }
+
+    bool NeedsClosestHit() const
+    {
+        return false;
+    }
+
+    IntersectionState* anyHit;
+    bool foundHit;
+};
+
+struct AllHitsQuery
+{
+    explicit AllHitsQuery(HitCollector& inputCollector) :
+        collector(inputCollector), stopped(false)
+    {
+    }
+
+    IntersectionState* GetCullingState() const
+    {
+        return nullptr;
+    }
+
+    template<typename Accept>
+    bool TraceLeaf(const AccelerationNode& node, const SceneObject* parentObject, Ray* inputRay, const Accept& accept)
+    {
+        const SceneObject* nestedParent = parentObject;
+        if (const AccelerationStructure* nested = node.GetNestedAcceleration(nestedParent)) {
+            AcceptedHitCollector<Accept> nestedCollector(*this, accept);
+            return nested->TraceAllHits(nestedParent, inputRay, nestedCollector);
+        }
+
+        IntersectionState hit;
+        if (!node.Trace(parentObject, inputRay, &hit) || !accept(hit)) {
+            return false;
+        }
+        stopped = !collector.CollectHit(hit);
+        return true;
+    }
+
+    bool IsFinished() const
+    {
+        return stopped;
+    }
+
+    bool NeedsClosestHit() const
+    {
+        return false;
+    }
+
+    HitCollector& collector;
+    bool stopped;
+
+private:
+    template<typename Accept>
+    class AcceptedHitCollector : public HitCollector
+    {
+    public:
+        AcceptedHitCollector(AllHitsQuery& inputQuery, const Accept& inputAccept) :
+            query(inputQuery), accept(inputAccept)
+        {
+        }
+
+        virtual bool CollectHit(const IntersectionState& hit) override
+        {
+            if (accept(hit)) {
+                query.stopped = !query.collector.CollectHit(hit);
+            }
+            return !query.stopped;
+        }
+
+    private:
+        AllHitsQuery& query;
+        const Accept& accept;
+    };
+};
+
+// Closest hit that the filter accepts.
+struct FilteredHitQuery
+{
+    FilteredHitQuery(IntersectionState& output, const HitFilter& inputFilter) :
+        closestHit(output), filter(inputFilter)
+    {
+    }
+
+    IntersectionState* GetCullingState() const
+    {
+        return &closestHit;
+    }
+
+    template<typename Accept>
+    bool TraceLeaf(const AccelerationNode& node, const SceneObject* parentObject, Ray* inputRay, const Accept& accept)
+    {
+        const SceneObject* nestedParent = parentObject;
+        if (const AccelerationStructure* nested = node.GetNestedAcceleration(nestedParent)) {
+            const AcceptedHitFilter<Accept> nestedFilter(filter, accept);
+            return nested->TraceFilteredHit(nestedParent, inputRay, closestHit, nestedFilter);
+        }
+
+        IntersectionState candidate;
+        candidate.TestAndCopyLimits(&closestHit);
+        if (!node.Trace(parentObject, inputRay, &candidate) || !accept(candidate) || !filter.AcceptHit(candidate)) {
+            return false;
+        }
+        closestHit = candidate;
+        return true;
+    }
+
+    bool IsFinished() const
+    {
+        return false;
+    }
+
+    bool NeedsClosestHit() const
+    {
+        return true;
+    }
+
+    IntersectionState& closestHit;
+    const HitFilter& filter;
+
+private:
+    template<typename Accept>
+    class AcceptedHitFilter : public HitFilter
+    {
+    public:
+        AcceptedHitFilter(const HitFilter& inputFilter, const Accept& inputAccept) :
+            filter(inputFilter), accept(inputAccept)
+        {
+        }
+
+        virtual bool AcceptHit(const IntersectionState& hit) const override
+        {
+            return accept(hit) && filter.AcceptHit(hit);
+        }
+
+    private:
+        const HitFilter& filter;
+        const Accept& accept;
+    };
+};
+
+// Tests every node of a flat list; NaiveAcceleration and the voxels of the uniform grid.
+template<typename Query, typename Accept>
+bool TraceLeafNodes(const std::vector<std::shared_ptr<AccelerationNode>>& nodes, const SceneObject* parentObject, Ray* inputRay, Query& query, const Accept& accept)
+{
+    bool hasHit = false;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        hasHit |= query.TraceLeaf(*nodes[i], parentObject, inputRay, accept);
+        if (query.IsFinished()) {
+            break;
+        }
+    }
+    return hasHit;
+}
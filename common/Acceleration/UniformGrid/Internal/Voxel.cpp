@@ -1,10 +1,8 @@
 #include "common/Acceleration/UniformGrid/Internal/Voxel.h"
 #include "common/Acceleration/AccelerationNode.h"
-#include "common/Acceleration/Naive/NaiveAcceleration.h"
 
 Voxel::Voxel()
 {
-    nodeList = make_unique<NaiveAcceleration>();
 }
 
 Voxel::~Voxel()
@@ -13,10 +11,5 @@ Voxel::~Voxel()
 
 void Voxel::AddNode(std::shared_ptr<AccelerationNode> input)
 {
-    nodeList->AddNode(std::move(input));
-}
-
-bool Voxel::Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection)
-{
-    return nodeList->Trace(parentObject, inputRay, outputIntersection);
+    nodes.push_back(std::move(input));
 }
\ No newline at end of file
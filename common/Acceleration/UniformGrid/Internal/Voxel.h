@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/common.h"
+#include "common/Acceleration/TraceQuery.h"
 #include "common/Scene/Geometry/Simple/Box/Box.h"
 
 class Voxel : public std::enable_shared_from_this<Voxel>
@@ -9,7 +10,12 @@ public:
     Voxel();
     ~Voxel();
     void AddNode(std::shared_ptr<class AccelerationNode> input);
-    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection);
+
+    template<typename Query, typename Accept>
+    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, Query& query, const Accept& accept) const
+    {
+        return TraceLeafNodes(nodes, parentObject, inputRay, query, accept);
+    }
 private:
-    std::unique_ptr<class NaiveAcceleration> nodeList;
+    std::vector<std::shared_ptr<class AccelerationNode>> nodes;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "common/Acceleration/UniformGrid/Internal/VoxelGrid.h"
 #include "common/Acceleration/AccelerationNode.h"
 #include "common/Intersection/IntersectionState.h"
+#include "common/Scene/SceneObject.h"
 
 #define DEBUG_VOXEL_GRID 0
 
@@ -57,7 +58,8 @@ bool VoxelGrid::IsInsideGrid(const glm::ivec3& index) const
     return true;
 }
 
-bool VoxelGrid::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection)
+template<typename Query>
+bool VoxelGrid::Trace(const SceneObject* parentObject, Ray* inputRay, Query& query) const
 {
     glm::mat4 spaceTransform(1.f);
     if (parentObject) {
@@ -89,33 +91,37 @@ bool VoxelGrid::Trace(const SceneObject* parentObject, Ray* inputRay, Intersecti
         const float dt = tempState.intersectionT + SMALL_EPSILON;
         currentVoxelIndex = GetVoxelForPosition(rayPos + rayDir * dt);
     }
-       
+
 #if DEBUG_VOXEL_GRID
     std::cout << "Final Voxel Position: " << glm::to_string(currentVoxelIndex) << " for " << glm::to_string(rayPos) << " going " << glm::to_string(rayDir) << std::endl;
     std::cout << "Scene Bounding: " << glm::to_string(boundingBox.minVertex) << " " << glm::to_string(boundingBox.maxVertex) << std::endl;
     std::cout << "Voxel Size: " << glm::to_string(voxelSize) << std::endl;
 #endif
+    bool hasHit = false;
     while (IsInsideGrid(currentVoxelIndex)) {
 #if DEBUG_VOXEL_GRID
         std::cout << "Trace Voxel: " << glm::to_string(currentVoxelIndex) << std::endl;
 #endif
-        IntersectionState tempIntersection;
-        tempIntersection.TestAndCopyLimits(outputIntersection);
-        bool hitVoxel = grid[currentVoxelIndex[0]][currentVoxelIndex[1]][currentVoxelIndex[2]].Trace(parentObject, inputRay, &tempIntersection);
-            
-        // Need to verify that the hit position is within the voxel -- otherwise we're looking too far ahead.
-        const glm::vec3 hitPosition = rayPos + rayDir * tempIntersection.intersectionT;
+        // Need to verify that the hit position is within the voxel -- otherwise we're looking too far ahead, and nodes that
+        // span several voxels would report the same hit more than once.
+        const auto isInsideVoxel = [&](const IntersectionState& hit) {
+            const glm::vec3 hitPosition = rayPos + rayDir * hit.intersectionT;
 #if DEBUG_VOXEL_GRID
-        std::cout << "  -- hit position " << glm::to_string(hitPosition) << " " << glm::to_string(GetVoxelForPosition(hitPosition)) << std::endl;
+            std::cout << "  -- hit position " << glm::to_string(hitPosition) << " " << glm::to_string(GetVoxelForPosition(hitPosition)) << std::endl;
 #endif
-        if (hitVoxel && GetVoxelForPosition(hitPosition) == currentVoxelIndex)  {
-            if (outputIntersection) {
-                *outputIntersection = tempIntersection;
-            }
+            return GetVoxelForPosition(hitPosition) == currentVoxelIndex;
+        };
+        const Voxel* currentVoxel = FindVoxel(currentVoxelIndex);
+        if (currentVoxel && currentVoxel->Trace(parentObject, inputRay, query, isInsideVoxel)) {
+            hasHit = true;
+        }
+
+        // Voxels are visited front to back, so a hit inside this voxel is closer than anything a later voxel holds.
+        if (query.IsFinished() || (hasHit && query.NeedsClosestHit())) {
 #if DEBUG_VOXEL_GRID
             std::cout << " did done hit" << std::endl;
 #endif
-            return true;
+            return hasHit;
         }
 
         int minIndex = 0;
@@ -128,7 +134,24 @@ bool VoxelGrid::Trace(const SceneObject* parentObject, Ray* inputRay, Intersecti
         std::cout << " -- next voxel: " << glm::to_string(currentVoxelIndex) << " " << minIndex << " " << minTMax << std::endl;
 #endif
     }
-    return false;
+    return hasHit;
+}
+
+const Voxel* VoxelGrid::FindVoxel(const glm::ivec3& index) const
+{
+    const auto xSlice = grid.find(index.x);
+    if (xSlice == grid.end()) {
+        return nullptr;
+    }
+    const auto ySlice = xSlice->second.find(index.y);
+    if (ySlice == xSlice->second.end()) {
+        return nullptr;
+    }
+    const auto voxel = ySlice->second.find(index.z);
+    if (voxel == ySlice->second.end()) {
+        return nullptr;
+    }
+    return &voxel->second;
 }
 
 void VoxelGrid::FindClosestVoxelSide(int& dim, float& t, const glm::ivec3& currentVoxelIndex, const glm::ivec3& step, const glm::vec3& rayPos, const glm::vec3& rayDir) const
@@ -155,3 +178,8 @@ void VoxelGrid::FindClosestVoxelSide(int& dim, float& t, const glm::ivec3& curre
     t = minTMax;
     dim = minIndex;
 }
+
+template bool VoxelGrid::Trace<ClosestHitQuery>(const SceneObject*, Ray*, ClosestHitQuery&) const;
+template bool VoxelGrid::Trace<AnyHitQuery>(const SceneObject*, Ray*, AnyHitQuery&) const;
+template bool VoxelGrid::Trace<AllHitsQuery>(const SceneObject*, Ray*, AllHitsQuery&) const;
+template bool VoxelGrid::Trace<FilteredHitQuery>(const SceneObject*, Ray*, FilteredHitQuery&) const;
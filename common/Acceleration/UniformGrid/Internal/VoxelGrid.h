@@ -11,9 +11,13 @@ public:
     VoxelGrid(Box inputBox, const glm::ivec3& size, const glm::vec3& inputSize);
 
     void AddNodeToGrid(std::shared_ptr<class AccelerationNode> node);
-    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection);
+    // Instantiated for the query policies of TraceQuery.h.
+    template<typename Query>
+    bool Trace(const class SceneObject* parentObject, class Ray* inputRay, Query& query) const;
 private:
     bool IsInsideGrid(const glm::ivec3& index) const;
+    // Returns NULL for voxels that no node was added to. Tracing must not use grid[][][], which would insert empty voxels while other threads read the grid.
+    const Voxel* FindVoxel(const glm::ivec3& index) const;
     glm::ivec3 GetVoxelForPosition(const glm::vec3& position, bool clamp = true) const;
     void FindClosestVoxelSide(int& dim, float& t, const glm::ivec3& currentVoxelIndex, const glm::ivec3& step, const glm::vec3& rayPos, const glm::vec3& rayDir) const;
 
@@ -1,5 +1,6 @@
 #include "common/Acceleration/UniformGrid/UniformGridAcceleration.h"
 #include "common/Acceleration/UniformGrid/Internal/VoxelGrid.h"
+#include "common/Acceleration/TraceQuery.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
 
 UniformGridAcceleration::UniformGridAcceleration():
@@ -7,10 +8,32 @@ UniformGridAcceleration::UniformGridAcceleration():
 {
 }
 
-bool UniformGridAcceleration::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+bool UniformGridAcceleration::TraceClosestHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection) const
 {
     assert(voxelGrid);
-    return voxelGrid->Trace(parentObject, inputRay, outputIntersection);
+    ClosestHitQuery query(outputIntersection);
+    return voxelGrid->Trace(parentObject, inputRay, query);
+}
+
+bool UniformGridAcceleration::TraceAnyHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState* anyHit) const
+{
+    assert(voxelGrid);
+    AnyHitQuery query(anyHit);
+    return voxelGrid->Trace(parentObject, inputRay, query);
+}
+
+bool UniformGridAcceleration::TraceAllHits(const SceneObject* parentObject, Ray* inputRay, HitCollector& collector) const
+{
+    assert(voxelGrid);
+    AllHitsQuery query(collector);
+    return voxelGrid->Trace(parentObject, inputRay, query);
+}
+
+bool UniformGridAcceleration::TraceFilteredHit(const SceneObject* parentObject, Ray* inputRay, IntersectionState& outputIntersection, const HitFilter& filter) const
+{
+    assert(voxelGrid);
+    FilteredHitQuery query(outputIntersection, filter);
+    return voxelGrid->Trace(parentObject, inputRay, query);
 }
 
 void UniformGridAcceleration::InternalInitialization()
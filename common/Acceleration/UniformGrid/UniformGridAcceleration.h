@@ -7,7 +7,10 @@ class UniformGridAcceleration : public AccelerationStructure
 {
 public:
     UniformGridAcceleration();
-    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual bool TraceClosestHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState& outputIntersection) const override;
+    virtual bool TraceAnyHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* anyHit) const override;
+    virtual bool TraceAllHits(const class SceneObject* parentObject, class Ray* inputRay, class HitCollector& collector) const override;
+    virtual bool TraceFilteredHit(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState& outputIntersection, const class HitFilter& filter) const override;
 
     void SetSuggestedGridSize(glm::ivec3 input);
 private:
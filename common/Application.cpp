@@ -12,6 +12,55 @@ int Application::GetSamplesPerPixel() const
     return 16;
 }
 
+int Application::GetCameraPacketSize() const
+{
+    return 1;
+}
+
+bool Application::UseWavefrontEngine() const
+{
+    return false;
+}
+
+bool Application::UseReservoirDirectLighting() const
+{
+    return false;
+}
+
+bool Application::UseProgressiveRendering() const
+{
+    return false;
+}
+
+std::string Application::GetCheckpointFilename() const
+{
+    return GetOutputFilename() + ".checkpoint";
+}
+
+float Application::GetCheckpointInterval() const
+{
+    return 60.f;
+}
+
+float Application::GetRenderTimeBudget() const
+{
+    return 0.f;
+}
+
+float Application::GetAdaptiveSampleBudget() const
+{
+    return 0.f;
+}
+
+void Application::RegisterRenderKernels(RenderKernelRegistry& registry) const
+{
+}
+
+int Application::GetRenderKernelThreadCount() const
+{
+    return 1;
+}
+
 glm::vec2 Application::GetImageOutputResolution() const
 {
     return glm::vec2(1280.f, 720.f);
@@ -23,6 +23,38 @@ public:
     // Sampling Properties
     virtual int GetSamplesPerPixel() const;
 
+    // Width and height of the pixel blocks whose camera rays are traced together as one packet (at most 8).
+    // 1 traces every pixel on its own.
+    virtual int GetCameraPacketSize() const;
+
+    // Renders with the WavefrontEngine instead of tracing one sample at a time. Only supported with the BackwardRenderer.
+    virtual bool UseWavefrontEngine() const;
+
+    // Computes direct lighting with the ReservoirEngine (one shadow ray per pixel and pass, GetSamplesPerPixel passes).
+    // Takes precedence over UseWavefrontEngine.
+    virtual bool UseReservoirDirectLighting() const;
+
+    // Renders in passes of increasing sample counts with the ProgressiveEngine. The output image is rewritten after every pass
+    // and the render is checkpointed to GetCheckpointFilename(), from which it resumes when started again.
+    virtual bool UseProgressiveRendering() const;
+    virtual std::string GetCheckpointFilename() const;
+    virtual float GetCheckpointInterval() const;
+
+    // Seconds from the start of RayTracer::Run until the image has to be written. 0 disables the budget; otherwise the
+    // DeadlineEngine spends the time left after scene setup on the samples that reduce the error the most.
+    virtual float GetRenderTimeBudget() const;
+
+    // Average samples per pixel that the AdaptiveEngine spreads over the image, giving noisy pixels up to
+    // GetSamplesPerPixel samples and converged ones fewer. 0 samples every pixel GetSamplesPerPixel times.
+    virtual float GetAdaptiveSampleBudget() const;
+
+    // Called before rendering so that applications can add RenderKernel instantiations for their own samplers, cameras,
+    // renderers or acceleration structures. Combinations without a kernel are rendered through the virtual interfaces.
+    virtual void RegisterRenderKernels(class RenderKernelRegistry& registry) const;
+    // Threads that a render kernel spreads the rows of the image over; 0 uses every hardware thread. 1 by default, like the
+    // loop that renders combinations without a kernel, so that renderers which are not thread safe keep working.
+    virtual int GetRenderKernelThreadCount() const;
+
     // whether or not to continue sampling the scene from the camera.
     virtual bool NotifyNewPixelSample(glm::vec3 inputSampleColor, int sampleIndex) = 0;
 
@@ -2,16 +2,21 @@
 
 #include "common/common.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include <type_traits>
 
+// Fixed-size hit record. Everything is stored inline so that creating, copying and resetting a hit never touches the heap.
+// Reflection/refraction hits are traced by the renderer into records of their own while shading.
 struct IntersectionState
 {
+    static const int MAX_PRIMITIVE_VERTICES = 4;
+
     IntersectionState() :
-        reflectionIntersection(nullptr), remainingReflectionBounces(0), refractionIntersection(nullptr), remainingRefractionBounces(0), intersectionT(std::numeric_limits<float>::max()), hasIntersection(false), currentIOR(1.f)
+        remainingReflectionBounces(0), remainingRefractionBounces(0), throughput(1.f), intersectedPrimitive(nullptr), primitiveParent(nullptr), primitiveElementIndex(0), intersectionT(std::numeric_limits<float>::max()), hasIntersection(false), currentIOR(1.f), sampleKey(0), primitiveIntersectionWeights()
     {
     }
 
     IntersectionState(int reflectionBounces, int refractionBounces) :
-        reflectionIntersection(nullptr), remainingReflectionBounces(reflectionBounces), refractionIntersection(nullptr), remainingRefractionBounces(refractionBounces), intersectionT(std::numeric_limits<float>::max()), hasIntersection(false), currentIOR(1.f)
+        remainingReflectionBounces(reflectionBounces), remainingRefractionBounces(refractionBounces), throughput(1.f), intersectedPrimitive(nullptr), primitiveParent(nullptr), primitiveElementIndex(0), intersectionT(std::numeric_limits<float>::max()), hasIntersection(false), currentIOR(1.f), sampleKey(0), primitiveIntersectionWeights()
     {
     }
 
@@ -22,27 +27,35 @@ struct IntersectionState
         }
         remainingReflectionBounces = state->remainingReflectionBounces;
         remainingRefractionBounces = state->remainingRefractionBounces;
+        throughput = state->throughput;
         intersectionT = state->intersectionT;
         currentIOR = state->currentIOR;
+        sampleKey = state->sampleKey;
     }
 
-    std::shared_ptr<struct IntersectionState> reflectionIntersection;
     int remainingReflectionBounces;
-
-    std::shared_ptr<struct IntersectionState> refractionIntersection;
     int remainingRefractionBounces;
+    // Factor that this hit's color is scaled by before it reaches the pixel; used to cull reflection/refraction rays.
+    glm::vec3 throughput;
 
     const class PrimitiveBase* intersectedPrimitive;
     const class SceneObject* primitiveParent;
+    // Index of the face that was hit inside primitives that hold more than one face (e.g. StreamedChunk).
+    int primitiveElementIndex;
     Ray intersectionRay;
     float intersectionT;
     bool hasIntersection;
     float currentIOR;
+    // Key of the camera sample that the hit descends from (ColorSampler::ComputeSampleKey). Random decisions made at the
+    // hit hash it with a dimension id of their own, see Renderer::ComputeLightSampleKey.
+    uint32_t sampleKey;
 
-    // One for each vertex
-    std::vector<float> primitiveIntersectionWeights;
+    // One for each vertex of the intersected primitive. Analytic primitives store their object space hit position here instead.
+    std::array<float, MAX_PRIMITIVE_VERTICES> primitiveIntersectionWeights;
 
     // Utility Functions
     glm::vec3 ComputeNormal() const;
     glm::vec2 ComputeUV() const;
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable<IntersectionState>::value, "IntersectionState must stay a plain hit record.");
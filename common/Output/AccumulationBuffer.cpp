@@ -0,0 +1,135 @@
+#include "common/Output/AccumulationBuffer.h"
+#include "common/Output/ImageWriter.h"
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+// On-disk layout (native byte order): CheckpointHeader, glm::vec3 colorSums[width * height], int32_t sampleCounts[width * height].
+const uint32_t CHECKPOINT_VERSION = 2;
+const char CHECKPOINT_MAGIC[8] = { 'A', 'C', 'C', 'U', 'M', 'B', 'U', 'F' };
+
+struct CheckpointHeader
+{
+    char magic[8];
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    int32_t completedPasses;
+    int32_t completedSamplesPerPixel;
+    // ColorSampler::SetRenderSeed of the render that wrote the checkpoint.
+    uint32_t renderSeed;
+};
+}
+
+AccumulationBuffer::AccumulationBuffer(int inputWidth, int inputHeight) :
+    width(inputWidth), height(inputHeight), colorSums(inputWidth * inputHeight), sampleCounts(inputWidth * inputHeight, 0), renderSeed(0), completedPasses(0), completedSamplesPerPixel(0)
+{
+}
+
+void AccumulationBuffer::AddSamples(int x, int y, const glm::vec3& colorSum, int sampleCount)
+{
+    colorSums[y * width + x] += colorSum;
+    sampleCounts[y * width + x] += sampleCount;
+}
+
+glm::vec3 AccumulationBuffer::GetPixelColor(int x, int y) const
+{
+    const int sampleCount = sampleCounts[y * width + x];
+    return (sampleCount > 0) ? colorSums[y * width + x] / static_cast<float>(sampleCount) : glm::vec3();
+}
+
+int AccumulationBuffer::GetSampleCount(int x, int y) const
+{
+    return sampleCounts[y * width + x];
+}
+
+void AccumulationBuffer::CopyToImage(ImageWriter& imageWriter) const
+{
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            imageWriter.SetPixelColor(GetPixelColor(x, y), x, y);
+        }
+    }
+}
+
+void AccumulationBuffer::CompletePass(int samplesPerPixel)
+{
+    ++completedPasses;
+    completedSamplesPerPixel += samplesPerPixel;
+}
+
+bool AccumulationBuffer::SaveCheckpoint(const std::string& filename) const
+{
+    const std::string temporaryFilename = filename + ".tmp";
+    {
+        std::ofstream output(temporaryFilename, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            std::cerr << "ERROR: Failed to open " << temporaryFilename << " for writing." << std::endl;
+            return false;
+        }
+
+        CheckpointHeader header = {};
+        std::copy(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC), header.magic);
+        header.version = CHECKPOINT_VERSION;
+        header.width = width;
+        header.height = height;
+        header.completedPasses = completedPasses;
+        header.completedSamplesPerPixel = completedSamplesPerPixel;
+        header.renderSeed = renderSeed;
+
+        static_assert(sizeof(int) == sizeof(int32_t), "Sample counts are stored as 32 bit integers.");
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(colorSums.data()), colorSums.size() * sizeof(glm::vec3));
+        output.write(reinterpret_cast<const char*>(sampleCounts.data()), sampleCounts.size() * sizeof(int));
+        if (!output.good()) {
+            std::cerr << "ERROR: Failed to write the checkpoint " << temporaryFilename << "." << std::endl;
+            return false;
+        }
+    }
+
+    // rename does not replace existing files on every platform.
+    if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+        std::remove(filename.c_str());
+        if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+            std::cerr << "ERROR: Failed to move the checkpoint to " << filename << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AccumulationBuffer::LoadCheckpoint(const std::string& filename)
+{
+    std::ifstream input(filename, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+
+    CheckpointHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!input.good() || !std::equal(CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC), header.magic) || header.version != CHECKPOINT_VERSION) {
+        std::cerr << "WARNING: " << filename << " is not a checkpoint this version can read." << std::endl;
+        return false;
+    }
+    if (header.width != width || header.height != height) {
+        std::cerr << "WARNING: " << filename << " was written for a " << header.width << "x" << header.height << " image." << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> loadedColorSums(colorSums.size());
+    std::vector<int> loadedSampleCounts(sampleCounts.size());
+    input.read(reinterpret_cast<char*>(loadedColorSums.data()), loadedColorSums.size() * sizeof(glm::vec3));
+    input.read(reinterpret_cast<char*>(loadedSampleCounts.data()), loadedSampleCounts.size() * sizeof(int));
+    if (!input.good()) {
+        std::cerr << "WARNING: " << filename << " is truncated." << std::endl;
+        return false;
+    }
+
+    colorSums.swap(loadedColorSums);
+    sampleCounts.swap(loadedSampleCounts);
+    completedPasses = header.completedPasses;
+    completedSamplesPerPixel = header.completedSamplesPerPixel;
+    renderSeed = header.renderSeed;
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common/common.h"
+
+// Running per-pixel sums of sample colors for progressive rendering. The buffer can be saved to and restored from a checkpoint
+// file together with the state that decides which random numbers the next samples use, so an interrupted render can be resumed
+// and keeps adding new samples instead of repeating old ones.
+class AccumulationBuffer
+{
+public:
+    AccumulationBuffer(int inputWidth, int inputHeight);
+
+    void AddSamples(int x, int y, const glm::vec3& colorSum, int sampleCount);
+    glm::vec3 GetPixelColor(int x, int y) const;
+    int GetSampleCount(int x, int y) const;
+    void CopyToImage(class ImageWriter& imageWriter) const;
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    // Seed of the ColorSampler that renders into the buffer. New samples continue each pixel's sample sequence from its sample
+    // count, so the pass a sample was taken in does not change its random numbers.
+    uint32_t GetRenderSeed() const { return renderSeed; }
+    void SetRenderSeed(uint32_t input) { renderSeed = input; }
+    int GetCompletedPasses() const { return completedPasses; }
+    // Samples per pixel that the completed passes asked for (adaptive samplers may have taken fewer).
+    int GetCompletedSamplesPerPixel() const { return completedSamplesPerPixel; }
+    void CompletePass(int samplesPerPixel);
+
+    // The checkpoint is written to a temporary file first and then moved over the old one, so a render that is killed while
+    // saving still leaves the previous checkpoint behind.
+    bool SaveCheckpoint(const std::string& filename) const;
+    // Fails without touching the buffer if the file does not exist or was written for a different resolution.
+    bool LoadCheckpoint(const std::string& filename);
+
+private:
+    int width;
+    int height;
+    std::vector<glm::vec3> colorSums;
+    std::vector<int> sampleCounts;
+
+    uint32_t renderSeed;
+    int completedPasses;
+    int completedSamplesPerPixel;
+};
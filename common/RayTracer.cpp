@@ -2,13 +2,33 @@
 #include "common/Application.h"
 #include "common/Scene/Scene.h"
 #include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Camera/CameraRayBatch.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Intersection/IntersectionState.h"
 #include "common/Sampling/ColorSampler.h"
 #include "common/Output/ImageWriter.h"
+#include "common/Output/AccumulationBuffer.h"
 #include "common/Rendering/Renderer.h"
+#include "common/Rendering/Renderer/Backward/BackwardRenderer.h"
+#include "common/Rendering/Wavefront/WavefrontEngine.h"
+#include "common/Rendering/Reservoir/ReservoirEngine.h"
+#include "common/Rendering/Progressive/ProgressiveEngine.h"
+#include "common/Rendering/Deadline/DeadlineEngine.h"
+#include "common/Rendering/Adaptive/AdaptiveEngine.h"
+#include "common/Rendering/Kernel/RenderKernelRegistry.h"
 
 #include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
+
+namespace
+{
+// Packets cover packetSize x packetSize pixels and must fit into a single RayPacket.
+const int MAX_CAMERA_PACKET_SIZE = 8;
+
+// Share of the render time budget that is kept for writing the image.
+const float DEADLINE_OUTPUT_RESERVE = 0.02f;
+}
+
 RayTracer::RayTracer(std::unique_ptr<class Application> app):
     storedApplication(std::move(app))
 {
@@ -16,6 +36,8 @@ RayTracer::RayTracer(std::unique_ptr<class Application> app):
 
 void RayTracer::Run()
 {
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
     // Scene Setup -- Generate the camera and scene.
     std::shared_ptr<Camera> currentCamera = storedApplication->CreateCamera();
     std::shared_ptr<Scene> currentScene = storedApplication->CreateScene();
@@ -40,30 +62,95 @@ void RayTracer::Run()
     const int maxSamplesPerPixel = storedApplication->GetSamplesPerPixel();
     assert(maxSamplesPerPixel >= 1);
 
-    for (int r = 0; r < static_cast<int>(currentResolution.y); ++r) {
-        for (int c = 0; c < static_cast<int>(currentResolution.x); ++c) {
-            imageWriter.SetPixelColor(currentSampler->ComputeSamplesAndColor(maxSamplesPerPixel, 2, [&](glm::vec3 inputSample) {
-                const glm::vec3 minRange(-0.5f, -0.5f, 0.f);
-                const glm::vec3 maxRange(0.5f, 0.5f, 0.f);
-                const glm::vec3 sampleOffset = (maxSamplesPerPixel == 1) ? glm::vec3(0.f, 0.f, 0.f) : minRange + (maxRange - minRange) * inputSample;
+    bool useWavefront = storedApplication->UseWavefrontEngine();
+    if (useWavefront && !std::dynamic_pointer_cast<BackwardRenderer>(currentRenderer)) {
+        std::cerr << "WARNING: The wavefront engine only supports the backward renderer. Tracing samples one at a time instead." << std::endl;
+        useWavefront = false;
+    }
+
+    const int packetSize = std::min(storedApplication->GetCameraPacketSize(), MAX_CAMERA_PACKET_SIZE);
+    RenderKernelRegistry kernelRegistry;
+    storedApplication->RegisterRenderKernels(kernelRegistry);
+    const RenderKernelFunction renderKernel = kernelRegistry.FindKernel(*currentSampler.get(), *currentCamera.get(), *currentRenderer.get(), *currentScene->GetAccelerationStructure());
+    if (storedApplication->UseReservoirDirectLighting()) {
+        ReservoirEngine reservoirEngine(currentScene, currentCamera, currentRenderer);
+        reservoirEngine.SetMaxBounces(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+        reservoirEngine.SetPassesPerFrame(maxSamplesPerPixel);
+        reservoirEngine.Render(imageWriter, glm::ivec2(currentResolution));
+    } else if (storedApplication->GetRenderTimeBudget() > 0.f) {
+        DeadlineEngine deadlineEngine(currentScene, currentCamera, currentSampler, currentRenderer);
+        deadlineEngine.SetMaxBounces(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+        deadlineEngine.SetMaximumSamplesPerPixel(maxSamplesPerPixel);
 
-                glm::vec2 normalizedCoordinates(static_cast<float>(c) + sampleOffset.x, static_cast<float>(r) + sampleOffset.y);
-                normalizedCoordinates /= currentResolution;
+        // Leave some time for post-processing and saving the image.
+        const std::chrono::duration<float> budget(storedApplication->GetRenderTimeBudget() * (1.f - DEADLINE_OUTPUT_RESERVE));
+        deadlineEngine.Render(imageWriter, glm::ivec2(currentResolution), startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget));
+    } else if (storedApplication->GetAdaptiveSampleBudget() > 0.f) {
+        AdaptiveEngine adaptiveEngine(currentScene, currentCamera, currentSampler, currentRenderer);
+        adaptiveEngine.SetMaxBounces(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+        adaptiveEngine.SetSampleBudget(storedApplication->GetAdaptiveSampleBudget());
+        adaptiveEngine.SetMaximumSamplesPerPixel(maxSamplesPerPixel);
+        adaptiveEngine.Render(imageWriter, glm::ivec2(currentResolution));
+    } else if (storedApplication->UseProgressiveRendering()) {
+        ProgressiveEngine progressiveEngine(currentScene, currentCamera, currentSampler, currentRenderer);
+        progressiveEngine.SetMaxBounces(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+        progressiveEngine.SetTargetSamplesPerPixel(maxSamplesPerPixel);
+        progressiveEngine.SetCheckpoint(storedApplication->GetCheckpointFilename(), storedApplication->GetCheckpointInterval());
+        progressiveEngine.SetPassCallback([&](const AccumulationBuffer& buffer) {
+            ImageWriter previewWriter(storedApplication->GetOutputFilename(), buffer.GetWidth(), buffer.GetHeight());
+            buffer.CopyToImage(previewWriter);
+            storedApplication->PerformImagePostprocessing(previewWriter);
+            previewWriter.CopyHDRToBitmap();
+            previewWriter.SaveImage();
+        });
 
-                // Construct ray, send it out into the scene and see what we hit.
-                std::shared_ptr<Ray> cameraRay = currentCamera->GenerateRayForNormalizedCoordinates(normalizedCoordinates);
-                assert(cameraRay);
+        AccumulationBuffer accumulationBuffer(static_cast<int>(currentResolution.x), static_cast<int>(currentResolution.y));
+        progressiveEngine.Render(accumulationBuffer);
+        accumulationBuffer.CopyToImage(imageWriter);
+    } else if (useWavefront) {
+        WavefrontEngine wavefrontEngine(currentScene, currentCamera, currentSampler, currentRenderer);
+        wavefrontEngine.SetMaxBounces(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+        wavefrontEngine.SetSamplesPerPixel(maxSamplesPerPixel);
+        wavefrontEngine.Render(imageWriter, glm::ivec2(currentResolution));
+    } else if (packetSize > 1) {
+        TraceCameraPackets(*currentCamera.get(), *currentScene.get(), *currentSampler.get(), *currentRenderer.get(), imageWriter, packetSize);
+    } else if (renderKernel) {
+        RenderKernelParameters parameters;
+        parameters.scene = currentScene.get();
+        parameters.sampler = currentSampler.get();
+        parameters.camera = currentCamera.get();
+        parameters.renderer = currentRenderer.get();
+        parameters.imageWriter = &imageWriter;
+        parameters.resolution = glm::ivec2(currentResolution);
+        parameters.samplesPerPixel = maxSamplesPerPixel;
+        parameters.maxReflectionBounces = storedApplication->GetMaxReflectionBounces();
+        parameters.maxRefractionBounces = storedApplication->GetMaxRefractionBounces();
+        parameters.threadCount = storedApplication->GetRenderKernelThreadCount();
+        renderKernel(parameters);
+    } else {
+        for (int r = 0; r < static_cast<int>(currentResolution.y); ++r) {
+            for (int c = 0; c < static_cast<int>(currentResolution.x); ++c) {
+                // ComputeSamplesAndColor asks for the samples of the pixel in order, starting with the first.
+                const uint32_t pixelSeed = currentSampler->ComputePixelSeed(glm::ivec2(c, r));
+                int sampleIndex = 0;
+                imageWriter.SetPixelColor(currentSampler->ComputeSamplesAndColor(maxSamplesPerPixel, 2, glm::ivec2(c, r), [&](glm::vec3 inputSample) {
+                    const glm::vec2 normalizedCoordinates = Camera::ComputeNormalizedSampleCoordinates(c, r, inputSample, maxSamplesPerPixel, currentResolution);
 
-                IntersectionState rayIntersection(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
-                bool didHitScene = currentScene->Trace(cameraRay.get(), &rayIntersection);
+                    // Construct ray, send it out into the scene and see what we hit.
+                    Ray cameraRay = currentCamera->GenerateRay(normalizedCoordinates);
 
-                // Use the intersection data to compute the BRDF response.
-                glm::vec3 sampleColor;
-                if (didHitScene) {
-                    sampleColor = currentRenderer->ComputeSampleColor(rayIntersection, *cameraRay.get());
-                }
-                return sampleColor;
-            }), c, r);
+                    IntersectionState rayIntersection(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+                    rayIntersection.sampleKey = ColorSampler::ComputeSampleKey(pixelSeed, sampleIndex++);
+                    bool didHitScene = currentScene->Trace(&cameraRay, &rayIntersection);
+
+                    // Use the intersection data to compute the BRDF response.
+                    glm::vec3 sampleColor;
+                    if (didHitScene) {
+                        sampleColor = currentRenderer->ComputeSampleColor(rayIntersection, cameraRay);
+                    }
+                    return sampleColor;
+                }), c, r);
+            }
         }
     }
 
@@ -75,4 +162,67 @@ void RayTracer::Run()
 
     // Save image.
     imageWriter.SaveImage();
+}
+
+void RayTracer::TraceCameraPackets(const Camera& camera, const Scene& scene, const ColorSampler& sampler, const Renderer& renderer, ImageWriter& imageWriter, int packetSize) const
+{
+    const glm::vec2 currentResolution = storedApplication->GetImageOutputResolution();
+    const int width = static_cast<int>(currentResolution.x);
+    const int height = static_cast<int>(currentResolution.y);
+    const int maxSamplesPerPixel = storedApplication->GetSamplesPerPixel();
+
+    std::vector<std::unique_ptr<SamplerState>> pixelStates(packetSize * packetSize);
+    std::array<Ray, RayPacket::MAX_RAYS> cameraRays;
+    std::array<IntersectionState, RayPacket::MAX_RAYS> rayIntersections;
+    std::array<int, RayPacket::MAX_RAYS> lanePixels;
+    std::array<glm::vec2, RayPacket::MAX_RAYS> laneCoordinates;
+    std::array<glm::vec3, RayPacket::MAX_RAYS> laneColors;
+    CameraRayBatch cameraRayBatch;
+
+    for (int tileR = 0; tileR < height; tileR += packetSize) {
+        for (int tileC = 0; tileC < width; tileC += packetSize) {
+            const int tileHeight = std::min(packetSize, height - tileR);
+            const int tileWidth = std::min(packetSize, width - tileC);
+
+            // Every pixel of the tile keeps its own sampler state; a pixel leaves the packet once its sampler is done with it.
+            uint64_t pendingPixels = 0;
+            for (int i = 0; i < tileHeight * tileWidth; ++i) {
+                const glm::ivec2 pixel(tileC + i % tileWidth, tileR + i / tileWidth);
+                pixelStates[i] = sampler.CreateSampler(sampler.ComputePixelSeed(pixel), maxSamplesPerPixel, 2);
+                pixelStates[i]->pixel = pixel;
+                pendingPixels |= uint64_t(1) << i;
+            }
+
+            while (pendingPixels) {
+                RayPacket packet;
+                for (uint64_t remaining = pendingPixels; remaining;) {
+                    const int pixel = RayPacket::PopLane(remaining);
+                    const glm::vec3 sampleCoordinates = sampler.ComputeSampleCoordinate(*pixelStates[pixel].get());
+                    const int lane = packet.totalRays;
+                    laneCoordinates[lane] = Camera::ComputeNormalizedSampleCoordinates(tileC + pixel % tileWidth, tileR + pixel / tileWidth, sampleCoordinates, maxSamplesPerPixel, currentResolution);
+                    rayIntersections[lane] = IntersectionState(storedApplication->GetMaxReflectionBounces(), storedApplication->GetMaxRefractionBounces());
+                    rayIntersections[lane].sampleKey = ColorSampler::ComputeSampleKey(pixelStates[pixel]->seed, pixelStates[pixel]->samplesComputed);
+                    lanePixels[lane] = pixel;
+                    packet.AddRay(&cameraRays[lane], &rayIntersections[lane]);
+                }
+
+                camera.GenerateRays(laneCoordinates.data(), packet.totalRays, cameraRayBatch);
+                for (int lane = 0; lane < packet.totalRays; ++lane) {
+                    cameraRays[lane] = cameraRayBatch.GetRay(lane);
+                }
+
+                const uint64_t hitMask = scene.TracePacket(packet);
+                renderer.ComputeSampleColors(rayIntersections.data(), cameraRays.data(), hitMask, packet.totalRays, laneColors.data());
+                for (int lane = 0; lane < packet.totalRays; ++lane) {
+                    if (!sampler.RecordColorSample(*pixelStates[lanePixels[lane]].get(), laneColors[lane])) {
+                        pendingPixels &= ~(uint64_t(1) << lanePixels[lane]);
+                    }
+                }
+            }
+
+            for (int i = 0; i < tileHeight * tileWidth; ++i) {
+                imageWriter.SetPixelColor(sampler.ComputeFinalColor(*pixelStates[i].get()), tileC + i % tileWidth, tileR + i / tileWidth);
+            }
+        }
+    }
 }
\ No newline at end of file
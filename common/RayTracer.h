@@ -8,5 +8,7 @@ public:
 
     void Run();
 private:
+    void TraceCameraPackets(const class Camera& camera, const class Scene& scene, const class ColorSampler& sampler, const class Renderer& renderer, class ImageWriter& imageWriter, int packetSize) const;
+
     std::unique_ptr<class Application> storedApplication;
 };
\ No newline at end of file
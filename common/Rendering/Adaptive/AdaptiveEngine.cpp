@@ -0,0 +1,177 @@
+#include "common/Rendering/Adaptive/AdaptiveEngine.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Rendering/PixelSampling/PixelSampleTracer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Output/ImageWriter.h"
+#include "common/Utility/Threading/ParallelFor.h"
+#include "common/Utility/Random/RandomStream.h"
+#include "common/Utility/Color/Luminance.h"
+
+namespace
+{
+// Rows per ParallelFor range.
+const size_t ROW_GRAIN_SIZE = 1;
+// Added to the neighborhood luminance before dividing by it, so that noise in dark regions does not take the whole budget.
+const double CONTRAST_OFFSET = 0.01;
+}
+
+AdaptiveEngine::AdaptiveEngine(std::shared_ptr<Scene> inputScene, std::shared_ptr<Camera> inputCamera, std::shared_ptr<ColorSampler> inputSampler, std::shared_ptr<Renderer> inputRenderer):
+    scene(std::move(inputScene)), camera(std::move(inputCamera)), sampler(std::move(inputSampler)), renderer(std::move(inputRenderer)), maxReflectionBounces(0), maxRefractionBounces(0),
+    sampleBudget(16.f), pilotSamples(4), passes(4), maximumSamplesPerPixel(256), threadCount(0)
+{
+}
+
+void AdaptiveEngine::SetMaxBounces(int reflectionBounces, int refractionBounces)
+{
+    maxReflectionBounces = reflectionBounces;
+    maxRefractionBounces = refractionBounces;
+}
+
+void AdaptiveEngine::SetSampleBudget(float averageSamplesPerPixel)
+{
+    sampleBudget = averageSamplesPerPixel;
+}
+
+void AdaptiveEngine::SetPilotSamples(int input)
+{
+    pilotSamples = std::max(input, 1);
+}
+
+void AdaptiveEngine::SetPasses(int input)
+{
+    passes = std::max(input, 1);
+}
+
+void AdaptiveEngine::SetMaximumSamplesPerPixel(int input)
+{
+    maximumSamplesPerPixel = std::max(input, 1);
+}
+
+void AdaptiveEngine::SetThreadCount(int input)
+{
+    threadCount = input;
+}
+
+void AdaptiveEngine::Render(ImageWriter& imageWriter, glm::ivec2 resolution) const
+{
+    assert(scene && camera && sampler && renderer);
+    const size_t totalPixels = static_cast<size_t>(resolution.x * resolution.y);
+    std::vector<PixelStatistics> pixels(totalPixels, PixelStatistics{ glm::vec3(), 0.0, 0.0, 0 });
+
+    const int firstPassSamples = std::min(pilotSamples, maximumSamplesPerPixel);
+    std::vector<int> pixelSamples(totalPixels, firstPassSamples);
+    RenderPixels(pixelSamples, resolution, pixels);
+
+    long long remainingSamples = static_cast<long long>(sampleBudget * totalPixels) - static_cast<long long>(firstPassSamples) * static_cast<long long>(totalPixels);
+    std::vector<double> errors;
+    for (int pass = 0; pass < passes && remainingSamples > 0; ++pass) {
+        ComputeErrorMap(pixels, resolution, errors);
+        const long long allocatedSamples = AllocateSamples(errors, pixels, remainingSamples / (passes - pass), pass, pixelSamples);
+        if (allocatedSamples == 0) {
+            break;
+        }
+        RenderPixels(pixelSamples, resolution, pixels);
+        remainingSamples -= allocatedSamples;
+    }
+
+    for (size_t i = 0; i < totalPixels; ++i) {
+        const PixelStatistics& pixel = pixels[i];
+        imageWriter.SetPixelColor((pixel.sampleCount > 0) ? pixel.colorSum / static_cast<float>(pixel.sampleCount) : glm::vec3(), static_cast<int>(i % resolution.x), static_cast<int>(i / resolution.x));
+    }
+}
+
+void AdaptiveEngine::RenderPixels(const std::vector<int>& pixelSamples, glm::ivec2 resolution, std::vector<PixelStatistics>& pixels) const
+{
+    const PixelSampleTracer tracer(*scene, *camera, *sampler, *renderer, maxReflectionBounces, maxRefractionBounces, resolution);
+    ParallelFor(static_cast<size_t>(resolution.y), ROW_GRAIN_SIZE, [&](size_t beginRow, size_t endRow) {
+        for (int r = static_cast<int>(beginRow); r < static_cast<int>(endRow); ++r) {
+            for (int c = 0; c < resolution.x; ++c) {
+                const int pixelIndex = r * resolution.x + c;
+                if (pixelSamples[pixelIndex] <= 0) {
+                    continue;
+                }
+
+                // Continue the sample sequence of the pixel so that stratifying samplers stratify over all passes.
+                PixelStatistics& pixel = pixels[pixelIndex];
+                tracer.TraceSamples(glm::ivec2(c, r), sampler->ComputePixelSeed(glm::ivec2(c, r)), maximumSamplesPerPixel, pixel.sampleCount, pixelSamples[pixelIndex], [&pixel](const glm::vec3& sampleColor) {
+                    pixel.colorSum += sampleColor;
+                    ++pixel.sampleCount;
+                    const double luminance = ComputeLuminance(sampleColor);
+                    const double deviation = luminance - pixel.luminanceMean;
+                    pixel.luminanceMean += deviation / pixel.sampleCount;
+                    pixel.luminanceSquaredDeviations += deviation * (luminance - pixel.luminanceMean);
+                });
+            }
+        }
+    }, threadCount);
+}
+
+void AdaptiveEngine::ComputeErrorMap(const std::vector<PixelStatistics>& pixels, glm::ivec2 resolution, std::vector<double>& errors) const
+{
+    std::vector<double> pixelErrors(pixels.size());
+    for (int r = 0; r < resolution.y; ++r) {
+        for (int c = 0; c < resolution.x; ++c) {
+            const PixelStatistics& pixel = pixels[r * resolution.x + c];
+            if (pixel.sampleCount < 2) {
+                pixelErrors[r * resolution.x + c] = 0.0;
+                continue;
+            }
+
+            double neighborhoodLuminance = 0.0;
+            int neighborhoodPixels = 0;
+            for (int y = std::max(r - 1, 0); y <= std::min(r + 1, resolution.y - 1); ++y) {
+                for (int x = std::max(c - 1, 0); x <= std::min(c + 1, resolution.x - 1); ++x) {
+                    neighborhoodLuminance += pixels[y * resolution.x + x].luminanceMean;
+                    ++neighborhoodPixels;
+                }
+            }
+            neighborhoodLuminance = std::max(neighborhoodLuminance / neighborhoodPixels, 0.0) + CONTRAST_OFFSET;
+
+            const double meanVariance = pixel.luminanceSquaredDeviations / (pixel.sampleCount - 1) / pixel.sampleCount;
+            pixelErrors[r * resolution.x + c] = meanVariance / (neighborhoodLuminance * neighborhoodLuminance);
+        }
+    }
+
+    errors.assign(pixels.size(), 0.0);
+    for (int r = 0; r < resolution.y; ++r) {
+        for (int c = 0; c < resolution.x; ++c) {
+            // Pixels that cannot take more samples do not pass their error on.
+            if (pixels[r * resolution.x + c].sampleCount >= maximumSamplesPerPixel) {
+                continue;
+            }
+            double error = 0.0;
+            for (int y = std::max(r - 1, 0); y <= std::min(r + 1, resolution.y - 1); ++y) {
+                for (int x = std::max(c - 1, 0); x <= std::min(c + 1, resolution.x - 1); ++x) {
+                    error = std::max(error, pixelErrors[y * resolution.x + x]);
+                }
+            }
+            errors[r * resolution.x + c] = error;
+        }
+    }
+}
+
+long long AdaptiveEngine::AllocateSamples(const std::vector<double>& errors, const std::vector<PixelStatistics>& pixels, long long passSamples, int pass, std::vector<int>& pixelSamples) const
+{
+    double totalError = 0.0;
+    for (size_t i = 0; i < errors.size(); ++i) {
+        totalError += errors[i];
+    }
+    pixelSamples.assign(errors.size(), 0);
+    if (totalError <= 0.0) {
+        return 0;
+    }
+
+    // Fractional shares are rounded stochastically so that pixels with less than one sample's worth of error still get
+    // samples on average; the fixed seed keeps the allocation reproducible.
+    RandomStream random(static_cast<uint32_t>(pass));
+    long long allocatedSamples = 0;
+    for (size_t i = 0; i < errors.size(); ++i) {
+        const double share = static_cast<double>(passSamples) * errors[i] / totalError;
+        const int samples = std::min(static_cast<int>(share + random.Next()), maximumSamplesPerPixel - pixels[i].sampleCount);
+        pixelSamples[i] = std::max(samples, 0);
+        allocatedSamples += pixelSamples[i];
+    }
+    return allocatedSamples;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common/common.h"
+
+// Spreads a fixed number of samples over the whole image instead of giving every pixel the same count. A pilot pass
+// renders a few samples in every pixel; each following pass builds an error map and hands that pass's share of the
+// remaining samples to the pixels in proportion to their error:
+//   - the error of a pixel is the variance of its mean luminance (per-sample variance / samples), divided by the
+//     squared mean luminance of its 3x3 neighborhood, since noise is harder to see on bright surroundings;
+//   - the map is dilated by one pixel so that the neighbors of a noisy pixel, which the pilot pass may have missed
+//     by chance (e.g. on a thin edge), get samples too.
+// Flat, converged regions stop receiving samples early and noisy edges and soft shadows get up to
+// SetMaximumSamplesPerPixel.
+class AdaptiveEngine
+{
+public:
+    AdaptiveEngine(std::shared_ptr<class Scene> inputScene, std::shared_ptr<class Camera> inputCamera, std::shared_ptr<class ColorSampler> inputSampler, std::shared_ptr<class Renderer> inputRenderer);
+
+    void SetMaxBounces(int reflectionBounces, int refractionBounces);
+    // Average samples per pixel over the whole image, including the pilot pass.
+    void SetSampleBudget(float averageSamplesPerPixel);
+    // Needs to be at least 2 for the pilot pass to see any variance.
+    void SetPilotSamples(int input);
+    // Passes after the pilot pass; more passes correct the error estimates more often.
+    void SetPasses(int input);
+    void SetMaximumSamplesPerPixel(int input);
+    // 0 uses every hardware thread.
+    void SetThreadCount(int input);
+
+    // The scene must be finalized.
+    void Render(class ImageWriter& imageWriter, glm::ivec2 resolution) const;
+
+private:
+    struct PixelStatistics
+    {
+        glm::vec3 colorSum;
+        // Running mean and sum of squared deviations (Welford) of the sample luminances.
+        double luminanceMean;
+        double luminanceSquaredDeviations;
+        int sampleCount;
+    };
+
+    void RenderPixels(const std::vector<int>& pixelSamples, glm::ivec2 resolution, std::vector<PixelStatistics>& pixels) const;
+    void ComputeErrorMap(const std::vector<PixelStatistics>& pixels, glm::ivec2 resolution, std::vector<double>& errors) const;
+    // Distributes passSamples over the pixels in proportion to their error; returns the number of samples handed out.
+    long long AllocateSamples(const std::vector<double>& errors, const std::vector<PixelStatistics>& pixels, long long passSamples, int pass, std::vector<int>& pixelSamples) const;
+
+    std::shared_ptr<class Scene> scene;
+    std::shared_ptr<class Camera> camera;
+    std::shared_ptr<class ColorSampler> sampler;
+    std::shared_ptr<class Renderer> renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    float sampleBudget;
+    int pilotSamples;
+    int passes;
+    int maximumSamplesPerPixel;
+    int threadCount;
+};
@@ -0,0 +1,229 @@
+#include "common/Rendering/Deadline/DeadlineEngine.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Rendering/PixelSampling/PixelSampleTracer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Output/ImageWriter.h"
+#include "common/Utility/Threading/ParallelFor.h"
+#include "common/Utility/Color/Luminance.h"
+
+namespace
+{
+// Share of the remaining time that a round plans to use; the rest is left for rounds with better estimates.
+const double ROUND_TIME_FRACTION = 0.5;
+// Rounds shorter than this use up all of the remaining time at once.
+const double MINIMUM_ROUND_SECONDS = 0.05;
+// Tiles in which the pilot pass happened to see no noise still get a little of the budget.
+const double MINIMUM_VARIANCE_FRACTION = 0.01;
+
+double SecondsUntil(std::chrono::steady_clock::time_point deadline)
+{
+    return std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+}
+}
+
+DeadlineEngine::DeadlineEngine(std::shared_ptr<Scene> inputScene, std::shared_ptr<Camera> inputCamera, std::shared_ptr<ColorSampler> inputSampler, std::shared_ptr<Renderer> inputRenderer):
+    scene(std::move(inputScene)), camera(std::move(inputCamera)), sampler(std::move(inputSampler)), renderer(std::move(inputRenderer)), maxReflectionBounces(0), maxRefractionBounces(0),
+    tileSize(16), pilotSamples(2), maximumSamplesPerPixel(1024), threadCount(0)
+{
+}
+
+void DeadlineEngine::SetMaxBounces(int reflectionBounces, int refractionBounces)
+{
+    maxReflectionBounces = reflectionBounces;
+    maxRefractionBounces = refractionBounces;
+}
+
+void DeadlineEngine::SetTileSize(int input)
+{
+    tileSize = std::max(input, 1);
+}
+
+void DeadlineEngine::SetPilotSamples(int input)
+{
+    pilotSamples = std::max(input, 1);
+}
+
+void DeadlineEngine::SetMaximumSamplesPerPixel(int input)
+{
+    maximumSamplesPerPixel = std::max(input, 1);
+}
+
+void DeadlineEngine::SetThreadCount(int input)
+{
+    threadCount = input;
+}
+
+void DeadlineEngine::Render(ImageWriter& imageWriter, glm::ivec2 resolution, std::chrono::steady_clock::time_point deadline) const
+{
+    assert(scene && camera && sampler && renderer);
+    std::vector<PixelStatistics> pixels(resolution.x * resolution.y, PixelStatistics{ glm::vec3(), 0.0, 0.0, 0 });
+
+    std::vector<Tile> tiles;
+    for (int y = 0; y < resolution.y; y += tileSize) {
+        for (int x = 0; x < resolution.x; x += tileSize) {
+            tiles.push_back(Tile{ glm::ivec2(x, y), glm::min(glm::ivec2(x, y) + tileSize, resolution), 0.0, 0.0 });
+        }
+    }
+
+    ParallelFor(tiles.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            RenderTile(tiles[i], std::min(pilotSamples, maximumSamplesPerPixel), resolution, pixels, deadline);
+        }
+    }, threadCount);
+
+    // Tile costs are measured per thread, so a second of wall time buys this many seconds of tile rendering.
+    const double renderThreads = static_cast<double>((threadCount > 0) ? threadCount : GetDefaultThreadCount());
+    std::vector<double> tileVariances(tiles.size());
+    std::vector<int> additionalSamples;
+    std::vector<size_t> tileOrder(tiles.size());
+    while (true) {
+        const double remainingSeconds = SecondsUntil(deadline);
+        if (remainingSeconds <= 0.0) {
+            break;
+        }
+        const double roundSeconds = (remainingSeconds > 2.0 * MINIMUM_ROUND_SECONDS) ? remainingSeconds * ROUND_TIME_FRACTION : remainingSeconds;
+
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            tileVariances[i] = ComputeTileVariance(tiles[i], resolution, pixels);
+        }
+        AllocateSamples(tiles, tileVariances, roundSeconds * renderThreads, additionalSamples);
+
+        // Tiles that need the most samples go first in case the deadline cuts the round short.
+        tileOrder.clear();
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            if (additionalSamples[i] > 0) {
+                tileOrder.push_back(i);
+            }
+        }
+        if (tileOrder.empty()) {
+            break;
+        }
+        std::stable_sort(tileOrder.begin(), tileOrder.end(), [&](size_t a, size_t b) {
+            return additionalSamples[a] > additionalSamples[b];
+        });
+
+        ParallelFor(tileOrder.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                RenderTile(tiles[tileOrder[i]], additionalSamples[tileOrder[i]], resolution, pixels, deadline);
+            }
+        }, threadCount);
+    }
+
+    for (int y = 0; y < resolution.y; ++y) {
+        for (int x = 0; x < resolution.x; ++x) {
+            const PixelStatistics& pixel = pixels[y * resolution.x + x];
+            imageWriter.SetPixelColor((pixel.sampleCount > 0) ? pixel.colorSum / static_cast<float>(pixel.sampleCount) : glm::vec3(), x, y);
+        }
+    }
+}
+
+bool DeadlineEngine::RenderTile(Tile& tile, int samplesPerPixel, glm::ivec2 resolution, std::vector<PixelStatistics>& pixels, std::chrono::steady_clock::time_point deadline) const
+{
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const PixelSampleTracer tracer(*scene, *camera, *sampler, *renderer, maxReflectionBounces, maxRefractionBounces, resolution);
+    const glm::ivec2 tileExtent = tile.maxPixel - tile.minPixel;
+
+    long long renderedSamples = 0;
+    bool finished = true;
+    for (int r = tile.minPixel.y; r < tile.maxPixel.y && finished; ++r) {
+        for (int c = tile.minPixel.x; c < tile.maxPixel.x; ++c) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                finished = false;
+                break;
+            }
+
+            PixelStatistics& pixel = pixels[r * resolution.x + c];
+            if (pixel.sampleCount >= maximumSamplesPerPixel) {
+                continue;
+            }
+
+            // Continue the sample sequence of the pixel so that stratifying samplers stratify over all rounds.
+            renderedSamples += tracer.TraceSamples(glm::ivec2(c, r), sampler->ComputePixelSeed(glm::ivec2(c, r)), maximumSamplesPerPixel, pixel.sampleCount, samplesPerPixel, [&pixel](const glm::vec3& sampleColor) {
+                const double luminance = ComputeLuminance(sampleColor);
+                pixel.colorSum += sampleColor;
+                pixel.luminanceSum += luminance;
+                pixel.luminanceSquaredSum += luminance * luminance;
+                ++pixel.sampleCount;
+            });
+        }
+    }
+
+    tile.renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    tile.renderedSamplesPerPixel += static_cast<double>(renderedSamples) / static_cast<double>(tileExtent.x * tileExtent.y);
+    return finished;
+}
+
+double DeadlineEngine::ComputeTileVariance(const Tile& tile, glm::ivec2 resolution, const std::vector<PixelStatistics>& pixels)
+{
+    double variance = 0.0;
+    for (int r = tile.minPixel.y; r < tile.maxPixel.y; ++r) {
+        for (int c = tile.minPixel.x; c < tile.maxPixel.x; ++c) {
+            const PixelStatistics& pixel = pixels[r * resolution.x + c];
+            if (pixel.sampleCount < 2) {
+                continue;
+            }
+            const double mean = pixel.luminanceSum / pixel.sampleCount;
+            variance += std::max(pixel.luminanceSquaredSum / pixel.sampleCount - mean * mean, 0.0) * pixel.sampleCount / (pixel.sampleCount - 1);
+        }
+    }
+    return variance;
+}
+
+void DeadlineEngine::AllocateSamples(const std::vector<Tile>& tiles, const std::vector<double>& tileVariances, double budgetSeconds, std::vector<int>& additionalSamples) const
+{
+    const size_t totalTiles = tiles.size();
+    additionalSamples.assign(totalTiles, 0);
+
+    // Tiles the pilot pass did not reach are assumed to cost as much as the average tile.
+    double totalSeconds = 0.0;
+    double totalSamples = 0.0;
+    double totalVariance = 0.0;
+    for (size_t i = 0; i < totalTiles; ++i) {
+        totalSeconds += tiles[i].renderSeconds;
+        totalSamples += tiles[i].renderedSamplesPerPixel;
+        totalVariance += tileVariances[i];
+    }
+    if (totalSamples <= 0.0 || totalVariance <= 0.0) {
+        return;
+    }
+    const double averageCost = std::max(totalSeconds / totalSamples, 1e-9);
+    const double minimumVariance = MINIMUM_VARIANCE_FRACTION * totalVariance / static_cast<double>(totalTiles);
+
+    std::vector<double> costs(totalTiles);
+    std::vector<double> weights(totalTiles);
+    double maximumScale = 0.0;
+    for (size_t i = 0; i < totalTiles; ++i) {
+        costs[i] = (tiles[i].renderedSamplesPerPixel > 0.0) ? std::max(tiles[i].renderSeconds / tiles[i].renderedSamplesPerPixel, 1e-9) : averageCost;
+        weights[i] = std::sqrt(std::max(tileVariances[i], minimumVariance) / costs[i]);
+        maximumScale = std::max(maximumScale, maximumSamplesPerPixel / weights[i]);
+    }
+
+    // Find the scale for which the tiles that are below scale * weight samples per pixel use up the budget.
+    const auto computeSeconds = [&](double scale) {
+        double seconds = 0.0;
+        for (size_t i = 0; i < totalTiles; ++i) {
+            const double targetSamples = std::min(scale * weights[i], static_cast<double>(maximumSamplesPerPixel));
+            seconds += costs[i] * std::max(targetSamples - tiles[i].renderedSamplesPerPixel, 0.0);
+        }
+        return seconds;
+    };
+    double lowScale = 0.0;
+    double highScale = maximumScale;
+    if (computeSeconds(highScale) > budgetSeconds) {
+        for (int iteration = 0; iteration < 50; ++iteration) {
+            const double scale = 0.5 * (lowScale + highScale);
+            if (computeSeconds(scale) > budgetSeconds) {
+                highScale = scale;
+            } else {
+                lowScale = scale;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < totalTiles; ++i) {
+        const double targetSamples = std::min(highScale * weights[i], static_cast<double>(maximumSamplesPerPixel));
+        additionalSamples[i] = static_cast<int>(std::ceil(std::max(targetSamples - tiles[i].renderedSamplesPerPixel, 0.0)));
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "common/common.h"
+#include <chrono>
+
+// Renders the best image it can before a wall-clock deadline. A pilot pass renders a few samples in every tile and measures how
+// long each tile takes per sample (c) and how noisy its pixels are (the summed per-sample variance V). The remaining time is then
+// handed out in rounds: minimizing the summed error V / n subject to the time spent on the samples gives every tile a total of
+// n ~ sqrt(V / c) samples per pixel, so expensive tiles get fewer samples than their noise alone would ask for. Each round
+// spends part of the remaining time and re-measures, which corrects bad early estimates.
+//
+// The deadline is checked before every tile and after every pixel, so the image is ready at most one pixel's worth of samples
+// late even if the estimates are wrong; tiles that the pilot pass did not reach in time stay black.
+class DeadlineEngine
+{
+public:
+    DeadlineEngine(std::shared_ptr<class Scene> inputScene, std::shared_ptr<class Camera> inputCamera, std::shared_ptr<class ColorSampler> inputSampler, std::shared_ptr<class Renderer> inputRenderer);
+
+    void SetMaxBounces(int reflectionBounces, int refractionBounces);
+    void SetTileSize(int input);
+    // Needs to be at least 2 for the pilot pass to see any variance.
+    void SetPilotSamples(int input);
+    void SetMaximumSamplesPerPixel(int input);
+    // 0 uses every hardware thread.
+    void SetThreadCount(int input);
+
+    // The scene must be finalized.
+    void Render(class ImageWriter& imageWriter, glm::ivec2 resolution, std::chrono::steady_clock::time_point deadline) const;
+
+private:
+    struct PixelStatistics
+    {
+        glm::vec3 colorSum;
+        double luminanceSum;
+        double luminanceSquaredSum;
+        int sampleCount;
+    };
+
+    struct Tile
+    {
+        glm::ivec2 minPixel;
+        glm::ivec2 maxPixel;
+        double renderSeconds;
+        // Samples the pixels of the tile actually took, averaged over the tile. A tile cut short by the deadline only counts what it rendered.
+        double renderedSamplesPerPixel;
+    };
+
+    // Returns false if the deadline passed before the tile was done.
+    bool RenderTile(Tile& tile, int samplesPerPixel, glm::ivec2 resolution, std::vector<PixelStatistics>& pixels, std::chrono::steady_clock::time_point deadline) const;
+    // Summed per-sample variance of the pixels of the tile.
+    static double ComputeTileVariance(const Tile& tile, glm::ivec2 resolution, const std::vector<PixelStatistics>& pixels);
+    // Additional samples per pixel for every tile so that the time spent on them adds up to budgetSeconds.
+    void AllocateSamples(const std::vector<Tile>& tiles, const std::vector<double>& tileVariances, double budgetSeconds, std::vector<int>& additionalSamples) const;
+
+    std::shared_ptr<class Scene> scene;
+    std::shared_ptr<class Camera> camera;
+    std::shared_ptr<class ColorSampler> sampler;
+    std::shared_ptr<class Renderer> renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    int tileSize;
+    int pilotSamples;
+    int maximumSamplesPerPixel;
+    int threadCount;
+};
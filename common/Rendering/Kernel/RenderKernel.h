@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Camera/CameraRayBatch.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Acceleration/AccelerationStructure.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Output/ImageWriter.h"
+#include "common/Utility/Threading/ParallelFor.h"
+
+struct RenderKernelParameters
+{
+    const Scene* scene;
+    const ColorSampler* sampler;
+    const Camera* camera;
+    const Renderer* renderer;
+    ImageWriter* imageWriter;
+    glm::ivec2 resolution;
+    int samplesPerPixel;
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    // 0 uses every hardware thread; see Application::GetRenderKernelThreadCount.
+    int threadCount;
+};
+
+using RenderKernelFunction = void (*)(const RenderKernelParameters& parameters);
+
+// The per-pixel loop of RayTracer::Run for one combination of concrete sampler, camera, renderer and top level acceleration
+// structure. Every call on them is qualified with the concrete type, so it binds statically instead of going through the
+// vtable (and the std::function of ColorSampler::ComputeSamplesAndColor is gone), which lets the compiler inline what it can
+// see. Only valid if the objects are exactly of these types; RenderKernelRegistry makes sure of that.
+template<typename SamplerType, typename CameraType, typename RendererType, typename AccelerationType>
+void RenderKernel(const RenderKernelParameters& parameters)
+{
+    const SamplerType& sampler = static_cast<const SamplerType&>(*parameters.sampler);
+    const CameraType& camera = static_cast<const CameraType&>(*parameters.camera);
+    const RendererType& renderer = static_cast<const RendererType&>(*parameters.renderer);
+    const glm::vec2 floatResolution(parameters.resolution);
+
+    ParallelFor(static_cast<size_t>(parameters.resolution.y), 1, [&](size_t beginRow, size_t endRow) {
+        CameraRayBatch cameraRays;
+        for (int r = static_cast<int>(beginRow); r < static_cast<int>(endRow); ++r) {
+            for (int c = 0; c < parameters.resolution.x; ++c) {
+                const glm::ivec2 pixel(c, r);
+                std::unique_ptr<SamplerState> state = sampler.SamplerType::CreateSampler(sampler.ComputePixelSeed(pixel), parameters.samplesPerPixel, 2);
+                state->pixel = pixel;
+                for (int s = 0; s < parameters.samplesPerPixel; ++s) {
+                    const glm::vec3 sampleCoordinates = sampler.SamplerType::ComputeSampleCoordinate(*state.get());
+                    const glm::vec2 normalizedCoordinates = Camera::ComputeNormalizedSampleCoordinates(c, r, sampleCoordinates, parameters.samplesPerPixel, floatResolution);
+                    camera.CameraType::GenerateRays(&normalizedCoordinates, 1, cameraRays);
+                    Ray cameraRay = cameraRays.GetRay(0);
+
+                    IntersectionState rayIntersection(parameters.maxReflectionBounces, parameters.maxRefractionBounces);
+                    rayIntersection.sampleKey = ColorSampler::ComputeSampleKey(state->seed, state->samplesComputed);
+                    glm::vec3 sampleColor;
+                    if (parameters.scene->Scene::TraceClosestHit<AccelerationType>(&cameraRay, rayIntersection)) {
+                        sampleColor = renderer.RendererType::ComputeSampleColor(rayIntersection, cameraRay);
+                    }
+                    if (!sampler.SamplerType::RecordColorSample(*state.get(), sampleColor)) {
+                        break;
+                    }
+                }
+                parameters.imageWriter->SetPixelColor(sampler.SamplerType::ComputeFinalColor(*state.get()), c, r);
+            }
+        }
+    }, parameters.threadCount);
+}
@@ -0,0 +1,39 @@
+#include "common/Rendering/Kernel/RenderKernelRegistry.h"
+#include "common/Sampling/SamplerCommon.h"
+#include "common/Scene/Camera/Perspective/PerspectiveCamera.h"
+#include "common/Rendering/Renderer/Backward/BackwardRenderer.h"
+#include "common/Rendering/Renderer/Photon/PhotonMappingRenderer.h"
+#include "common/Acceleration/BVH/BVHAcceleration.h"
+#include "common/Acceleration/UniformGrid/UniformGridAcceleration.h"
+#include "common/Acceleration/Naive/NaiveAcceleration.h"
+
+RenderKernelRegistry::RenderKernelRegistry()
+{
+    RegisterBuiltInKernels<ColorSampler>();
+    RegisterBuiltInKernels<JitterColorSampler>();
+    RegisterBuiltInKernels<SimpleAdaptiveSampler>();
+    RegisterBuiltInKernels<SobolColorSampler>();
+    RegisterBuiltInKernels<HaltonColorSampler>();
+    RegisterBuiltInKernels<BlueNoiseColorSampler>();
+}
+
+RenderKernelFunction RenderKernelRegistry::FindKernel(const ColorSampler& sampler, const Camera& camera, const Renderer& renderer, const AccelerationStructure& acceleration) const
+{
+    auto kernel = kernels.find(KernelKey(typeid(sampler), typeid(camera), typeid(renderer), typeid(acceleration)));
+    return (kernel != kernels.end()) ? kernel->second : nullptr;
+}
+
+template<typename SamplerType>
+void RenderKernelRegistry::RegisterBuiltInKernels()
+{
+    RegisterBuiltInKernels<SamplerType, BackwardRenderer>();
+    RegisterBuiltInKernels<SamplerType, PhotonMappingRenderer>();
+}
+
+template<typename SamplerType, typename RendererType>
+void RenderKernelRegistry::RegisterBuiltInKernels()
+{
+    RegisterKernel<SamplerType, PerspectiveCamera, RendererType, BVHAcceleration>();
+    RegisterKernel<SamplerType, PerspectiveCamera, RendererType, UniformGridAcceleration>();
+    RegisterKernel<SamplerType, PerspectiveCamera, RendererType, NaiveAcceleration>();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common/Rendering/Kernel/RenderKernel.h"
+#include <map>
+#include <tuple>
+#include <typeindex>
+
+// Maps the concrete types of a sampler, camera, renderer and acceleration structure to the RenderKernel instantiated for them.
+// The constructor registers every combination of the types that come with the ray tracer; applications with their own types
+// add them through Application::RegisterRenderKernels.
+class RenderKernelRegistry
+{
+public:
+    RenderKernelRegistry();
+
+    template<typename SamplerType, typename CameraType, typename RendererType, typename AccelerationType>
+    void RegisterKernel()
+    {
+        kernels[KernelKey(typeid(SamplerType), typeid(CameraType), typeid(RendererType), typeid(AccelerationType))] = &RenderKernel<SamplerType, CameraType, RendererType, AccelerationType>;
+    }
+
+    // Kernel for the exact dynamic types of the arguments; nullptr if that combination was never registered, e.g. for a
+    // subclass of a registered type.
+    RenderKernelFunction FindKernel(const ColorSampler& sampler, const Camera& camera, const Renderer& renderer, const AccelerationStructure& acceleration) const;
+
+private:
+    using KernelKey = std::tuple<std::type_index, std::type_index, std::type_index, std::type_index>;
+
+    template<typename SamplerType>
+    void RegisterBuiltInKernels();
+    template<typename SamplerType, typename RendererType>
+    void RegisterBuiltInKernels();
+
+    std::map<KernelKey, RenderKernelFunction> kernels;
+};
@@ -5,25 +5,101 @@
 #include "common/Rendering/Textures/Texture2D.h"
 #include "assimp/material.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BLINN_PHONG_BATCH_USE_SSE 1
+#else
+#define BLINN_PHONG_BATCH_USE_SSE 0
+#endif
+
+#if BLINN_PHONG_BATCH_USE_SSE
+namespace
+{
+// log2 and exp2 after Cephes' logf/exp2f, accurate to a few ulp over the range the highlight needs.
+__m128 Log2Ps(__m128 x)
+{
+    const __m128i bits = _mm_castps_si128(x);
+    __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+
+    // Move the mantissa from [1, 2) to [sqrt(0.5), sqrt(2)).
+    const __m128 isLarge = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+    exponent = _mm_add_ps(exponent, _mm_and_ps(isLarge, _mm_set1_ps(1.f)));
+    mantissa = _mm_sub_ps(mantissa, _mm_and_ps(isLarge, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f))));
+
+    const __m128 z = _mm_sub_ps(mantissa, _mm_set1_ps(1.f));
+    const __m128 z2 = _mm_mul_ps(z, z);
+    __m128 polynomial = _mm_set1_ps(7.0376836292e-2f);
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(-1.1514610310e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(1.1676998740e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(-1.2420140846e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(1.4249322787e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(-1.6668057665e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(2.0000714765e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(-2.4999993993e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, z), _mm_set1_ps(3.3333331174e-1f));
+    const __m128 naturalLog = _mm_add_ps(z, _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(polynomial, z), z2), _mm_mul_ps(z2, _mm_set1_ps(0.5f))));
+    return _mm_add_ps(exponent, _mm_mul_ps(naturalLog, _mm_set1_ps(1.44269504f)));
+}
+
+__m128 Exp2Ps(__m128 x)
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.f)), _mm_set1_ps(127.f));
+
+    // Split into an integer power and a fraction in [-0.5, 0.5].
+    const __m128i integerPart = _mm_cvtps_epi32(x);
+    const __m128 fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(integerPart));
+    __m128 polynomial = _mm_set1_ps(1.535336188319500e-4f);
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(1.339887440266574e-3f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(9.618437357674640e-3f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(5.550332471162809e-2f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(2.402264791363012e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(6.931472028550421e-1f));
+    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, fraction), _mm_set1_ps(1.f));
+
+    const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integerPart, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(polynomial, scale);
+}
+
+// std::pow(base, exponent) for base in [0, 1], including pow(0, 0) = 1.
+__m128 PowPs(__m128 base, float exponent)
+{
+    const __m128 positive = _mm_cmpgt_ps(base, _mm_setzero_ps());
+    const __m128 result = Exp2Ps(_mm_mul_ps(Log2Ps(base), _mm_set1_ps(exponent)));
+    const __m128 atZero = _mm_set1_ps(exponent == 0.f ? 1.f : 0.f);
+    return _mm_or_ps(_mm_and_ps(positive, result), _mm_andnot_ps(positive, atZero));
+}
+
+__m128 Clamp01Ps(__m128 value)
+{
+    return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.f));
+}
+}
+#endif
+
 BlinnPhongMaterial::BlinnPhongMaterial():
     shininess(0.f)
 {
+    Compile();
 }
 
 void BlinnPhongMaterial::SetDiffuse(glm::vec3 input)
 {
     diffuseColor = input;
+    Compile();
 }
 
 void BlinnPhongMaterial::SetSpecular(glm::vec3 inputColor, float inputShininess)
 {
     specularColor = inputColor;
     shininess = inputShininess;
+    Compile();
 }
 
 glm::vec3 BlinnPhongMaterial::ComputeDiffuse(const IntersectionState& intersection, const glm::vec3& lightColor, const float NdL, const float NdH, const float NdV, const float VdH) const
 {
-    const glm::vec3 useDiffuseColor = (textureStorage.find("diffuseTexture") != textureStorage.end()) ? glm::vec3(textureStorage.at("diffuseTexture")->Sample(intersection.ComputeUV())) : diffuseColor;
+    const Texture* diffuseTexture = compiled.GetTexture(MaterialTextureSlot::DIFFUSE);
+    const glm::vec3 useDiffuseColor = diffuseTexture ? glm::vec3(diffuseTexture->Sample(intersection.ComputeUV())) : compiled.diffuseColor;
     const float d = NdL;
     const glm::vec3 diffuseResponse = d * useDiffuseColor * lightColor;
     return diffuseResponse;
@@ -31,12 +107,93 @@ glm::vec3 BlinnPhongMaterial::ComputeDiffuse(const IntersectionState& intersecti
 
 glm::vec3 BlinnPhongMaterial::ComputeSpecular(const IntersectionState& intersection, const glm::vec3& lightColor, const float NdL, const float NdH, const float NdV, const float VdH) const
 {
-    const glm::vec3 useSpecularColor = (textureStorage.find("specularTexture") != textureStorage.end()) ? glm::vec3(textureStorage.at("specularTexture")->Sample(intersection.ComputeUV())) : specularColor;
-    const float highlight = std::pow(NdH, shininess);
-    const glm::vec3 specularResponse = highlight * specularColor * lightColor;
+    // The highlight has always used the specular color, never the specular texture.
+    if (!compiled.hasSpecularHighlight) {
+        return glm::vec3();
+    }
+    const float highlight = std::pow(NdH, compiled.shininess);
+    const glm::vec3 specularResponse = highlight * compiled.specularColor * lightColor;
     return specularResponse;
 }
 
+void BlinnPhongMaterial::ComputeBRDFBatch(ShadingBatch& batch) const
+{
+    if (batch.totalSamples == 0) {
+        return;
+    }
+    batch.PadToGroupOfFour();
+    const int totalLanes = (batch.totalSamples + 3) & ~3;
+
+    // Textured diffuse colors are fetched for the whole batch first.
+    alignas(16) std::array<float, ShadingBatch::MAX_SAMPLES> diffuseR;
+    alignas(16) std::array<float, ShadingBatch::MAX_SAMPLES> diffuseG;
+    alignas(16) std::array<float, ShadingBatch::MAX_SAMPLES> diffuseB;
+    const Texture* diffuseTexture = compiled.GetTexture(MaterialTextureSlot::DIFFUSE);
+    if (diffuseTexture) {
+        diffuseTexture->SampleBatch(batch.u.data(), batch.v.data(), totalLanes, diffuseR.data(), diffuseG.data(), diffuseB.data());
+    } else {
+        std::fill(diffuseR.begin(), diffuseR.begin() + totalLanes, compiled.diffuseColor.r);
+        std::fill(diffuseG.begin(), diffuseG.begin() + totalLanes, compiled.diffuseColor.g);
+        std::fill(diffuseB.begin(), diffuseB.begin() + totalLanes, compiled.diffuseColor.b);
+    }
+
+    // Same terms as Material::ComputeBRDF with ComputeDiffuse and ComputeSpecular above.
+    const glm::vec3 specular = compiled.hasSpecularHighlight ? compiled.specularColor : glm::vec3();
+#if BLINN_PHONG_BATCH_USE_SSE
+    const __m128 specularR = _mm_set1_ps(specular.r), specularG = _mm_set1_ps(specular.g), specularB = _mm_set1_ps(specular.b);
+    const __m128 directLightScale = _mm_set1_ps(compiled.directLightScale);
+    const __m128 zero = _mm_setzero_ps();
+    for (int base = 0; base < totalLanes; base += 4) {
+        const __m128 nx = _mm_load_ps(&batch.normalX[base]), ny = _mm_load_ps(&batch.normalY[base]), nz = _mm_load_ps(&batch.normalZ[base]);
+        const __m128 lx = _mm_load_ps(&batch.toLightX[base]), ly = _mm_load_ps(&batch.toLightY[base]), lz = _mm_load_ps(&batch.toLightZ[base]);
+        __m128 hx = _mm_add_ps(lx, _mm_load_ps(&batch.toCameraX[base]));
+        __m128 hy = _mm_add_ps(ly, _mm_load_ps(&batch.toCameraY[base]));
+        __m128 hz = _mm_add_ps(lz, _mm_load_ps(&batch.toCameraZ[base]));
+        const __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(hx, hx), _mm_mul_ps(hy, hy)), _mm_mul_ps(hz, hz))));
+        hx = _mm_mul_ps(hx, inverseLength);
+        hy = _mm_mul_ps(hy, inverseLength);
+        hz = _mm_mul_ps(hz, inverseLength);
+
+        const __m128 NdL = Clamp01Ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, lx), _mm_mul_ps(ny, ly)), _mm_mul_ps(nz, lz)));
+        const __m128 NdH = Clamp01Ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, hx), _mm_mul_ps(ny, hy)), _mm_mul_ps(nz, hz)));
+        const __m128 highlight = compiled.hasSpecularHighlight ? PowPs(NdH, compiled.shininess) : zero;
+        const __m128 attenuation = _mm_max_ps(_mm_mul_ps(directLightScale, _mm_load_ps(&batch.attenuation[base])), zero);
+
+        const __m128 r = _mm_add_ps(_mm_mul_ps(NdL, _mm_load_ps(&diffuseR[base])), _mm_mul_ps(highlight, specularR));
+        const __m128 g = _mm_add_ps(_mm_mul_ps(NdL, _mm_load_ps(&diffuseG[base])), _mm_mul_ps(highlight, specularG));
+        const __m128 b = _mm_add_ps(_mm_mul_ps(NdL, _mm_load_ps(&diffuseB[base])), _mm_mul_ps(highlight, specularB));
+        _mm_store_ps(&batch.responseR[base], _mm_mul_ps(attenuation, _mm_mul_ps(r, _mm_load_ps(&batch.lightR[base]))));
+        _mm_store_ps(&batch.responseG[base], _mm_mul_ps(attenuation, _mm_mul_ps(g, _mm_load_ps(&batch.lightG[base]))));
+        _mm_store_ps(&batch.responseB[base], _mm_mul_ps(attenuation, _mm_mul_ps(b, _mm_load_ps(&batch.lightB[base]))));
+    }
+#else
+    for (int i = 0; i < totalLanes; ++i) {
+        const glm::vec3 N(batch.normalX[i], batch.normalY[i], batch.normalZ[i]);
+        const glm::vec3 L(batch.toLightX[i], batch.toLightY[i], batch.toLightZ[i]);
+        const glm::vec3 H = glm::normalize(L + glm::vec3(batch.toCameraX[i], batch.toCameraY[i], batch.toCameraZ[i]));
+        const float NdL = std::min(std::max(glm::dot(N, L), 0.f), 1.f);
+        const float NdH = std::min(std::max(glm::dot(N, H), 0.f), 1.f);
+        const float highlight = compiled.hasSpecularHighlight ? std::pow(NdH, compiled.shininess) : 0.f;
+        const float attenuation = std::max(compiled.directLightScale * batch.attenuation[i], 0.f);
+
+        const glm::vec3 response = attenuation * (NdL * glm::vec3(diffuseR[i], diffuseG[i], diffuseB[i]) + highlight * specular) * glm::vec3(batch.lightR[i], batch.lightG[i], batch.lightB[i]);
+        batch.responseR[i] = response.r;
+        batch.responseG[i] = response.g;
+        batch.responseB[i] = response.b;
+    }
+#endif
+}
+
+void BlinnPhongMaterial::Compile()
+{
+    Material::Compile();
+    compiled.diffuseColor = diffuseColor;
+    compiled.specularColor = specularColor;
+    compiled.shininess = shininess;
+    compiled.hasDiffuse = HasDiffuseReflection();
+    compiled.hasSpecularHighlight = (glm::length2(specularColor) > 0.f);
+}
+
 std::shared_ptr<Material> BlinnPhongMaterial::Clone() const
 {
     return std::make_shared<BlinnPhongMaterial>(*this);
@@ -66,17 +223,17 @@ void BlinnPhongMaterial::LoadMaterialFromAssimp(std::shared_ptr<aiMaterial> assi
         std::string specularPath(aiSpecularPath.C_Str());
         SetTexture("specularTexture", TextureLoader::LoadTexture(specularPath));
     }
-
+    Compile();
 }
 
 bool BlinnPhongMaterial::HasDiffuseReflection() const
 {
-    return (glm::length2(diffuseColor) > 0 || GetTexture("diffuseTexture"));
+    return (glm::length2(diffuseColor) > 0 || GetTexture(MaterialTextureSlot::DIFFUSE));
 }
 
 bool BlinnPhongMaterial::HasSpecularReflection() const
 {
-    return (glm::length2(specularColor) > 0 || GetTexture("specularTexture") || Material::HasSpecularReflection());
+    return (glm::length2(specularColor) > 0 || GetTexture(MaterialTextureSlot::SPECULAR) || Material::HasSpecularReflection());
 }
 
 glm::vec3 BlinnPhongMaterial::GetBaseDiffuseReflection() const
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Material/ShadingBatch.h"
 
-class BlinnPhongMaterial : public Material
+class BlinnPhongMaterial : public Material, public BatchShader
 {
 public:
     BlinnPhongMaterial();
@@ -11,6 +12,10 @@ public:
     void SetSpecular(glm::vec3 inputColor, float inputShininess);
 
     virtual std::shared_ptr<Material> Clone() const override;
+    virtual void Compile() override;
+
+    virtual const BatchShader* GetBatchShader() const override { return this; }
+    virtual void ComputeBRDFBatch(ShadingBatch& batch) const override;
 
     virtual void LoadMaterialFromAssimp(std::shared_ptr<struct aiMaterial> assimpMaterial) override;
 
@@ -7,6 +7,7 @@
 Material::Material():
     reflectivity(0.f), transmittance(0.f), indexOfRefraction(1.f)
 {
+    Compile();
 }
 
 Material::~Material()
@@ -21,6 +22,19 @@ Texture* Material::GetTexture(const std::string& id) const
     return textureStorage.at(id).get();
 }
 
+void Material::Compile()
+{
+    compiled = CompiledMaterial();
+    for (int i = 0; i < static_cast<int>(MaterialTextureSlot::TOTAL); ++i) {
+        compiled.textures[i] = textureSlots[i].get();
+    }
+    compiled.ambient = ambient;
+    compiled.reflectivity = reflectivity;
+    compiled.transmittance = transmittance;
+    compiled.directLightScale = std::max(1.f - reflectivity - transmittance, 0.f);
+    compiled.hasNormalMap = (compiled.GetTexture(MaterialTextureSlot::NORMAL) != nullptr);
+}
+
 glm::vec3 Material::ComputeNonLightDependentBRDF(const class Renderer* renderer, const struct IntersectionState& intersection) const
 {
     const glm::vec3 reflectionColor = ComputeReflection(renderer, intersection);
@@ -59,30 +73,30 @@ glm::vec3 Material::ComputeSpecular(const struct IntersectionState& intersection
 
 glm::vec3 Material::ComputeReflection(const class Renderer* renderer, const struct IntersectionState& intersection) const
 {
-    glm::vec3 reflectedColor;
-    if (intersection.reflectionIntersection && intersection.reflectionIntersection->hasIntersection) {
-        reflectedColor = renderer->ComputeSampleColor(*intersection.reflectionIntersection.get(), intersection.reflectionIntersection->intersectionRay);
+    if (!IsReflective()) {
+        return glm::vec3();
     }
-    return reflectedColor;
+    return renderer->TraceSecondaryRay(intersection, SecondaryRayType::REFLECTION, reflectivity);
 }
 
 glm::vec3 Material::ComputeTransmission(const class Renderer* renderer, const struct IntersectionState& intersection) const
 {
-    glm::vec3 transmissionColor;
-    if (intersection.refractionIntersection && intersection.refractionIntersection->hasIntersection) {
-        transmissionColor = renderer->ComputeSampleColor(*intersection.refractionIntersection.get(), intersection.refractionIntersection->intersectionRay);
+    if (!IsTransmissive()) {
+        return glm::vec3();
     }
-    return transmissionColor;
+    return renderer->TraceSecondaryRay(intersection, SecondaryRayType::REFRACTION, transmittance);
 }
 
 void Material::SetReflectivity(float input)
 {
     reflectivity = input;
+    Compile();
 }
 
 void Material::SetTransmittance(float input)
 {
     transmittance = input;
+    Compile();
 }
 
 void Material::SetIOR(float input)
@@ -102,14 +116,22 @@ void Material::LoadMaterialFromAssimp(std::shared_ptr<struct aiMaterial> assimpM
 
     assimpMaterial->Get(AI_MATKEY_REFRACTI, &indexOfRefraction, nullptr);
     assimpMaterial->Get(AI_MATKEY_COLOR_AMBIENT, glm::value_ptr(ambient), nullptr);
+    Compile();
 }
 
 void Material::SetTexture(const std::string& id, std::shared_ptr<class Texture> inputTexture)
 {
+    for (size_t i = 0; i < MATERIAL_TEXTURE_SLOT_IDS.size(); ++i) {
+        if (id == MATERIAL_TEXTURE_SLOT_IDS[i]) {
+            textureSlots[i] = inputTexture;
+        }
+    }
     textureStorage[id] = std::move(inputTexture);
+    Compile();
 }
 
 void Material::SetAmbient(const glm::vec3& input)
 {
     ambient = input;
+    Compile();
 }
\ No newline at end of file
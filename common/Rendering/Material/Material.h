@@ -2,6 +2,45 @@
 
 #include "common/common.h"
 
+// Textures that are looked up while shading. SetTexture files the ids of MATERIAL_TEXTURE_SLOT_IDS under these slots so
+// that shading indexes an array instead of hashing a string.
+enum class MaterialTextureSlot
+{
+    DIFFUSE,
+    SPECULAR,
+    NORMAL,
+    TOTAL
+};
+
+// Texture id of every slot, indexed by MaterialTextureSlot.
+const std::array<const char*, static_cast<int>(MaterialTextureSlot::TOTAL)> MATERIAL_TEXTURE_SLOT_IDS = {{ "diffuseTexture", "specularTexture", "normalTexture" }};
+
+// Flat copy of everything shading needs from a material, built by Material::Compile.
+struct CompiledMaterial
+{
+    CompiledMaterial() :
+        textures(), shininess(0.f), reflectivity(0.f), transmittance(0.f), directLightScale(1.f), hasDiffuse(false), hasSpecularHighlight(false), hasNormalMap(false)
+    {
+    }
+
+    const class Texture* GetTexture(MaterialTextureSlot slot) const { return textures[static_cast<int>(slot)]; }
+
+    std::array<const class Texture*, static_cast<int>(MaterialTextureSlot::TOTAL)> textures;
+    glm::vec3 diffuseColor;
+    glm::vec3 specularColor;
+    float shininess;
+    glm::vec3 ambient;
+    float reflectivity;
+    float transmittance;
+    // Weight of the light dependent BRDF, max(1 - reflectivity - transmittance, 0).
+    float directLightScale;
+
+    bool hasDiffuse;
+    // Whether ComputeSpecular can return anything but black.
+    bool hasSpecularHighlight;
+    bool hasNormalMap;
+};
+
 class Material: public std::enable_shared_from_this<Material>
 {
 public:
@@ -10,6 +49,10 @@ public:
 
     virtual glm::vec3 ComputeNonLightDependentBRDF(const class Renderer* renderer, const struct IntersectionState& intersection) const;
     virtual glm::vec3 ComputeBRDF(const struct IntersectionState& intersection, const glm::vec3& lightColor, const class Ray& toLightRay, const class Ray& fromCameraRay, float lightAttenuation, bool computeDiffuse = true, bool computeSpecular = true) const;
+
+    // Shades batches of light samples for materials that can (see ShadingBatch.h), nullptr for all others. Subclasses
+    // that change ComputeDiffuse or ComputeSpecular of such a material have to return nullptr again.
+    virtual const class BatchShader* GetBatchShader() const { return nullptr; }
     
     virtual std::shared_ptr<Material> Clone() const = 0;
     virtual void LoadMaterialFromAssimp(std::shared_ptr<struct aiMaterial> assimpMaterial);
@@ -19,6 +62,7 @@ public:
 
     void SetReflectivity(float input);
     bool IsReflective() const { return reflectivity > SMALL_EPSILON; }
+    float GetReflectivity() const { return reflectivity; }
 
     void SetTransmittance(float input);
     bool IsTransmissive() const { return transmittance > SMALL_EPSILON; }
@@ -33,8 +77,15 @@ public:
 
     void SetTexture(const std::string& id, std::shared_ptr<class Texture> inputTexture);
     class Texture* GetTexture(const std::string& id) const;
+    class Texture* GetTexture(MaterialTextureSlot slot) const { return textureSlots[static_cast<int>(slot)].get(); }
+
+    // Rebuilds the compiled material, which is all that shading reads. Every setter calls it, so only subclasses that
+    // change what they compile without going through a setter need to call it themselves.
+    virtual void Compile();
+    const CompiledMaterial& GetCompiledMaterial() const { return compiled; }
 
     void SetAmbient(const glm::vec3& input);
+    glm::vec3 GetAmbient() const { return ambient; }
 
 protected:
     virtual glm::vec3 ComputeDiffuse(const struct IntersectionState& intersection, const glm::vec3& lightColor, const float NdL, const float NdH, const float NdV, const float VdH) const;
@@ -43,6 +94,8 @@ protected:
     virtual glm::vec3 ComputeTransmission(const class Renderer* renderer, const struct IntersectionState& intersection) const;
 
     std::unordered_map<std::string, std::shared_ptr<class Texture>> textureStorage;
+    std::array<std::shared_ptr<class Texture>, static_cast<int>(MaterialTextureSlot::TOTAL)> textureSlots;
+    CompiledMaterial compiled;
 private:
     glm::vec3 ambient;
     float reflectivity;         // Perfect reflection 
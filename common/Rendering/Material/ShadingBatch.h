@@ -0,0 +1,106 @@
+#pragma once
+
+#include "common/common.h"
+
+// Light samples of up to MAX_SAMPLES hits on the same material, filled by the renderer and shaded at once by the
+// material's BatchShader. Kept on the caller's side and laid out one component per array so that materials can
+// evaluate several samples at once.
+struct ShadingBatch
+{
+    static const int MAX_SAMPLES = 64;
+
+    ShadingBatch() :
+        totalSamples(0)
+    {
+    }
+
+    bool IsFull() const { return totalSamples == MAX_SAMPLES; }
+    void Clear() { totalSamples = 0; }
+
+    // All directions are normalized; toLight and toCamera point away from the hit. uv is only read by textured materials.
+    int AddSample(const glm::vec3& normal, const glm::vec3& toLight, const glm::vec3& toCamera, const glm::vec2& uv, const glm::vec3& lightColor, float lightAttenuation)
+    {
+        assert(!IsFull());
+        const int index = totalSamples++;
+        normalX[index] = normal.x;
+        normalY[index] = normal.y;
+        normalZ[index] = normal.z;
+        toLightX[index] = toLight.x;
+        toLightY[index] = toLight.y;
+        toLightZ[index] = toLight.z;
+        toCameraX[index] = toCamera.x;
+        toCameraY[index] = toCamera.y;
+        toCameraZ[index] = toCamera.z;
+        u[index] = uv.x;
+        v[index] = uv.y;
+        lightR[index] = lightColor.r;
+        lightG[index] = lightColor.g;
+        lightB[index] = lightColor.b;
+        attenuation[index] = lightAttenuation;
+        return index;
+    }
+
+    // Repeats the last sample up to the next multiple of 4 so that materials can work in groups of 4 without reading
+    // unset lanes.
+    void PadToGroupOfFour()
+    {
+        assert(totalSamples > 0);
+        const int last = totalSamples - 1;
+        for (int index = totalSamples; index < MAX_SAMPLES && (index & 3); ++index) {
+            normalX[index] = normalX[last];
+            normalY[index] = normalY[last];
+            normalZ[index] = normalZ[last];
+            toLightX[index] = toLightX[last];
+            toLightY[index] = toLightY[last];
+            toLightZ[index] = toLightZ[last];
+            toCameraX[index] = toCameraX[last];
+            toCameraY[index] = toCameraY[last];
+            toCameraZ[index] = toCameraZ[last];
+            u[index] = u[last];
+            v[index] = v[last];
+            lightR[index] = lightR[last];
+            lightG[index] = lightG[last];
+            lightB[index] = lightB[last];
+            attenuation[index] = attenuation[last];
+        }
+    }
+
+    glm::vec3 GetResponse(int index) const
+    {
+        return glm::vec3(responseR[index], responseG[index], responseB[index]);
+    }
+
+    int totalSamples;
+
+    alignas(16) std::array<float, MAX_SAMPLES> normalX;
+    alignas(16) std::array<float, MAX_SAMPLES> normalY;
+    alignas(16) std::array<float, MAX_SAMPLES> normalZ;
+    alignas(16) std::array<float, MAX_SAMPLES> toLightX;
+    alignas(16) std::array<float, MAX_SAMPLES> toLightY;
+    alignas(16) std::array<float, MAX_SAMPLES> toLightZ;
+    alignas(16) std::array<float, MAX_SAMPLES> toCameraX;
+    alignas(16) std::array<float, MAX_SAMPLES> toCameraY;
+    alignas(16) std::array<float, MAX_SAMPLES> toCameraZ;
+    alignas(16) std::array<float, MAX_SAMPLES> u;
+    alignas(16) std::array<float, MAX_SAMPLES> v;
+    alignas(16) std::array<float, MAX_SAMPLES> lightR;
+    alignas(16) std::array<float, MAX_SAMPLES> lightG;
+    alignas(16) std::array<float, MAX_SAMPLES> lightB;
+    alignas(16) std::array<float, MAX_SAMPLES> attenuation;
+
+    // Written by BatchShader::ComputeBRDFBatch: what Material::ComputeBRDF returns for the same sample.
+    alignas(16) std::array<float, MAX_SAMPLES> responseR;
+    alignas(16) std::array<float, MAX_SAMPLES> responseG;
+    alignas(16) std::array<float, MAX_SAMPLES> responseB;
+};
+
+// Implemented by materials that can shade a ShadingBatch; Material::GetBatchShader hands it out. Batches carry no
+// IntersectionState, so a material can only offer this if its BRDF needs nothing beyond what the batch holds.
+class BatchShader
+{
+public:
+    virtual ~BatchShader() {}
+
+    // Evaluates Material::ComputeBRDF for every sample of the batch at once.
+    virtual void ComputeBRDFBatch(ShadingBatch& batch) const = 0;
+};
@@ -0,0 +1,26 @@
+#include "common/Rendering/PixelSampling/PixelSampleTracer.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Intersection/IntersectionState.h"
+
+PixelSampleTracer::PixelSampleTracer(const Scene& inputScene, const Camera& inputCamera, const ColorSampler& inputSampler, const Renderer& inputRenderer, int reflectionBounces, int refractionBounces, glm::ivec2 resolution):
+    scene(inputScene), camera(inputCamera), sampler(inputSampler), renderer(inputRenderer), maxReflectionBounces(reflectionBounces), maxRefractionBounces(refractionBounces),
+    floatResolution(resolution)
+{
+}
+
+glm::vec3 PixelSampleTracer::TraceSample(SamplerState& state) const
+{
+    const glm::vec3 sampleCoordinates = sampler.ComputeSampleCoordinate(state);
+    const glm::vec2 normalizedCoordinates = Camera::ComputeNormalizedSampleCoordinates(state.pixel.x, state.pixel.y, sampleCoordinates, state.maxSamples, floatResolution);
+    Ray cameraRay = camera.GenerateRay(normalizedCoordinates);
+
+    IntersectionState rayIntersection(maxReflectionBounces, maxRefractionBounces);
+    rayIntersection.sampleKey = ColorSampler::ComputeSampleKey(state.seed, state.samplesComputed);
+    if (!scene.Trace(&cameraRay, &rayIntersection)) {
+        return glm::vec3();
+    }
+    return renderer.ComputeSampleColor(rayIntersection, cameraRay);
+}
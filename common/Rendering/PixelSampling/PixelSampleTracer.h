@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Sampling/ColorSampler.h"
+
+// The per-pixel sample loop of the engines that trace camera rays one pixel at a time (adaptive, deadline and
+// progressive): every sample takes the next coordinate of the pixel's sampler, traces the camera ray through it, shades
+// the hit and records the color with the sampler. Meant to be created once per render call, on the caller's stack.
+class PixelSampleTracer
+{
+public:
+    PixelSampleTracer(const class Scene& inputScene, const class Camera& inputCamera, const ColorSampler& inputSampler, const class Renderer& inputRenderer, int reflectionBounces, int refractionBounces, glm::ivec2 resolution);
+
+    // Traces up to sampleCount samples of the pixel and hands every sample color to onSample before recording it, stopping
+    // early once the sampler wants no more. The pixel's sequence of maxSamples samples continues at firstSample, so that
+    // stratifying samplers stratify over every call for the pixel. Returns the number of samples traced.
+    template<typename SampleCallback>
+    int TraceSamples(glm::ivec2 pixel, uint32_t pixelSeed, int maxSamples, int firstSample, int sampleCount, SampleCallback onSample) const
+    {
+        std::unique_ptr<SamplerState> state = sampler.CreateSampler(pixelSeed, maxSamples, 2);
+        state->samplesComputed = firstSample;
+        state->pixel = pixel;
+        for (int s = 0; s < sampleCount; ++s) {
+            const glm::vec3 sampleColor = TraceSample(*state.get());
+            onSample(sampleColor);
+            if (!sampler.RecordColorSample(*state.get(), sampleColor)) {
+                break;
+            }
+        }
+        return state->samplesComputed - firstSample;
+    }
+
+private:
+    glm::vec3 TraceSample(SamplerState& state) const;
+
+    const class Scene& scene;
+    const class Camera& camera;
+    const ColorSampler& sampler;
+    const class Renderer& renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    glm::vec2 floatResolution;
+};
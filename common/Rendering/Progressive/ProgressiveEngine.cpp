@@ -0,0 +1,114 @@
+#include "common/Rendering/Progressive/ProgressiveEngine.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Rendering/PixelSampling/PixelSampleTracer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Output/AccumulationBuffer.h"
+#include "common/Utility/Threading/ParallelFor.h"
+#include <chrono>
+
+namespace
+{
+// Rows per ParallelFor range.
+const size_t ROW_GRAIN_SIZE = 1;
+}
+
+ProgressiveEngine::ProgressiveEngine(std::shared_ptr<Scene> inputScene, std::shared_ptr<Camera> inputCamera, std::shared_ptr<ColorSampler> inputSampler, std::shared_ptr<Renderer> inputRenderer):
+    scene(std::move(inputScene)), camera(std::move(inputCamera)), sampler(std::move(inputSampler)), renderer(std::move(inputRenderer)), maxReflectionBounces(0), maxRefractionBounces(0),
+    targetSamplesPerPixel(1), maximumPassSamples(16), checkpointInterval(0.f), threadCount(0)
+{
+}
+
+void ProgressiveEngine::SetMaxBounces(int reflectionBounces, int refractionBounces)
+{
+    maxReflectionBounces = reflectionBounces;
+    maxRefractionBounces = refractionBounces;
+}
+
+void ProgressiveEngine::SetTargetSamplesPerPixel(int input)
+{
+    targetSamplesPerPixel = std::max(input, 1);
+}
+
+void ProgressiveEngine::SetMaximumPassSamples(int input)
+{
+    maximumPassSamples = std::max(input, 1);
+}
+
+void ProgressiveEngine::SetCheckpoint(const std::string& filename, float intervalInSeconds)
+{
+    checkpointFilename = filename;
+    checkpointInterval = intervalInSeconds;
+}
+
+void ProgressiveEngine::SetPassCallback(std::function<void(const AccumulationBuffer&)> callback)
+{
+    passCallback = std::move(callback);
+}
+
+void ProgressiveEngine::SetThreadCount(int input)
+{
+    threadCount = input;
+}
+
+void ProgressiveEngine::Render(AccumulationBuffer& buffer) const
+{
+    assert(scene && camera && sampler && renderer);
+    if (!checkpointFilename.empty() && buffer.LoadCheckpoint(checkpointFilename)) {
+        std::cout << "Resuming from " << checkpointFilename << " after " << buffer.GetCompletedSamplesPerPixel() << " samples per pixel." << std::endl;
+    } else if (buffer.GetCompletedPasses() == 0) {
+        buffer.SetRenderSeed(sampler->GetRenderSeed());
+    }
+    // A buffer that already holds samples keeps the seed it was started with, so its pixels continue their sample sequences.
+    sampler->SetRenderSeed(buffer.GetRenderSeed());
+
+    std::chrono::steady_clock::time_point lastCheckpoint = std::chrono::steady_clock::now();
+    bool hasUnsavedPasses = false;
+    while (buffer.GetCompletedSamplesPerPixel() < targetSamplesPerPixel) {
+        const int pass = buffer.GetCompletedPasses();
+        const int scheduledSamples = (pass == 0) ? 1 : std::min(1 << std::min(pass - 1, 30), maximumPassSamples);
+        const int passSamples = std::min(scheduledSamples, targetSamplesPerPixel - buffer.GetCompletedSamplesPerPixel());
+
+        RenderPass(buffer, passSamples);
+        buffer.CompletePass(passSamples);
+        hasUnsavedPasses = true;
+
+        if (passCallback) {
+            passCallback(buffer);
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!checkpointFilename.empty() && std::chrono::duration<float>(now - lastCheckpoint).count() >= checkpointInterval) {
+            buffer.SaveCheckpoint(checkpointFilename);
+            lastCheckpoint = now;
+            hasUnsavedPasses = false;
+        }
+    }
+
+    // The final checkpoint lets a later render add more samples.
+    if (!checkpointFilename.empty() && hasUnsavedPasses) {
+        buffer.SaveCheckpoint(checkpointFilename);
+    }
+}
+
+void ProgressiveEngine::RenderPass(AccumulationBuffer& buffer, int passSamples) const
+{
+    const int width = buffer.GetWidth();
+    const int height = buffer.GetHeight();
+    const PixelSampleTracer tracer(*scene, *camera, *sampler, *renderer, maxReflectionBounces, maxRefractionBounces, glm::ivec2(width, height));
+
+    ParallelFor(static_cast<size_t>(height), ROW_GRAIN_SIZE, [&](size_t beginRow, size_t endRow) {
+        for (int r = static_cast<int>(beginRow); r < static_cast<int>(endRow); ++r) {
+            for (int c = 0; c < width; ++c) {
+                // The state continues where the previous passes of the pixel stopped, so stratifying samplers keep stratifying
+                // over the whole render.
+                glm::vec3 colorSum;
+                const int tracedSamples = tracer.TraceSamples(glm::ivec2(c, r), sampler->ComputePixelSeed(glm::ivec2(c, r)), targetSamplesPerPixel, buffer.GetSampleCount(c, r), passSamples, [&colorSum](const glm::vec3& sampleColor) {
+                    colorSum += sampleColor;
+                });
+                buffer.AddSamples(c, r, colorSum, tracedSamples);
+            }
+        }
+    }, threadCount);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/common.h"
+
+// Renders in passes of 1, 1, 2, 4, ... samples per pixel (up to a per-pass maximum) into an AccumulationBuffer until the target
+// sample count is reached, so that a usable image exists after the first pass. With a checkpoint file, the buffer is saved
+// whenever the checkpoint interval has passed at the end of a pass, and a later render of the same resolution picks up from it;
+// raising the target sample count then only renders the missing samples.
+//
+// The sampler of every pixel is seeded from the render seed and the pixel, and its random numbers are indexed by the sample
+// count of the pixel, so a resumed render draws exactly the samples that the interrupted one would have drawn next. A fresh
+// render takes the render seed of the ColorSampler; a resumed one sets the ColorSampler to the seed stored in the checkpoint.
+class ProgressiveEngine
+{
+public:
+    ProgressiveEngine(std::shared_ptr<class Scene> inputScene, std::shared_ptr<class Camera> inputCamera, std::shared_ptr<class ColorSampler> inputSampler, std::shared_ptr<class Renderer> inputRenderer);
+
+    void SetMaxBounces(int reflectionBounces, int refractionBounces);
+    void SetTargetSamplesPerPixel(int input);
+    void SetMaximumPassSamples(int input);
+    // An empty filename disables checkpoints.
+    void SetCheckpoint(const std::string& filename, float intervalInSeconds);
+    // Called with the accumulated image after every pass, e.g. to write a preview.
+    void SetPassCallback(std::function<void(const class AccumulationBuffer&)> callback);
+    // 0 uses every hardware thread.
+    void SetThreadCount(int input);
+
+    // The scene must be finalized.
+    void Render(class AccumulationBuffer& buffer) const;
+
+private:
+    void RenderPass(class AccumulationBuffer& buffer, int passSamples) const;
+
+    std::shared_ptr<class Scene> scene;
+    std::shared_ptr<class Camera> camera;
+    std::shared_ptr<class ColorSampler> sampler;
+    std::shared_ptr<class Renderer> renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    int targetSamplesPerPixel;
+    int maximumPassSamples;
+    std::string checkpointFilename;
+    float checkpointInterval;
+    std::function<void(const class AccumulationBuffer&)> passCallback;
+    int threadCount;
+};
@@ -1,12 +1,112 @@
 #include "common/Rendering/Renderer.h"
 #include "common/Scene/Scene.h"
 #include "common/Sampling/ColorSampler.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Utility/Random/RandomStream.h"
+
+namespace
+{
+// Dimension ids of the keys derived from IntersectionState::sampleKey.
+enum SampleKeyDimension : uint32_t
+{
+    LIGHT_SAMPLE_DIMENSION,
+    REFLECTION_SAMPLE_DIMENSION,
+    REFRACTION_SAMPLE_DIMENSION
+};
+}
 
 Renderer::Renderer(std::shared_ptr<Scene> scene, std::shared_ptr<ColorSampler> sampler) :
-    storedScene(scene), storedSampler(sampler)
+    storedScene(scene), storedSampler(sampler), minimumSecondaryThroughput(1e-3f), rouletteSecondaryThroughput(0.f)
 {
 }
 
 Renderer::~Renderer()
 {
-}
\ No newline at end of file
+}
+
+void Renderer::ComputeSampleColors(const IntersectionState* intersections, const Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const
+{
+    for (int lane = 0; lane < totalLanes; ++lane) {
+        colors[lane] = (hitMask & (uint64_t(1) << lane)) ? ComputeSampleColor(intersections[lane], fromCameraRays[lane]) : glm::vec3();
+    }
+}
+
+glm::vec3 Renderer::TraceSecondaryRay(const IntersectionState& intersection, SecondaryRayType type, float weight) const
+{
+    const bool isReflection = (type == SecondaryRayType::REFLECTION);
+    if ((isReflection ? intersection.remainingReflectionBounces : intersection.remainingRefractionBounces) <= 0) {
+        return glm::vec3();
+    }
+
+    const glm::vec3 throughput = intersection.throughput * weight;
+    const Ray& inputRay = intersection.intersectionRay;
+    const float terminationWeight = ComputeSecondaryRayWeight(throughput, GenerateRandomNumber(inputRay, static_cast<uint32_t>(type)));
+    if (terminationWeight <= 0.f) {
+        return glm::vec3();
+    }
+
+    const glm::vec3 intersectionPoint = inputRay.GetRayPosition(intersection.intersectionT);
+    const float NdR = glm::dot(inputRay.GetRayDirection(), intersection.ComputeNormal());
+
+    IntersectionState secondaryIntersection(intersection.remainingReflectionBounces - (isReflection ? 1 : 0), intersection.remainingRefractionBounces - (isReflection ? 0 : 1));
+    secondaryIntersection.throughput = throughput * terminationWeight;
+    secondaryIntersection.sampleKey = ComputeSecondarySampleKey(intersection.sampleKey, type);
+
+    Ray secondaryRay;
+    if (isReflection) {
+        storedScene->PerformRaySpecularReflection(secondaryRay, inputRay, intersectionPoint, NdR, intersection);
+    } else {
+        const Material* material = intersection.intersectedPrimitive->GetParentMeshObject()->GetMaterial();
+        assert(material);
+
+        // If we're going into the mesh, set the target IOR to be the IOR of the mesh.
+        float targetIOR = (NdR < SMALL_EPSILON) ? material->GetIOR() : 1.f;
+        storedScene->PerformRayRefraction(secondaryRay, inputRay, intersectionPoint, NdR, intersection, targetIOR);
+        secondaryIntersection.currentIOR = targetIOR;
+    }
+
+    if (!storedScene->Trace(&secondaryRay, &secondaryIntersection)) {
+        return glm::vec3();
+    }
+    return terminationWeight * ComputeSampleColor(secondaryIntersection, secondaryRay);
+}
+
+void Renderer::SetSecondaryRayTermination(float minimumThroughput, float rouletteThroughput)
+{
+    minimumSecondaryThroughput = minimumThroughput;
+    rouletteSecondaryThroughput = rouletteThroughput;
+}
+
+float Renderer::ComputeSecondaryRayWeight(const glm::vec3& throughput, float u) const
+{
+    const float maximumThroughput = std::max(std::max(throughput.x, throughput.y), throughput.z);
+    if (maximumThroughput < minimumSecondaryThroughput || maximumThroughput <= 0.f) {
+        return 0.f;
+    }
+
+    if (maximumThroughput >= rouletteSecondaryThroughput) {
+        return 1.f;
+    }
+
+    const float survivalProbability = maximumThroughput / rouletteSecondaryThroughput;
+    return (u < survivalProbability) ? 1.f / survivalProbability : 0.f;
+}
+
+float Renderer::GenerateRandomNumber(const Ray& ray, uint32_t dimension)
+{
+    return RandomStream::ToFloat(RandomStream::Hash(RandomStream::Hash(glm::vec3(ray.GetPosition())), RandomStream::Hash(ray.GetRayDirection()), dimension));
+}
+
+uint32_t Renderer::ComputeLightSampleKey(uint32_t sampleKey, size_t lightIndex)
+{
+    return RandomStream::Hash(sampleKey, LIGHT_SAMPLE_DIMENSION, static_cast<uint32_t>(lightIndex));
+}
+
+uint32_t Renderer::ComputeSecondarySampleKey(uint32_t sampleKey, SecondaryRayType type)
+{
+    return RandomStream::Hash(sampleKey, (type == SecondaryRayType::REFLECTION) ? REFLECTION_SAMPLE_DIMENSION : REFRACTION_SAMPLE_DIMENSION);
+}
@@ -2,6 +2,12 @@
 
 #include "common/common.h"
 
+enum class SecondaryRayType
+{
+    REFLECTION,
+    REFRACTION
+};
+
 class Renderer : public std::enable_shared_from_this<Renderer>
 {
 public:
@@ -11,7 +17,38 @@ public:
     virtual void InitializeRenderer() = 0;
     
     virtual glm::vec3 ComputeSampleColor(const struct IntersectionState& intersection, const class Ray& fromCameraRay) const = 0;
+    // ComputeSampleColor for the lanes of a ray packet: colors[lane] is set for every lane below totalLanes, to black for lanes
+    // whose bit is not set in hitMask. Renderers may shade the lanes together.
+    virtual void ComputeSampleColors(const struct IntersectionState* intersections, const class Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const;
+
+    // Traces the reflection/refraction ray leaving the hit and returns the color it sees. weight is the factor that the caller
+    // scales the color by; together with the throughput of the hit it decides whether the ray is worth tracing at all.
+    glm::vec3 TraceSecondaryRay(const struct IntersectionState& intersection, SecondaryRayType type, float weight) const;
+
+    // Reflection/refraction rays whose throughput is below minimumThroughput are never traced. Below rouletteThroughput
+    // rays are terminated at random (Russian roulette) and survivors are weighted up so that the image stays unbiased.
+    // Roulette is off by default since it trades the saved rays for noise, which only averages out with many samples per pixel.
+    void SetSecondaryRayTermination(float minimumThroughput, float rouletteThroughput);
+
+    // Returns 0 if a reflection/refraction ray with the given throughput should not be traced, otherwise the factor that its color
+    // has to be scaled by to make up for the rays that were terminated. u is a uniform random number for the roulette.
+    float ComputeSecondaryRayWeight(const glm::vec3& throughput, float u) const;
+
+    // Uniform random number in [0, 1) for a decision made where the ray ends, hashed from the ray and the dimension. The ray
+    // descends from a camera ray whose sample is seeded by pixel, so the result does not depend on the thread either.
+    // Dimensions 0 and 1 are the reflection and refraction roulette of TraceSecondaryRay.
+    static float GenerateRandomNumber(const class Ray& ray, uint32_t dimension);
+
+    // Key of the sample coordinates of a light at a hit: the hit's IntersectionState::sampleKey hashed with a dimension id
+    // of its own and the light, so that neither pixels, samples nor lights share coordinates.
+    static uint32_t ComputeLightSampleKey(uint32_t sampleKey, size_t lightIndex);
+    // sampleKey of the hits of the reflection/refraction ray leaving a hit with the given sampleKey.
+    static uint32_t ComputeSecondarySampleKey(uint32_t sampleKey, SecondaryRayType type);
 protected:
+
     std::shared_ptr<class Scene> storedScene;
     std::shared_ptr<class ColorSampler> storedSampler;
+
+    float minimumSecondaryThroughput;
+    float rouletteSecondaryThroughput;
 };
\ No newline at end of file
@@ -2,13 +2,33 @@
 #include "common/Scene/Scene.h"
 #include "common/Sampling/ColorSampler.h"
 #include "common/Scene/Lights/Light.h"
+#include "common/Scene/Lights/Tree/LightTree.h"
 #include "common/Scene/Geometry/Primitives/Primitive.h"
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
 #include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Material/ShadingBatch.h"
 #include "common/Intersection/IntersectionState.h"
 
+namespace
+{
+// Random dimension of the first light sample, after the roulette dimensions of Renderer::TraceSecondaryRay.
+const uint32_t LIGHT_SELECTION_DIMENSION = 2;
+}
+
+struct BackwardRenderer::PacketBatch
+{
+    // The light samples in batch are all on this material, which has a BatchShader.
+    const Material* material;
+    ShadingBatch batch;
+    // Lane of every sample in batch, whose color the response is added to.
+    std::array<int, ShadingBatch::MAX_SAMPLES> sampleLanes;
+    glm::vec3* colors;
+};
+
+std::atomic<uint64_t> BackwardRenderer::globalRendererCount(0);
+
 BackwardRenderer::BackwardRenderer(std::shared_ptr<Scene> scene, std::shared_ptr<ColorSampler> sampler) :
-    Renderer(scene, sampler)
+    Renderer(scene, sampler), lightSamples(0), useOccluderCache(true), rendererId(++globalRendererCount)
 {
 }
 
@@ -17,6 +37,28 @@ void BackwardRenderer::InitializeRenderer()
 }
 
 glm::vec3 BackwardRenderer::ComputeSampleColor(const IntersectionState& intersection, const Ray& fromCameraRay) const
+{
+    return ComputeHitColor(intersection, fromCameraRay, nullptr, 0);
+}
+
+void BackwardRenderer::ComputeSampleColors(const IntersectionState* intersections, const Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const
+{
+    // Camera rays of a packet mostly hit the same material, so the light samples of consecutive lanes fill the same batch.
+    PacketBatch packetBatch;
+    packetBatch.material = nullptr;
+    packetBatch.colors = colors;
+    for (int lane = 0; lane < totalLanes; ++lane) {
+        colors[lane] = glm::vec3();
+    }
+    for (int lane = 0; lane < totalLanes; ++lane) {
+        if (hitMask & (uint64_t(1) << lane)) {
+            colors[lane] += ComputeHitColor(intersections[lane], fromCameraRays[lane], &packetBatch, lane);
+        }
+    }
+    FlushPacketBatch(packetBatch);
+}
+
+glm::vec3 BackwardRenderer::ComputeHitColor(const IntersectionState& intersection, const Ray& fromCameraRay, PacketBatch* packetBatch, int lane) const
 {
     if (!intersection.hasIntersection) {
         return glm::vec3();
@@ -30,27 +72,183 @@ glm::vec3 BackwardRenderer::ComputeSampleColor(const IntersectionState& intersec
     assert(objectMaterial);
 
     // Compute the color at the intersection.
+    // Materials with a BatchShader leave their light samples in the packet's batch, which adds the response to the lane later.
+    if (packetBatch && !objectMaterial->GetBatchShader()) {
+        packetBatch = nullptr;
+    }
+    if (packetBatch && packetBatch->material != objectMaterial) {
+        FlushPacketBatch(*packetBatch);
+        packetBatch->material = objectMaterial;
+    }
+
     glm::vec3 sampleColor;
-    for (size_t i = 0; i < storedScene->GetTotalLights(); ++i) {
-        const Light* light = storedScene->GetLightObject(i);
-        assert(light);
-
-        // Sample light using rays, Number of samples and where to sample is determined by the light.
-        std::vector<Ray> sampleRays;
-        light->ComputeSampleRays(sampleRays, intersectionPoint, intersection.ComputeNormal());
-
-        for (size_t s = 0; s < sampleRays.size(); ++s) {
-            // note that max T should be set to be right before the light.
-            if (storedScene->Trace(&sampleRays[s], nullptr)) {
-                continue;
-            }
-            const float lightAttenuation = light->ComputeLightAttenuation(intersectionPoint);
+    const LightTree* lightTree = storedScene->GetLightTree();
+    if (lightSamples <= 0 || !lightTree) {
+        for (size_t i = 0; i < storedScene->GetTotalLights(); ++i) {
+            sampleColor += ComputeLightContribution(i, intersection, intersectionPoint, fromCameraRay, objectMaterial, 1.f, packetBatch, lane);
+        }
+    } else {
+        const std::vector<size_t>& infiniteLights = lightTree->GetInfiniteLights();
+        for (size_t i = 0; i < infiniteLights.size(); ++i) {
+            sampleColor += ComputeLightContribution(infiniteLights[i], intersection, intersectionPoint, fromCameraRay, objectMaterial, 1.f, packetBatch, lane);
+        }
 
-            // Note that the material should compute the parts of the lighting equation too.
-            const glm::vec3 brdfResponse = objectMaterial->ComputeBRDF(intersection, light->GetLightColor(), sampleRays[s], fromCameraRay, lightAttenuation);
-            sampleColor += brdfResponse;
+        // Dividing by the probability of picking the light keeps the estimate of the sum over all lights unbiased.
+        for (int s = 0; s < lightSamples; ++s) {
+            size_t lightIndex;
+            float lightProbability;
+            if (!SampleLight(*lightTree, intersection, intersectionPoint, s, lightIndex, lightProbability)) {
+                break;
+            }
+            const float lightWeight = 1.f / (lightProbability * static_cast<float>(lightSamples));
+            const glm::vec3 lightColor = ComputeLightContribution(lightIndex, intersection, intersectionPoint, fromCameraRay, objectMaterial, lightWeight, packetBatch, lane);
+            sampleColor += lightColor / (lightProbability * static_cast<float>(lightSamples));
         }
     }
     sampleColor += objectMaterial->ComputeNonLightDependentBRDF(this, intersection);
     return sampleColor;
 }
+
+glm::vec3 BackwardRenderer::ComputeLightContribution(size_t lightIndex, const IntersectionState& intersection, const glm::vec3& intersectionPoint, const Ray& fromCameraRay, const Material* objectMaterial, float lightWeight, PacketBatch* packetBatch, int lane) const
+{
+    const Light* light = storedScene->GetLightObject(lightIndex);
+    assert(light);
+
+    // Keyed on the camera sample rather than the shading point, so that the coordinates only repeat when the pixel, the
+    // sample index and the render seed all do.
+    const int initialSamples = light->GetMinSampleCount();
+    const int maxSamples = light->GetSampleCount();
+    std::array<glm::vec2, Light::MAX_SAMPLES> sampleCoordinates;
+    static_assert(Light::MAX_SAMPLES <= ShadingBatch::MAX_SAMPLES, "The samples of a light must fit into an empty batch.");
+    if (packetBatch && packetBatch->batch.totalSamples + maxSamples > ShadingBatch::MAX_SAMPLES) {
+        FlushPacketBatch(*packetBatch);
+    }
+    const int firstBatchedSample = packetBatch ? packetBatch->batch.totalSamples : 0;
+    Light::GenerateSampleCoordinates(ComputeLightSampleKey(intersection.sampleKey, lightIndex), maxSamples, sampleCoordinates.data(), initialSamples, storedSampler.get());
+
+    // Adaptively sampled lights start with a few samples and only take the rest in the penumbra, where those disagree
+    // about visibility.
+    const glm::vec3 normal = intersection.ComputeNormal();
+    glm::vec3 lightColor;
+    const int litSamples = AccumulateLightSamples(lightIndex, intersection, intersectionPoint, normal, fromCameraRay, objectMaterial, sampleCoordinates.data(), initialSamples, packetBatch, lane, lightColor);
+    int totalSamples = initialSamples;
+    if (initialSamples < maxSamples && litSamples > 0 && litSamples < initialSamples) {
+        DIAGNOSTICS_STAT(DiagnosticsType::PENUMBRA_REFINEMENTS);
+        AccumulateLightSamples(lightIndex, intersection, intersectionPoint, normal, fromCameraRay, objectMaterial, sampleCoordinates.data() + initialSamples, maxSamples - initialSamples, packetBatch, lane, lightColor);
+        totalSamples = maxSamples;
+    }
+
+    // The BRDF is linear in the light attenuation, so batched samples take the weights that are applied to lightColor here.
+    if (packetBatch) {
+        const float batchWeight = lightWeight / static_cast<float>(totalSamples);
+        for (int index = firstBatchedSample; index < packetBatch->batch.totalSamples; ++index) {
+            packetBatch->batch.attenuation[index] *= batchWeight;
+        }
+    }
+    return lightColor / static_cast<float>(totalSamples);
+}
+
+int BackwardRenderer::AccumulateLightSamples(size_t lightIndex, const IntersectionState& intersection, const glm::vec3& intersectionPoint, const glm::vec3& normal, const Ray& fromCameraRay, const Material* objectMaterial, const glm::vec2* sampleCoordinates, int sampleCount, PacketBatch* packetBatch, int lane, glm::vec3& lightColor) const
+{
+    const Light* light = storedScene->GetLightObject(lightIndex);
+    std::array<LightSample, Light::MAX_SAMPLES> samples;
+    light->ComputeSamples(intersectionPoint, normal, sampleCoordinates, sampleCount, samples.data());
+
+    int litSamples = 0;
+    for (int s = 0; s < sampleCount; ++s) {
+        if (samples[s].radiance == glm::vec3(0.f)) {
+            continue;
+        }
+
+        // note that max T is set to be right before the light.
+        DIAGNOSTICS_STAT(DiagnosticsType::LIGHT_SAMPLES);
+        Ray shadowRay = samples[s].CreateShadowRay(intersectionPoint, normal);
+        if (IsOccluded(lightIndex, shadowRay)) {
+            continue;
+        }
+        ++litSamples;
+
+        if (packetBatch) {
+            const glm::vec3 toCamera = -1.f * fromCameraRay.GetRayDirection();
+            const glm::vec2 uv = objectMaterial->GetCompiledMaterial().GetTexture(MaterialTextureSlot::DIFFUSE) ? intersection.ComputeUV() : glm::vec2();
+            const int index = packetBatch->batch.AddSample(normal, shadowRay.GetRayDirection(), toCamera, uv, samples[s].radiance, 1.f / samples[s].pdf);
+            packetBatch->sampleLanes[index] = lane;
+            continue;
+        }
+
+        // Note that the material should compute the parts of the lighting equation too.
+        const glm::vec3 brdfResponse = objectMaterial->ComputeBRDF(intersection, samples[s].radiance, shadowRay, fromCameraRay, 1.f / samples[s].pdf);
+        lightColor += brdfResponse;
+    }
+    return litSamples;
+}
+
+void BackwardRenderer::FlushPacketBatch(PacketBatch& packetBatch) const
+{
+    ShadingBatch& batch = packetBatch.batch;
+    if (batch.totalSamples == 0) {
+        return;
+    }
+
+    batch.PadToGroupOfFour();
+    packetBatch.material->GetBatchShader()->ComputeBRDFBatch(batch);
+    for (int index = 0; index < batch.totalSamples; ++index) {
+        packetBatch.colors[packetBatch.sampleLanes[index]] += batch.GetResponse(index);
+    }
+    batch.Clear();
+}
+
+void BackwardRenderer::SetLightSamples(int input)
+{
+    lightSamples = input;
+}
+
+int BackwardRenderer::GetLightSamples() const
+{
+    return lightSamples;
+}
+
+bool BackwardRenderer::SampleLight(const LightTree& lightTree, const IntersectionState& intersection, const glm::vec3& intersectionPoint, int sample, size_t& lightIndex, float& lightProbability)
+{
+    return lightTree.SampleLight(intersectionPoint, GenerateRandomNumber(intersection.intersectionRay, LIGHT_SELECTION_DIMENSION + static_cast<uint32_t>(sample)), lightIndex, lightProbability);
+}
+
+void BackwardRenderer::SetUseOccluderCache(bool input)
+{
+    useOccluderCache = input;
+}
+
+bool BackwardRenderer::IsOccluded(size_t lightIndex, Ray& shadowRay) const
+{
+    if (!useOccluderCache) {
+        return storedScene->Trace(&shadowRay, nullptr);
+    }
+
+    // Neighboring shading points tend to be shadowed by the same primitive, so the last occluder of each light is tested first.
+    // The cache belongs to the thread; the primitives stay alive for as long as the renderer holds on to the scene.
+    static thread_local uint64_t cacheOwner = 0;
+    static thread_local std::vector<CachedOccluder> cachedOccluders;
+    if (cacheOwner != rendererId) {
+        cacheOwner = rendererId;
+        cachedOccluders.clear();
+    }
+    if (cachedOccluders.size() <= lightIndex) {
+        cachedOccluders.resize(storedScene->GetTotalLights(), CachedOccluder{ nullptr, nullptr });
+    }
+
+    CachedOccluder& cached = cachedOccluders[lightIndex];
+    if (cached.primitive && cached.primitive->Trace(cached.primitiveParent, &shadowRay, nullptr)) {
+        DIAGNOSTICS_STAT(DiagnosticsType::OCCLUDER_CACHE_HITS);
+        return true;
+    }
+    DIAGNOSTICS_STAT(DiagnosticsType::OCCLUDER_CACHE_MISSES);
+
+    // Any occluder will do, so the traversal stops at the first hit and only records which primitive it was.
+    IntersectionState occluderIntersection;
+    if (!storedScene->TraceAnyHit(&shadowRay, occluderIntersection)) {
+        return false;
+    }
+    cached.primitive = occluderIntersection.intersectedPrimitive;
+    cached.primitiveParent = occluderIntersection.primitiveParent;
+    return true;
+}
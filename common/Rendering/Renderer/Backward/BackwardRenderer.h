@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/Rendering/Renderer.h"
+#include <atomic>
 
 class BackwardRenderer : public Renderer
 {
@@ -8,4 +9,49 @@ public:
     BackwardRenderer(std::shared_ptr<class Scene> scene, std::shared_ptr<class ColorSampler> sampler);
     virtual void InitializeRenderer() override;
     glm::vec3 ComputeSampleColor(const struct IntersectionState& intersection, const class Ray& fromCameraRay) const override;
-};
\ No newline at end of file
+    // The direct lighting of lanes whose material has a BatchShader is evaluated with BatchShader::ComputeBRDFBatch, for the
+    // light samples of consecutive lanes on the same material at once. Reflection and refraction rays are shaded one by one.
+    virtual void ComputeSampleColors(const struct IntersectionState* intersections, const class Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const override;
+
+    // 0 (the default) computes the contribution of every light at every shading point. Otherwise the given number of lights is
+    // picked from the scene's LightTree in proportion to their estimated contribution; lights that are not in the tree (such as
+    // directional lights) are always computed.
+    void SetLightSamples(int input);
+    int GetLightSamples() const;
+    // Picks the light of the given light sample at the hit from the tree, with the random number that ComputeSampleColor uses,
+    // so that engines which shade with this renderer's settings pick the same lights.
+    static bool SampleLight(const class LightTree& lightTree, const struct IntersectionState& intersection, const glm::vec3& intersectionPoint, int sample, size_t& lightIndex, float& lightProbability);
+
+    // When enabled, every thread remembers the last primitive that blocked each light and tests it before tracing the scene.
+    void SetUseOccluderCache(bool input);
+
+private:
+    // Light samples of the lanes of a packet that wait for the BatchShader of their material.
+    struct PacketBatch;
+
+    // Without a packetBatch, the light samples are shaded right away. Otherwise they are added to it, weighted by lightWeight
+    // (the factor the caller applies to the returned color), and only the color of the samples that were not batched is returned.
+    glm::vec3 ComputeHitColor(const struct IntersectionState& intersection, const class Ray& fromCameraRay, PacketBatch* packetBatch, int lane) const;
+    glm::vec3 ComputeLightContribution(size_t lightIndex, const struct IntersectionState& intersection, const glm::vec3& intersectionPoint, const class Ray& fromCameraRay, const class Material* objectMaterial, float lightWeight, PacketBatch* packetBatch, int lane) const;
+
+    // Adds the unoccluded samples of the light at the given coordinates to lightColor (or to packetBatch), each weighted by 1 / pdf.
+    // Returns how many of them reached the shading point.
+    int AccumulateLightSamples(size_t lightIndex, const struct IntersectionState& intersection, const glm::vec3& intersectionPoint, const glm::vec3& normal, const class Ray& fromCameraRay, const class Material* objectMaterial, const glm::vec2* sampleCoordinates, int sampleCount, PacketBatch* packetBatch, int lane, glm::vec3& lightColor) const;
+    void FlushPacketBatch(PacketBatch& packetBatch) const;
+
+    // Shadow test for a sample ray of the light with the given index.
+    bool IsOccluded(size_t lightIndex, class Ray& shadowRay) const;
+
+    struct CachedOccluder
+    {
+        const class PrimitiveBase* primitive;
+        const class SceneObject* primitiveParent;
+    };
+
+    int lightSamples;
+    bool useOccluderCache;
+
+    // Tells apart the occluder caches of different renderers (and thereby scenes) on the same thread.
+    static std::atomic<uint64_t> globalRendererCount;
+    uint64_t rendererId;
+};
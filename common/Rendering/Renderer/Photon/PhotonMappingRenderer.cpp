@@ -9,6 +9,7 @@
 #include "common/Scene/SceneObject.h"
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
 #include "common/Rendering/Material/Material.h"
+#include "common/Utility/Random/RandomStream.h"
 #include "glm/gtx/component_wise.hpp"
 
 #define VISUALIZE_PHOTON_MAPPING 1
@@ -18,7 +19,6 @@ PhotonMappingRenderer::PhotonMappingRenderer(std::shared_ptr<class Scene> scene,
     diffusePhotonNumber(1000000),
     maxPhotonBounces(1000)
 {
-    srand(static_cast<unsigned int>(time(NULL)));
 }
 
 void PhotonMappingRenderer::InitializeRenderer()
@@ -50,12 +50,20 @@ void PhotonMappingRenderer::GenericPhotonMapGeneration(PhotonKdtree& photonMap,
         const float proportion = glm::length(currentLight->GetLightColor()) / totalLightIntensity;
         const int totalPhotonsForLight = static_cast<const int>(proportion * totalPhotons);
         const glm::vec3 photonIntensity = currentLight->GetLightColor() / static_cast<float>(totalPhotonsForLight);
+        const uint32_t emissionKey = RandomStream::Hash(static_cast<uint32_t>(i));
         for (int j = 0; j < totalPhotonsForLight; ++j) {
+            // Every photon has its own stream, so the photon map is the same on every run.
+            RandomStream random(RandomStream::Hash(static_cast<uint32_t>(i), static_cast<uint32_t>(j)));
             Ray photonRay;
             std::vector<char> path;
             path.push_back('L');
-            currentLight->GenerateRandomPhotonRay(photonRay);
-            TracePhoton(photonMap, &photonRay, photonIntensity, path, 1.f, maxPhotonBounces);
+            // Samplers with a sequence of their own stratify the emission of each light over its photons.
+            glm::vec3 emissionSample;
+            if (!storedSampler || !storedSampler->ComputeSequenceSample(emissionKey, static_cast<uint32_t>(j), emissionSample) ||
+                !currentLight->GeneratePhotonRay(photonRay, glm::vec2(emissionSample))) {
+                currentLight->GenerateRandomPhotonRay(photonRay, random);
+            }
+            TracePhoton(photonMap, &photonRay, photonIntensity, path, 1.f, maxPhotonBounces, random);
         }
     }
 }
@@ -66,10 +74,6 @@ float max3 (glm::vec3 v) {
     return std::max (std::max (v.x, v.y), v.z);
 }
 
-float rand01() {
-    return ((float)rand() ) / (((float) RAND_MAX) + 1.f);
-}
-
 glm::vec3 get_tangent(glm::vec3 normal) {
     glm::vec3 e = glm::vec3(1.f, 0.f, 0.f);
     if (glm::dot(normal, e) > 0.8f || glm::dot(normal, e) < -0.8f) {
@@ -89,7 +93,7 @@ glm::vec3 get_absolute_bounce_direction(glm::vec3 r, glm::vec3 n, glm::vec3 t, g
 
 // END
 
-void PhotonMappingRenderer::TracePhoton(PhotonKdtree& photonMap, Ray* photonRay, glm::vec3 lightIntensity, std::vector<char>& path, float currentIOR, int remainingBounces)
+void PhotonMappingRenderer::TracePhoton(PhotonKdtree& photonMap, Ray* photonRay, glm::vec3 lightIntensity, std::vector<char>& path, float currentIOR, int remainingBounces, RandomStream& random)
 {
     /*
      * Assignment 8 TODO: Trace a photon into the scene and make it bounce.
@@ -132,7 +136,7 @@ void PhotonMappingRenderer::TracePhoton(PhotonKdtree& photonMap, Ray* photonRay,
     // determine if bounced or absorbed
     glm::vec3 diffuseReflection = hitMaterial->GetBaseDiffuseReflection();
     float p_r = max3(diffuseReflection);
-    float rand_p_r = rand01();
+    float rand_p_r = random.Next();
     // std::printf("Then random number is %f and p_r is %f \n", rand_p_r, p_r);
     
     if (rand_p_r > p_r) { return; }
@@ -140,8 +144,8 @@ void PhotonMappingRenderer::TracePhoton(PhotonKdtree& photonMap, Ray* photonRay,
     // now it should be bounced and TracePhoton should be called recursively
     
     // 1st step, generate a random direction in hemisphere (relative)
-    float u1 = rand01();
-    float u2 = rand01();
+    float u1 = random.Next();
+    float u2 = random.Next();
     
     float bounce_r = pow(u1, 0.5f);
     float bounce_theta = 2.f * PI * u2;
@@ -172,7 +176,12 @@ void PhotonMappingRenderer::TracePhoton(PhotonKdtree& photonMap, Ray* photonRay,
     photonRay->SetRayPosition(newRayPosition);
     
     // recursive call
-    TracePhoton(photonMap, photonRay, lightIntensity, path, currentIOR, remainingBounces - 1);
+    TracePhoton(photonMap, photonRay, lightIntensity, path, currentIOR, remainingBounces - 1, random);
+}
+
+void PhotonMappingRenderer::ComputeSampleColors(const IntersectionState* intersections, const Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const
+{
+    Renderer::ComputeSampleColors(intersections, fromCameraRays, hitMask, totalLanes, colors);
 }
 
 glm::vec3 PhotonMappingRenderer::ComputeSampleColor(const struct IntersectionState& intersection, const class Ray& fromCameraRay) const
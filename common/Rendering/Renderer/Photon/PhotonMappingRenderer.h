@@ -13,6 +13,8 @@ public:
     PhotonMappingRenderer(std::shared_ptr<class Scene> scene, std::shared_ptr<class ColorSampler> sampler);
     virtual void InitializeRenderer() override;
     glm::vec3 ComputeSampleColor(const struct IntersectionState& intersection, const class Ray& fromCameraRay) const override;
+    // Shades lane by lane so that packets see the photons too.
+    virtual void ComputeSampleColors(const struct IntersectionState* intersections, const class Ray* fromCameraRays, uint64_t hitMask, int totalLanes, glm::vec3* colors) const override;
 
     void SetNumberOfDiffusePhotons(int diffuse);
 private:
@@ -23,5 +25,5 @@ private:
     int maxPhotonBounces;
 
     void GenericPhotonMapGeneration(PhotonKdtree& photonMap, int totalPhotons);
-    void TracePhoton(PhotonKdtree& photonMap, Ray* photonRay, glm::vec3 lightIntensity, std::vector<char>& path, float currentIOR, int remainingBounces);
+    void TracePhoton(PhotonKdtree& photonMap, Ray* photonRay, glm::vec3 lightIntensity, std::vector<char>& path, float currentIOR, int remainingBounces, class RandomStream& random);
 };
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "common/Rendering/Reservoir/ReservoirEngine.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Lights/Light.h"
+#include "common/Scene/Lights/Tree/LightTree.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Output/ImageWriter.h"
+#include "common/Utility/Threading/ParallelFor.h"
+#include "common/Utility/Random/RandomStream.h"
+#include "common/Utility/Color/Luminance.h"
+
+namespace
+{
+const size_t PIXEL_GRAIN_SIZE = 256;
+
+// History reservoirs are clamped to this many times the initial candidates so that stale samples cannot dominate forever.
+const float MAXIMUM_HISTORY_CANDIDATES = 20.f;
+
+const float SIMILAR_NORMAL_COSINE = 0.9f;
+const float SIMILAR_DEPTH_RATIO = 0.1f;
+
+// Every stage of a pass draws from its own stream per pixel.
+enum RandomStage : uint32_t
+{
+    CAMERA_RANDOM_STAGE,
+    CANDIDATE_RANDOM_STAGE,
+    TEMPORAL_RANDOM_STAGE,
+    SPATIAL_RANDOM_STAGE,
+    SHADING_RANDOM_STAGE
+};
+}
+
+ReservoirEngine::ReservoirEngine(std::shared_ptr<Scene> inputScene, std::shared_ptr<Camera> inputCamera, std::shared_ptr<Renderer> inputRenderer):
+    scene(std::move(inputScene)), camera(std::move(inputCamera)), renderer(std::move(inputRenderer)), maxReflectionBounces(0), maxRefractionBounces(0), passesPerFrame(1),
+    initialCandidates(32), spatialNeighbors(5), spatialRadius(30.f), useTemporalReuse(true), threadCount(0), renderedPasses(0), historyResolution(0)
+{
+}
+
+void ReservoirEngine::SetMaxBounces(int reflectionBounces, int refractionBounces)
+{
+    maxReflectionBounces = reflectionBounces;
+    maxRefractionBounces = refractionBounces;
+}
+
+void ReservoirEngine::SetPassesPerFrame(int input)
+{
+    passesPerFrame = std::max(input, 1);
+}
+
+void ReservoirEngine::SetInitialCandidates(int input)
+{
+    initialCandidates = std::max(input, 1);
+}
+
+void ReservoirEngine::SetSpatialReuse(int neighbors, float radiusInPixels)
+{
+    spatialNeighbors = std::max(neighbors, 0);
+    spatialRadius = std::max(radiusInPixels, 1.f);
+}
+
+void ReservoirEngine::SetTemporalReuse(bool input)
+{
+    useTemporalReuse = input;
+}
+
+void ReservoirEngine::SetThreadCount(int input)
+{
+    threadCount = input;
+}
+
+void ReservoirEngine::ResetHistory()
+{
+    previousHits.clear();
+    previousReservoirs.clear();
+}
+
+void ReservoirEngine::Render(ImageWriter& imageWriter, glm::ivec2 resolution)
+{
+    assert(scene && camera && renderer);
+    const size_t totalPixels = static_cast<size_t>(resolution.x * resolution.y);
+    if (historyResolution != resolution) {
+        ResetHistory();
+        historyResolution = resolution;
+    }
+
+    std::vector<PixelHit> hits(totalPixels);
+    std::vector<Reservoir> reservoirs(totalPixels);
+    std::vector<Reservoir> spatialReservoirs(totalPixels);
+    std::vector<glm::vec3> passColors(totalPixels);
+    std::vector<glm::vec3> accumulatedColors(totalPixels);
+
+    for (int pass = 0; pass < passesPerFrame; ++pass) {
+        TraceCameraRays(hits, resolution);
+        SampleInitialCandidates(hits, reservoirs);
+        if (useTemporalReuse && previousHits.size() == totalPixels) {
+            ReuseTemporally(hits, reservoirs);
+        }
+        if (spatialNeighbors > 0) {
+            ReuseSpatially(hits, resolution, reservoirs, spatialReservoirs);
+            reservoirs.swap(spatialReservoirs);
+        }
+        ShadePixels(hits, reservoirs, passColors);
+
+        for (size_t i = 0; i < totalPixels; ++i) {
+            accumulatedColors[i] += passColors[i];
+        }
+        previousHits.swap(hits);
+        previousReservoirs.swap(reservoirs);
+        hits.resize(totalPixels);
+        reservoirs.resize(totalPixels);
+        ++renderedPasses;
+    }
+
+    for (size_t i = 0; i < totalPixels; ++i) {
+        imageWriter.SetPixelColor(accumulatedColors[i] / static_cast<float>(passesPerFrame), static_cast<int>(i % resolution.x), static_cast<int>(i / resolution.x));
+    }
+}
+
+void ReservoirEngine::TraceCameraRays(std::vector<PixelHit>& hits, glm::ivec2 resolution) const
+{
+    const glm::vec2 floatResolution(resolution);
+    ParallelFor(hits.size(), PIXEL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t sampleKey = RandomStream::Hash(renderedPasses, static_cast<uint32_t>(i), CAMERA_RANDOM_STAGE);
+            RandomStream random(sampleKey);
+            const glm::vec3 sample(random.Next(), random.Next(), 0.f);
+            const glm::vec2 normalizedCoordinates = Camera::ComputeNormalizedSampleCoordinates(static_cast<int>(i % resolution.x), static_cast<int>(i / resolution.x), sample, passesPerFrame, floatResolution);
+
+            PixelHit& hit = hits[i];
+            hit.cameraRay = camera->GenerateRay(normalizedCoordinates);
+            hit.intersection = IntersectionState(maxReflectionBounces, maxRefractionBounces);
+            hit.intersection.sampleKey = sampleKey;
+            hit.hasHit = scene->Trace(&hit.cameraRay, &hit.intersection);
+            if (!hit.hasHit) {
+                continue;
+            }
+            hit.position = hit.intersection.intersectionRay.GetRayPosition(hit.intersection.intersectionT);
+            hit.normal = hit.intersection.ComputeNormal();
+            hit.material = hit.intersection.intersectedPrimitive->GetParentMeshObject()->GetMaterial();
+            assert(hit.material);
+        }
+    }, threadCount);
+}
+
+void ReservoirEngine::SampleInitialCandidates(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs) const
+{
+    const LightTree* lightTree = scene->GetLightTree();
+    ParallelFor(hits.size(), PIXEL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Reservoir& reservoir = reservoirs[i];
+            reservoir = Reservoir();
+            if (!hits[i].hasHit || !lightTree) {
+                continue;
+            }
+
+            // Candidates are weighted by their unshadowed contribution over the probability of having picked them.
+            RandomStream random(RandomStream::Hash(renderedPasses, static_cast<uint32_t>(i), CANDIDATE_RANDOM_STAGE));
+            for (int c = 0; c < initialCandidates; ++c) {
+                size_t lightIndex;
+                float lightProbability;
+                if (!lightTree->SampleLight(hits[i].position, random.Next(), lightIndex, lightProbability)) {
+                    reservoir.candidateCount = static_cast<float>(initialCandidates);
+                    break;
+                }
+
+                const glm::vec2 lightSample(random.Next(), random.Next());
+                const float targetFunction = ComputeLuminance(ComputeSampleContribution(hits[i], static_cast<int>(lightIndex), lightSample));
+                UpdateReservoir(reservoir, static_cast<int>(lightIndex), lightSample, targetFunction, targetFunction / lightProbability, 1.f, random.Next());
+            }
+            FinalizeReservoir(reservoir);
+        }
+    }, threadCount);
+}
+
+void ReservoirEngine::ReuseTemporally(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs) const
+{
+    const float maximumCandidates = MAXIMUM_HISTORY_CANDIDATES * static_cast<float>(initialCandidates);
+    ParallelFor(hits.size(), PIXEL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Reservoir& history = previousReservoirs[i];
+            if (!hits[i].hasHit || !previousHits[i].hasHit || history.lightIndex < 0 || !AreHitsSimilar(hits[i], previousHits[i])) {
+                continue;
+            }
+
+            const float historyCandidates = std::min(history.candidateCount, maximumCandidates);
+            RandomStream random(RandomStream::Hash(renderedPasses, static_cast<uint32_t>(i), TEMPORAL_RANDOM_STAGE));
+            const float targetFunction = ComputeLuminance(ComputeSampleContribution(hits[i], history.lightIndex, history.lightSample));
+            UpdateReservoir(reservoirs[i], history.lightIndex, history.lightSample, targetFunction, targetFunction * history.contributionWeight * historyCandidates, historyCandidates, random.Next());
+            FinalizeReservoir(reservoirs[i]);
+        }
+    }, threadCount);
+}
+
+void ReservoirEngine::ReuseSpatially(const std::vector<PixelHit>& hits, glm::ivec2 resolution, const std::vector<Reservoir>& reservoirs, std::vector<Reservoir>& outputReservoirs) const
+{
+    ParallelFor(hits.size(), PIXEL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Reservoir& reservoir = outputReservoirs[i];
+            reservoir = reservoirs[i];
+            if (!hits[i].hasHit) {
+                continue;
+            }
+
+            const glm::ivec2 pixel(static_cast<int>(i % resolution.x), static_cast<int>(i / resolution.x));
+            RandomStream random(RandomStream::Hash(renderedPasses, static_cast<uint32_t>(i), SPATIAL_RANDOM_STAGE));
+            for (int n = 0; n < spatialNeighbors; ++n) {
+                // Uniform point in the disk around the pixel.
+                const float radius = spatialRadius * std::sqrt(random.Next());
+                const float angle = 2.f * PI * random.Next();
+                const glm::ivec2 neighborPixel = glm::clamp(pixel + glm::ivec2(glm::round(radius * glm::vec2(std::cos(angle), std::sin(angle)))), glm::ivec2(0), resolution - 1);
+                const size_t neighbor = static_cast<size_t>(neighborPixel.y * resolution.x + neighborPixel.x);
+                if (neighbor == i || !hits[neighbor].hasHit || !AreHitsSimilar(hits[i], hits[neighbor])) {
+                    continue;
+                }
+
+                const Reservoir& neighborReservoir = reservoirs[neighbor];
+                const float targetFunction = (neighborReservoir.lightIndex >= 0) ? ComputeLuminance(ComputeSampleContribution(hits[i], neighborReservoir.lightIndex, neighborReservoir.lightSample)) : 0.f;
+                UpdateReservoir(reservoir, neighborReservoir.lightIndex, neighborReservoir.lightSample, targetFunction, targetFunction * neighborReservoir.contributionWeight * neighborReservoir.candidateCount, neighborReservoir.candidateCount, random.Next());
+            }
+            FinalizeReservoir(reservoir);
+        }
+    }, threadCount);
+}
+
+void ReservoirEngine::ShadePixels(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs, std::vector<glm::vec3>& pixelColors) const
+{
+    const LightTree* lightTree = scene->GetLightTree();
+    ParallelFor(hits.size(), PIXEL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pixelColors[i] = glm::vec3();
+            const PixelHit& hit = hits[i];
+            if (!hit.hasHit) {
+                continue;
+            }
+
+            RandomStream random(RandomStream::Hash(renderedPasses, static_cast<uint32_t>(i), SHADING_RANDOM_STAGE));
+            Reservoir& reservoir = reservoirs[i];
+            if (reservoir.lightIndex >= 0 && reservoir.contributionWeight > 0.f) {
+                const Light* light = scene->GetLightObject(static_cast<size_t>(reservoir.lightIndex));
+                Ray shadowRay = light->ComputeSampleRay(hit.position, hit.normal, reservoir.lightSample);
+                if (scene->Trace(&shadowRay, nullptr)) {
+                    // Occluded samples are not worth passing on to the next pass.
+                    reservoir.contributionWeight = 0.f;
+                } else {
+                    const glm::vec3 brdfResponse = hit.material->ComputeBRDF(hit.intersection, light->GetLightColor(), shadowRay, hit.cameraRay, light->ComputeSampleAttenuation(hit.position));
+                    pixelColors[i] += brdfResponse * reservoir.contributionWeight;
+                }
+            }
+
+            if (lightTree) {
+                const std::vector<size_t>& infiniteLights = lightTree->GetInfiniteLights();
+                for (size_t l = 0; l < infiniteLights.size(); ++l) {
+                    const Light* light = scene->GetLightObject(infiniteLights[l]);
+                    Ray shadowRay = light->ComputeSampleRay(hit.position, hit.normal, glm::vec2(random.Next(), random.Next()));
+                    if (!scene->Trace(&shadowRay, nullptr)) {
+                        pixelColors[i] += hit.material->ComputeBRDF(hit.intersection, light->GetLightColor(), shadowRay, hit.cameraRay, light->ComputeSampleAttenuation(hit.position));
+                    }
+                }
+            }
+
+            pixelColors[i] += hit.material->ComputeNonLightDependentBRDF(renderer.get(), hit.intersection);
+        }
+    }, threadCount);
+}
+
+glm::vec3 ReservoirEngine::ComputeSampleContribution(const PixelHit& hit, int lightIndex, const glm::vec2& lightSample) const
+{
+    const Light* light = scene->GetLightObject(static_cast<size_t>(lightIndex));
+    assert(light);
+    const Ray toLightRay = light->ComputeSampleRay(hit.position, hit.normal, lightSample);
+    return hit.material->ComputeBRDF(hit.intersection, light->GetLightColor(), toLightRay, hit.cameraRay, light->ComputeSampleAttenuation(hit.position));
+}
+
+bool ReservoirEngine::UpdateReservoir(Reservoir& reservoir, int lightIndex, const glm::vec2& lightSample, float targetFunction, float weight, float candidateCount, float u)
+{
+    reservoir.weightSum += weight;
+    reservoir.candidateCount += candidateCount;
+    if (weight <= 0.f || u * reservoir.weightSum >= weight) {
+        return false;
+    }
+    reservoir.lightIndex = lightIndex;
+    reservoir.lightSample = lightSample;
+    reservoir.targetFunction = targetFunction;
+    return true;
+}
+
+void ReservoirEngine::FinalizeReservoir(Reservoir& reservoir)
+{
+    const float denominator = reservoir.candidateCount * reservoir.targetFunction;
+    reservoir.contributionWeight = (denominator > 0.f) ? reservoir.weightSum / denominator : 0.f;
+}
+
+bool ReservoirEngine::AreHitsSimilar(const PixelHit& a, const PixelHit& b)
+{
+    if (glm::dot(a.normal, b.normal) < SIMILAR_NORMAL_COSINE) {
+        return false;
+    }
+    const float depthA = a.intersection.intersectionT;
+    const float depthB = b.intersection.intersectionT;
+    return std::abs(depthA - depthB) <= SIMILAR_DEPTH_RATIO * std::max(depthA, depthB);
+}
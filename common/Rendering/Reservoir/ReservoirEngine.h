@@ -0,0 +1,101 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Intersection/IntersectionState.h"
+
+// Direct lighting through spatiotemporal reservoir resampling (ReSTIR). Every pass traces one camera ray per pixel and
+//   1. streams a number of cheap light candidates, picked from the scene's LightTree, through a weighted reservoir that keeps
+//      one of them in proportion to its unshadowed contribution,
+//   2. merges the reservoir the pixel ended the previous pass (or frame) with, if the surface still looks the same,
+//   3. merges the reservoirs of a few random neighbor pixels that see a similar surface,
+//   4. traces a single shadow ray towards the light sample that survived and weights it by the reservoir.
+// Each pixel thereby profits from hundreds of candidates while tracing one shadow ray per pass for the lights in the tree.
+// Lights that are not in the tree (directional lights) get one shadow ray each, and reflection/refraction/ambient comes from
+// Material::ComputeNonLightDependentBRDF through the renderer.
+//
+// Neighbors are merged without tracing their visibility at this pixel, which is the usual biased variant: it darkens contact
+// shadows slightly in exchange for far less noise. Temporal reuse compares each pixel with the same pixel of the last pass, so
+// it assumes a camera that moves little between frames; call ResetHistory on cuts.
+class ReservoirEngine
+{
+public:
+    ReservoirEngine(std::shared_ptr<class Scene> inputScene, std::shared_ptr<class Camera> inputCamera, std::shared_ptr<class Renderer> inputRenderer);
+
+    void SetMaxBounces(int reflectionBounces, int refractionBounces);
+    // The image is the average of this many passes.
+    void SetPassesPerFrame(int input);
+    void SetInitialCandidates(int input);
+    void SetSpatialReuse(int neighbors, float radiusInPixels);
+    void SetTemporalReuse(bool input);
+    // 0 uses every hardware thread.
+    void SetThreadCount(int input);
+
+    // The scene must be finalized. The reservoirs of the last pass are kept for the next call, so consecutive frames of a
+    // sequence keep improving on each other.
+    void Render(class ImageWriter& imageWriter, glm::ivec2 resolution);
+    void ResetHistory();
+
+private:
+    struct Reservoir
+    {
+        Reservoir() :
+            lightIndex(-1), lightSample(0.f), targetFunction(0.f), weightSum(0.f), candidateCount(0.f), contributionWeight(0.f)
+        {
+        }
+
+        // Light sample that was kept: the light and the point on it (see Light::ComputeSampleRay).
+        int lightIndex;
+        glm::vec2 lightSample;
+        // Unshadowed luminance of the kept sample at the pixel that owns the reservoir.
+        float targetFunction;
+        float weightSum;
+        float candidateCount;
+        // Factor that turns the kept sample's contribution into an estimate of the light from all lights.
+        float contributionWeight;
+    };
+
+    struct PixelHit
+    {
+        IntersectionState intersection;
+        Ray cameraRay;
+        bool hasHit;
+        glm::vec3 position;
+        glm::vec3 normal;
+        const class Material* material;
+    };
+
+    void TraceCameraRays(std::vector<PixelHit>& hits, glm::ivec2 resolution) const;
+    void SampleInitialCandidates(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs) const;
+    void ReuseTemporally(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs) const;
+    void ReuseSpatially(const std::vector<PixelHit>& hits, glm::ivec2 resolution, const std::vector<Reservoir>& reservoirs, std::vector<Reservoir>& outputReservoirs) const;
+    void ShadePixels(const std::vector<PixelHit>& hits, std::vector<Reservoir>& reservoirs, std::vector<glm::vec3>& pixelColors) const;
+
+    // Unshadowed contribution of the light sample to the hit.
+    glm::vec3 ComputeSampleContribution(const PixelHit& hit, int lightIndex, const glm::vec2& lightSample) const;
+    static bool UpdateReservoir(Reservoir& reservoir, int lightIndex, const glm::vec2& lightSample, float targetFunction, float weight, float candidateCount, float u);
+    static void FinalizeReservoir(Reservoir& reservoir);
+    // Surfaces with similar normals and depth are assumed to see the same lights.
+    static bool AreHitsSimilar(const PixelHit& a, const PixelHit& b);
+
+    std::shared_ptr<class Scene> scene;
+    std::shared_ptr<class Camera> camera;
+    std::shared_ptr<class Renderer> renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    int passesPerFrame;
+    int initialCandidates;
+    int spatialNeighbors;
+    float spatialRadius;
+    bool useTemporalReuse;
+    int threadCount;
+
+    // Passes rendered since construction; with the pixel and the stage it keys the random numbers of a pass.
+    uint32_t renderedPasses;
+
+    // State of the last pass for temporal reuse.
+    glm::ivec2 historyResolution;
+    std::vector<PixelHit> previousHits;
+    std::vector<Reservoir> previousReservoirs;
+};
@@ -6,4 +6,14 @@ Texture::Texture()
 
 Texture::~Texture()
 {
+}
+
+void Texture::SampleBatch(const float* u, const float* v, int count, float* r, float* g, float* b) const
+{
+    for (int i = 0; i < count; ++i) {
+        const glm::vec4 texel = Sample(glm::vec2(u[i], v[i]));
+        r[i] = texel.r;
+        g[i] = texel.g;
+        b[i] = texel.b;
+    }
 }
\ No newline at end of file
@@ -10,4 +10,8 @@ public:
 
     virtual glm::vec4 Sample(const glm::vec2& coord) const = 0;
     virtual glm::vec4 Sample(const glm::vec3& coord) const = 0;
+
+    // Writes the RGB of Sample(glm::vec2(u[i], v[i])) for count coordinates. Textures that can fetch several texels at
+    // once override it; the default samples one coordinate at a time.
+    virtual void SampleBatch(const float* u, const float* v, int count, float* r, float* g, float* b) const;
 };
@@ -1,5 +1,24 @@
 #include "common/Rendering/Textures/Texture2D.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_BATCH_USE_SSE 1
+#else
+#define TEXTURE_BATCH_USE_SSE 0
+#endif
+
+#if TEXTURE_BATCH_USE_SSE
+namespace
+{
+// SSE2 has no floor; truncate and step down where truncation rounded a negative value up.
+__m128 FloorPs(__m128 value)
+{
+    const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.f)));
+}
+}
+#endif
+
 Texture2D::Texture2D(unsigned char* rawData, int width, int height):
     Texture(), textureData(rawData), texWidth(width), texHeight(height)
 {
@@ -28,6 +47,60 @@ glm::vec4 Texture2D::Sample(const glm::vec2& coord) const
     return (ceilVec.y - imageSpaceCoordinates.y) * fx1 + (imageSpaceCoordinates.y - floorVec.y) * fx2;
 }
 
+void Texture2D::SampleBatch(const float* u, const float* v, int count, float* r, float* g, float* b) const
+{
+    int base = 0;
+#if TEXTURE_BATCH_USE_SSE
+    // Coordinates and weights are computed 4 at a time; SSE has no gather, so the 16 texels are fetched one by one into
+    // per-corner arrays and blended together again.
+    const __m128 width = _mm_set1_ps(static_cast<float>(texWidth));
+    const __m128 height = _mm_set1_ps(static_cast<float>(texHeight));
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 inverse255 = _mm_set1_ps(1.f / 255.f);
+    for (; base + 4 <= count; base += 4) {
+        const __m128 imageX = _mm_mul_ps(_mm_loadu_ps(u + base), width);
+        const __m128 imageY = _mm_mul_ps(_mm_loadu_ps(v + base), height);
+        const __m128 floorX = FloorPs(imageX);
+        const __m128 floorY = FloorPs(imageY);
+
+        alignas(16) int pixelX[4];
+        alignas(16) int pixelY[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(pixelX), _mm_cvttps_epi32(floorX));
+        _mm_store_si128(reinterpret_cast<__m128i*>(pixelY), _mm_cvttps_epi32(floorY));
+
+        // texels[corner][channel][lane]; corners in the order q11, q21, q12, q22 of Sample.
+        alignas(16) float texels[4][3][4];
+        for (int lane = 0; lane < 4; ++lane) {
+            for (int corner = 0; corner < 4; ++corner) {
+                const glm::ivec2 pixel(pixelX[lane] + (corner & 1), pixelY[lane] + (corner >> 1));
+                const int index = ComputeLinearIndex(HandleBorderCondition(pixel));
+                texels[corner][0][lane] = textureData[index];
+                texels[corner][1][lane] = textureData[index + 1];
+                texels[corner][2][lane] = textureData[index + 2];
+            }
+        }
+
+        const __m128 ceilWeightX = _mm_sub_ps(_mm_add_ps(floorX, one), imageX);
+        const __m128 floorWeightX = _mm_sub_ps(imageX, floorX);
+        const __m128 ceilWeightY = _mm_sub_ps(_mm_add_ps(floorY, one), imageY);
+        const __m128 floorWeightY = _mm_sub_ps(imageY, floorY);
+        float* outputs[3] = { r + base, g + base, b + base };
+        for (int channel = 0; channel < 3; ++channel) {
+            const __m128 fx1 = _mm_add_ps(_mm_mul_ps(ceilWeightX, _mm_load_ps(texels[0][channel])), _mm_mul_ps(floorWeightX, _mm_load_ps(texels[1][channel])));
+            const __m128 fx2 = _mm_add_ps(_mm_mul_ps(ceilWeightX, _mm_load_ps(texels[2][channel])), _mm_mul_ps(floorWeightX, _mm_load_ps(texels[3][channel])));
+            const __m128 result = _mm_add_ps(_mm_mul_ps(ceilWeightY, fx1), _mm_mul_ps(floorWeightY, fx2));
+            _mm_storeu_ps(outputs[channel], _mm_mul_ps(result, inverse255));
+        }
+    }
+#endif
+    for (; base < count; ++base) {
+        const glm::vec4 texel = Sample(glm::vec2(u[base], v[base]));
+        r[base] = texel.r;
+        g[base] = texel.g;
+        b[base] = texel.b;
+    }
+}
+
 glm::ivec2 Texture2D::HandleBorderCondition(const glm::ivec2& coord) const
 {
     // By default, do repeat across borders
@@ -10,6 +10,7 @@ public:
 
     virtual glm::vec4 Sample(const glm::vec2& coord) const override;
     virtual glm::vec4 Sample(const glm::vec3& coord) const override;
+    virtual void SampleBatch(const float* u, const float* v, int count, float* r, float* g, float* b) const override;
 private:
     glm::vec4 InternalSample(const glm::ivec2& coord) const;
     glm::ivec2 HandleBorderCondition(const glm::ivec2& coord) const;
@@ -0,0 +1,435 @@
+#include "common/Rendering/Wavefront/WavefrontEngine.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Renderer.h"
+#include "common/Rendering/Renderer/Backward/BackwardRenderer.h"
+#include "common/Scene/Scene.h"
+#include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Camera/CameraRayBatch.h"
+#include "common/Scene/Lights/Light.h"
+#include "common/Scene/Lights/Tree/LightTree.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Output/ImageWriter.h"
+#include "common/Utility/Threading/ParallelFor.h"
+
+namespace
+{
+// Work items per ParallelFor range for the stages that do not trace packets.
+const size_t STAGE_GRAIN_SIZE = 256;
+
+// Spreads the lower 10 bits of value so that there are two zero bits between each of them.
+uint64_t SpreadBits(uint64_t value)
+{
+    value &= 0x3ff;
+    value = (value | (value << 16)) & 0x30000ff;
+    value = (value | (value << 8)) & 0x300f00f;
+    value = (value | (value << 4)) & 0x30c30c3;
+    value = (value | (value << 2)) & 0x9249249;
+    return value;
+}
+
+uint64_t Morton3D(const glm::vec3& normalized, float cellsPerAxis)
+{
+    const glm::vec3 cell = glm::clamp(normalized * cellsPerAxis, glm::vec3(0.f), glm::vec3(cellsPerAxis - 1.f));
+    return SpreadBits(static_cast<uint64_t>(cell.x)) | (SpreadBits(static_cast<uint64_t>(cell.y)) << 1) | (SpreadBits(static_cast<uint64_t>(cell.z)) << 2);
+}
+}
+
+WavefrontEngine::WavefrontEngine(std::shared_ptr<Scene> inputScene, std::shared_ptr<Camera> inputCamera, std::shared_ptr<ColorSampler> inputSampler, std::shared_ptr<Renderer> inputRenderer):
+    scene(std::move(inputScene)), camera(std::move(inputCamera)), sampler(std::move(inputSampler)), renderer(std::move(inputRenderer)), maxReflectionBounces(0), maxRefractionBounces(0), samplesPerPixel(1), waveSize(1 << 18), threadCount(0)
+{
+}
+
+void WavefrontEngine::SetMaxBounces(int reflectionBounces, int refractionBounces)
+{
+    maxReflectionBounces = reflectionBounces;
+    maxRefractionBounces = refractionBounces;
+}
+
+void WavefrontEngine::SetSamplesPerPixel(int input)
+{
+    samplesPerPixel = std::max(input, 1);
+}
+
+void WavefrontEngine::SetWaveSize(int input)
+{
+    waveSize = std::max(input, 1);
+}
+
+void WavefrontEngine::SetThreadCount(int input)
+{
+    threadCount = input;
+}
+
+void WavefrontEngine::Render(ImageWriter& imageWriter, glm::ivec2 resolution) const
+{
+    assert(scene && camera && sampler && renderer);
+    const int totalPixels = resolution.x * resolution.y;
+    const glm::vec2 floatResolution(resolution);
+
+    std::vector<std::unique_ptr<SamplerState>> pixelStates;
+    std::vector<int> pendingPixels;
+    std::vector<int> nextPendingPixels;
+    std::vector<QueuedRay> rayQueue;
+    std::vector<glm::vec3> sampleColors;
+
+    for (int waveStart = 0; waveStart < totalPixels; waveStart += waveSize) {
+        const int wavePixels = std::min(waveSize, totalPixels - waveStart);
+
+        pixelStates.resize(wavePixels);
+        pendingPixels.resize(wavePixels);
+        for (int i = 0; i < wavePixels; ++i) {
+            const glm::ivec2 pixel((waveStart + i) % resolution.x, (waveStart + i) / resolution.x);
+            pixelStates[i] = sampler->CreateSampler(sampler->ComputePixelSeed(pixel), samplesPerPixel, 2);
+            pixelStates[i]->pixel = pixel;
+            pendingPixels[i] = i;
+        }
+
+        // One sample for every pixel that still wants one per round, so adaptive samplers keep working.
+        while (!pendingPixels.empty()) {
+            rayQueue.resize(pendingPixels.size());
+            ParallelFor(pendingPixels.size(), STAGE_GRAIN_SIZE, [&](size_t begin, size_t end) {
+                std::array<glm::vec2, CameraRayBatch::MAX_RAYS> coordinates;
+                std::array<uint32_t, CameraRayBatch::MAX_RAYS> sampleKeys;
+                CameraRayBatch cameraRays;
+                for (size_t batchStart = begin; batchStart < end; batchStart += CameraRayBatch::MAX_RAYS) {
+                    const int batchSize = static_cast<int>(std::min<size_t>(CameraRayBatch::MAX_RAYS, end - batchStart));
+                    for (int b = 0; b < batchSize; ++b) {
+                        const int pixel = waveStart + pendingPixels[batchStart + b];
+                        SamplerState& state = *pixelStates[pendingPixels[batchStart + b]].get();
+                        const glm::vec3 sample = sampler->ComputeSampleCoordinate(state);
+                        sampleKeys[b] = ColorSampler::ComputeSampleKey(state.seed, state.samplesComputed);
+                        coordinates[b] = Camera::ComputeNormalizedSampleCoordinates(pixel % resolution.x, pixel / resolution.x, sample, samplesPerPixel, floatResolution);
+                    }
+                    camera->GenerateRays(coordinates.data(), batchSize, cameraRays);
+
+                    for (int b = 0; b < batchSize; ++b) {
+                        QueuedRay& cameraRay = rayQueue[batchStart + b];
+                        cameraRay.ray = cameraRays.GetRay(b);
+                        cameraRay.throughput = glm::vec3(1.f);
+                        cameraRay.pixel = static_cast<int>(batchStart + b);
+                        cameraRay.sampleKey = sampleKeys[b];
+                        cameraRay.remainingReflectionBounces = maxReflectionBounces;
+                        cameraRay.remainingRefractionBounces = maxRefractionBounces;
+                        cameraRay.currentIOR = 1.f;
+                    }
+                }
+            }, threadCount);
+
+            sampleColors.assign(pendingPixels.size(), glm::vec3());
+            TraceWave(rayQueue, sampleColors);
+
+            nextPendingPixels.clear();
+            for (size_t i = 0; i < pendingPixels.size(); ++i) {
+                if (sampler->RecordColorSample(*pixelStates[pendingPixels[i]].get(), sampleColors[i])) {
+                    nextPendingPixels.push_back(pendingPixels[i]);
+                }
+            }
+            pendingPixels.swap(nextPendingPixels);
+        }
+
+        for (int i = 0; i < wavePixels; ++i) {
+            const int pixel = waveStart + i;
+            imageWriter.SetPixelColor(sampler->ComputeFinalColor(*pixelStates[i].get()), pixel % resolution.x, pixel / resolution.x);
+        }
+    }
+}
+
+void WavefrontEngine::TraceWave(std::vector<QueuedRay>& rayQueue, std::vector<glm::vec3>& pixelColors) const
+{
+    std::vector<IntersectionState> hits;
+    std::vector<int> hitRays;
+    std::vector<ShadingOutput> outputs;
+    std::vector<QueuedRay> nextRayQueue;
+    std::vector<ShadowRay> shadowQueue;
+
+    while (!rayQueue.empty()) {
+        SortByOriginAndDirection(rayQueue);
+        IntersectRays(rayQueue, hits, hitRays);
+        ShadeHits(rayQueue, hits, hitRays, outputs);
+
+        // Outputs are merged in range order, so the result does not depend on how the ranges were scheduled.
+        nextRayQueue.clear();
+        shadowQueue.clear();
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            nextRayQueue.insert(nextRayQueue.end(), outputs[i].extensionRays.begin(), outputs[i].extensionRays.end());
+            shadowQueue.insert(shadowQueue.end(), outputs[i].shadowRays.begin(), outputs[i].shadowRays.end());
+            for (size_t c = 0; c < outputs[i].contributions.size(); ++c) {
+                pixelColors[outputs[i].contributions[c].pixel] += outputs[i].contributions[c].color;
+            }
+        }
+
+        TraceShadowRays(shadowQueue, pixelColors);
+        rayQueue.swap(nextRayQueue);
+    }
+}
+
+void WavefrontEngine::IntersectRays(std::vector<QueuedRay>& rayQueue, std::vector<IntersectionState>& hits, std::vector<int>& hitRays) const
+{
+    hits.resize(rayQueue.size());
+    std::vector<char> didHit(rayQueue.size(), 0);
+
+    // The queue is sorted, so consecutive rays form reasonably coherent packets.
+    ParallelFor(rayQueue.size(), RayPacket::MAX_RAYS, [&](size_t begin, size_t end) {
+        RayPacket packet;
+        for (size_t i = begin; i < end; ++i) {
+            hits[i] = IntersectionState(rayQueue[i].remainingReflectionBounces, rayQueue[i].remainingRefractionBounces);
+            hits[i].currentIOR = rayQueue[i].currentIOR;
+            packet.AddRay(&rayQueue[i].ray, &hits[i]);
+        }
+
+        const uint64_t hitMask = scene->TracePacket(packet);
+        for (size_t i = begin; i < end; ++i) {
+            didHit[i] = (hitMask >> (i - begin)) & 1;
+        }
+    }, threadCount);
+
+    hitRays.clear();
+    for (size_t i = 0; i < rayQueue.size(); ++i) {
+        if (didHit[i]) {
+            hitRays.push_back(static_cast<int>(i));
+        }
+    }
+
+    // Shade hits on the same material together; within a material the spatial order of the ray queue is kept.
+    std::stable_sort(hitRays.begin(), hitRays.end(), [&](int a, int b) {
+        return hits[a].intersectedPrimitive->GetParentMeshObject()->GetMaterial() < hits[b].intersectedPrimitive->GetParentMeshObject()->GetMaterial();
+    });
+}
+
+void WavefrontEngine::ShadeHits(const std::vector<QueuedRay>& rayQueue, const std::vector<IntersectionState>& hits, const std::vector<int>& hitRays, std::vector<ShadingOutput>& outputs) const
+{
+    // Lights are picked from the LightTree like BackwardRenderer does when the renderer is one that is set up to.
+    const BackwardRenderer* backwardRenderer = dynamic_cast<const BackwardRenderer*>(renderer.get());
+    const int lightSamples = (backwardRenderer && scene->GetLightTree()) ? backwardRenderer->GetLightSamples() : 0;
+
+    // Every range writes to its own output so that shading needs no locks.
+    outputs.resize((hitRays.size() + STAGE_GRAIN_SIZE - 1) / STAGE_GRAIN_SIZE);
+    ParallelFor(hitRays.size(), STAGE_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        ShadingOutput& output = outputs[begin / STAGE_GRAIN_SIZE];
+        output.extensionRays.clear();
+        output.shadowRays.clear();
+        output.contributions.clear();
+        output.batchMaterial = nullptr;
+        output.shadingBatch.Clear();
+        for (size_t i = begin; i < end; ++i) {
+            ShadeHit(rayQueue[hitRays[i]], hits[hitRays[i]], lightSamples, output);
+        }
+        FlushShadingBatch(output);
+    }, threadCount);
+}
+
+void WavefrontEngine::ShadeHit(const QueuedRay& queuedRay, const IntersectionState& hit, int lightSamples, ShadingOutput& output) const
+{
+    const MeshObject* parentObject = hit.intersectedPrimitive->GetParentMeshObject();
+    assert(parentObject);
+    const Material* material = parentObject->GetMaterial();
+    assert(material);
+
+    const glm::vec3 intersectionPoint = hit.intersectionRay.GetRayPosition(hit.intersectionT);
+    const glm::vec3 normal = hit.ComputeNormal();
+
+    // Direct lighting. The BRDF is evaluated now and only added to the pixel if the shadow ray turns out unoccluded.
+    // Hits arrive sorted by material, so batched samples only need to be flushed when the material changes; flushing
+    // before every other material also keeps the shadow rays in the order of the hits.
+    if (output.batchMaterial != material) {
+        FlushShadingBatch(output);
+        output.batchMaterial = material;
+    }
+    const bool batchShading = (material->GetBatchShader() != nullptr);
+    const glm::vec3 toCamera = -1.f * queuedRay.ray.GetRayDirection();
+    const glm::vec2 uv = (batchShading && material->GetCompiledMaterial().GetTexture(MaterialTextureSlot::DIFFUSE)) ? hit.ComputeUV() : glm::vec2();
+
+    // Lights to shade with the factor that their samples are weighted by: every light, or the lights that are not in the
+    // tree plus lightSamples picks from it divided by the probability of the pick.
+    output.shadedLights.clear();
+    if (lightSamples <= 0) {
+        for (size_t i = 0; i < scene->GetTotalLights(); ++i) {
+            output.shadedLights.push_back(std::make_pair(i, 1.f));
+        }
+    } else {
+        const LightTree* lightTree = scene->GetLightTree();
+        for (size_t lightIndex : lightTree->GetInfiniteLights()) {
+            output.shadedLights.push_back(std::make_pair(lightIndex, 1.f));
+        }
+        for (int s = 0; s < lightSamples; ++s) {
+            size_t lightIndex;
+            float lightProbability;
+            if (!BackwardRenderer::SampleLight(*lightTree, hit, intersectionPoint, s, lightIndex, lightProbability)) {
+                break;
+            }
+            output.shadedLights.push_back(std::make_pair(lightIndex, 1.f / (lightProbability * static_cast<float>(lightSamples))));
+        }
+    }
+
+    for (const std::pair<size_t, float>& shadedLight : output.shadedLights) {
+        const size_t i = shadedLight.first;
+        const Light* light = scene->GetLightObject(i);
+        assert(light);
+
+        // Same sample coordinates as BackwardRenderer::ComputeLightContribution. Shadow rays are only traced after
+        // shading, so lights that are sampled adaptively always get all their samples here.
+        const int sampleCount = light->GetSampleCount();
+        Light::GenerateSampleCoordinates(Renderer::ComputeLightSampleKey(queuedRay.sampleKey, i), sampleCount, output.lightSampleCoordinates.data(), 0, sampler.get());
+        light->ComputeSamples(intersectionPoint, normal, output.lightSampleCoordinates.data(), sampleCount, output.lightSamples.data());
+        for (int s = 0; s < sampleCount; ++s) {
+            const LightSample& sample = output.lightSamples[s];
+            if (sample.radiance == glm::vec3(0.f)) {
+                continue;
+            }
+
+            const Ray sampleRay = sample.CreateShadowRay(intersectionPoint, normal);
+            const float sampleWeight = shadedLight.second / (sample.pdf * static_cast<float>(sampleCount));
+            if (batchShading) {
+                if (output.shadingBatch.IsFull()) {
+                    FlushShadingBatch(output);
+                }
+                const int index = output.shadingBatch.AddSample(normal, sampleRay.GetRayDirection(), toCamera, uv, sample.radiance, sampleWeight);
+                ShadowRay& shadowRay = output.batchedShadowRays[index];
+                shadowRay.ray = sampleRay;
+                shadowRay.contribution = queuedRay.throughput;
+                shadowRay.pixel = queuedRay.pixel;
+                continue;
+            }
+
+            const glm::vec3 contribution = queuedRay.throughput * material->ComputeBRDF(hit, sample.radiance, sampleRay, queuedRay.ray, sampleWeight);
+            if (contribution == glm::vec3(0.f)) {
+                continue;
+            }
+
+            ShadowRay shadowRay;
+            shadowRay.ray = sampleRay;
+            shadowRay.contribution = contribution;
+            shadowRay.pixel = queuedRay.pixel;
+            output.shadowRays.push_back(shadowRay);
+        }
+    }
+
+    if (material->GetAmbient() != glm::vec3(0.f)) {
+        PixelContribution ambient;
+        ambient.pixel = queuedRay.pixel;
+        ambient.color = queuedRay.throughput * material->GetAmbient();
+        output.contributions.push_back(ambient);
+    }
+
+    // Reflection and refraction rays carry the weight that Material::ComputeNonLightDependentBRDF would have applied to their color.
+    const float NdR = glm::dot(queuedRay.ray.GetRayDirection(), normal);
+    if (material->IsReflective() && hit.remainingReflectionBounces > 0) {
+        const glm::vec3 throughput = queuedRay.throughput * material->GetReflectivity();
+        const float terminationWeight = renderer->ComputeSecondaryRayWeight(throughput, Renderer::GenerateRandomNumber(queuedRay.ray, static_cast<uint32_t>(SecondaryRayType::REFLECTION)));
+        if (terminationWeight > 0.f) {
+            QueuedRay reflectionRay;
+            scene->PerformRaySpecularReflection(reflectionRay.ray, queuedRay.ray, intersectionPoint, NdR, hit);
+            reflectionRay.throughput = throughput * terminationWeight;
+            reflectionRay.pixel = queuedRay.pixel;
+            reflectionRay.sampleKey = Renderer::ComputeSecondarySampleKey(queuedRay.sampleKey, SecondaryRayType::REFLECTION);
+            reflectionRay.remainingReflectionBounces = hit.remainingReflectionBounces - 1;
+            reflectionRay.remainingRefractionBounces = hit.remainingRefractionBounces;
+            reflectionRay.currentIOR = 1.f;
+            output.extensionRays.push_back(reflectionRay);
+        }
+    }
+
+    if (material->IsTransmissive() && hit.remainingRefractionBounces > 0) {
+        const glm::vec3 throughput = queuedRay.throughput * material->GetTransmittance();
+        const float terminationWeight = renderer->ComputeSecondaryRayWeight(throughput, Renderer::GenerateRandomNumber(queuedRay.ray, static_cast<uint32_t>(SecondaryRayType::REFRACTION)));
+        if (terminationWeight > 0.f) {
+            // If we're going into the mesh, set the target IOR to be the IOR of the mesh.
+            float targetIOR = (NdR < SMALL_EPSILON) ? material->GetIOR() : 1.f;
+
+            QueuedRay refractionRay;
+            scene->PerformRayRefraction(refractionRay.ray, queuedRay.ray, intersectionPoint, NdR, hit, targetIOR);
+            refractionRay.throughput = throughput * terminationWeight;
+            refractionRay.pixel = queuedRay.pixel;
+            refractionRay.sampleKey = Renderer::ComputeSecondarySampleKey(queuedRay.sampleKey, SecondaryRayType::REFRACTION);
+            refractionRay.remainingReflectionBounces = hit.remainingReflectionBounces;
+            refractionRay.remainingRefractionBounces = hit.remainingRefractionBounces - 1;
+            refractionRay.currentIOR = targetIOR;
+            output.extensionRays.push_back(refractionRay);
+        }
+    }
+}
+
+void WavefrontEngine::FlushShadingBatch(ShadingOutput& output) const
+{
+    ShadingBatch& batch = output.shadingBatch;
+    if (batch.totalSamples == 0) {
+        return;
+    }
+
+    // Only materials with a batch shader fill the batch.
+    const BatchShader* batchShader = output.batchMaterial->GetBatchShader();
+    assert(batchShader);
+    batchShader->ComputeBRDFBatch(batch);
+    for (int i = 0; i < batch.totalSamples; ++i) {
+        ShadowRay& shadowRay = output.batchedShadowRays[i];
+        shadowRay.contribution *= batch.GetResponse(i);
+        if (shadowRay.contribution == glm::vec3(0.f)) {
+            continue;
+        }
+        output.shadowRays.push_back(shadowRay);
+    }
+    batch.Clear();
+}
+
+void WavefrontEngine::TraceShadowRays(std::vector<ShadowRay>& shadowQueue, std::vector<glm::vec3>& pixelColors) const
+{
+    SortByOriginAndDirection(shadowQueue);
+
+    std::vector<char> isVisible(shadowQueue.size(), 0);
+    ParallelFor(shadowQueue.size(), STAGE_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            // Max T of the shadow ray is set right before the light.
+            isVisible[i] = !scene->Trace(&shadowQueue[i].ray, nullptr);
+        }
+    }, threadCount);
+
+    for (size_t i = 0; i < shadowQueue.size(); ++i) {
+        if (isVisible[i]) {
+            pixelColors[shadowQueue[i].pixel] += shadowQueue[i].contribution;
+        }
+    }
+}
+
+template<typename T>
+void WavefrontEngine::SortByOriginAndDirection(std::vector<T>& queue)
+{
+    if (queue.size() < 2) {
+        return;
+    }
+
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const glm::vec3 origin(queue[i].ray.GetPosition());
+        boundsMin = glm::min(boundsMin, origin);
+        boundsMax = glm::max(boundsMax, origin);
+    }
+    const glm::vec3 boundsInverseExtent = 1.f / glm::max(boundsMax - boundsMin, glm::vec3(SMALL_EPSILON));
+
+    // Ties keep their queue order, which keeps camera rays in pixel order.
+    std::vector<std::pair<uint64_t, size_t>> keys(queue.size());
+    for (size_t i = 0; i < queue.size(); ++i) {
+        keys[i] = std::make_pair(ComputeSortKey(queue[i].ray, boundsMin, boundsInverseExtent), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<T> sortedQueue;
+    sortedQueue.reserve(queue.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        sortedQueue.push_back(queue[keys[i].second]);
+    }
+    queue.swap(sortedQueue);
+}
+
+uint64_t WavefrontEngine::ComputeSortKey(const Ray& ray, const glm::vec3& boundsMin, const glm::vec3& boundsInverseExtent)
+{
+    // [direction octant: 3 bits][origin morton code: 30 bits][direction morton code: 21 bits]
+    const glm::vec3 direction = ray.GetRayDirection();
+    const uint64_t octant = (direction.x < 0.f ? 1 : 0) | (direction.y < 0.f ? 2 : 0) | (direction.z < 0.f ? 4 : 0);
+    const uint64_t originCode = Morton3D((glm::vec3(ray.GetPosition()) - boundsMin) * boundsInverseExtent, 1024.f);
+    const uint64_t directionCode = Morton3D(direction * 0.5f + 0.5f, 128.f);
+    return (octant << 51) | (originCode << 21) | directionCode;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Rendering/Material/ShadingBatch.h"
+#include "common/Scene/Lights/Light.h"
+
+// Breadth-first alternative to the depth-first Scene::Trace + BackwardRenderer recursion. Every sample round of a
+// wave of pixels first generates all camera rays, then repeatedly
+//   1. sorts the ray queue by origin/direction and intersects it in packets,
+//   2. sorts the hits by material and shades them, which appends shadow rays, reflection/refraction rays and
+//      direct contributions to per-stage queues,
+//   3. sorts and traces the shadow queue,
+// until no reflection/refraction rays are left. Each stage runs over the whole queue on all threads.
+//
+// Shading follows BackwardRenderer and Material::ComputeBRDF, and reflection/refraction rays are terminated like
+// Renderer::TraceSecondaryRay does. With a BackwardRenderer, lights are picked from the scene's LightTree according to its
+// SetLightSamples, with the same picks as BackwardRenderer makes. Materials that override ComputeNonLightDependentBRDF or
+// ComputeReflection/ComputeTransmission are not supported. Light samples of consecutive hits on a material that
+// has a BatchShader are collected and evaluated with BatchShader::ComputeBRDFBatch.
+class WavefrontEngine
+{
+public:
+    WavefrontEngine(std::shared_ptr<class Scene> inputScene, std::shared_ptr<class Camera> inputCamera, std::shared_ptr<class ColorSampler> inputSampler, std::shared_ptr<class Renderer> inputRenderer);
+
+    void SetMaxBounces(int reflectionBounces, int refractionBounces);
+    void SetSamplesPerPixel(int input);
+    // Upper bound on the pixels that are in flight at once; bounds the memory used by the queues.
+    void SetWaveSize(int input);
+    // 0 uses every hardware thread.
+    void SetThreadCount(int input);
+
+    // The scene must be finalized.
+    void Render(class ImageWriter& imageWriter, glm::ivec2 resolution) const;
+
+private:
+    struct QueuedRay
+    {
+        Ray ray;
+        glm::vec3 throughput;
+        int pixel;
+        // IntersectionState::sampleKey of the ray's hit.
+        uint32_t sampleKey;
+        int remainingReflectionBounces;
+        int remainingRefractionBounces;
+        float currentIOR;
+    };
+
+    struct ShadowRay
+    {
+        Ray ray;
+        glm::vec3 contribution;
+        int pixel;
+    };
+
+    struct PixelContribution
+    {
+        int pixel;
+        glm::vec3 color;
+    };
+
+    struct ShadingOutput
+    {
+        std::vector<QueuedRay> extensionRays;
+        std::vector<ShadowRay> shadowRays;
+        std::vector<PixelContribution> contributions;
+
+        // Scratch space for the lights of one hit and their weights, and for the samples of one light.
+        std::vector<std::pair<size_t, float>> shadedLights;
+        std::array<glm::vec2, Light::MAX_SAMPLES> lightSampleCoordinates;
+        std::array<LightSample, Light::MAX_SAMPLES> lightSamples;
+
+        // Light samples on batchMaterial that wait for its BatchShader. Until then the contribution of
+        // their shadow rays holds the throughput of the hit.
+        const class Material* batchMaterial;
+        ShadingBatch shadingBatch;
+        std::array<ShadowRay, ShadingBatch::MAX_SAMPLES> batchedShadowRays;
+    };
+
+    void TraceWave(std::vector<QueuedRay>& rayQueue, std::vector<glm::vec3>& pixelColors) const;
+    void IntersectRays(std::vector<QueuedRay>& rayQueue, std::vector<IntersectionState>& hits, std::vector<int>& hitRays) const;
+    void ShadeHits(const std::vector<QueuedRay>& rayQueue, const std::vector<IntersectionState>& hits, const std::vector<int>& hitRays, std::vector<ShadingOutput>& outputs) const;
+    void ShadeHit(const QueuedRay& queuedRay, const IntersectionState& hit, int lightSamples, ShadingOutput& output) const;
+    void FlushShadingBatch(ShadingOutput& output) const;
+    void TraceShadowRays(std::vector<ShadowRay>& shadowQueue, std::vector<glm::vec3>& pixelColors) const;
+
+    // Sorts the rays so that rays with nearby origins and similar directions end up next to each other.
+    template<typename T>
+    static void SortByOriginAndDirection(std::vector<T>& queue);
+    static uint64_t ComputeSortKey(const Ray& ray, const glm::vec3& boundsMin, const glm::vec3& boundsInverseExtent);
+
+    std::shared_ptr<class Scene> scene;
+    std::shared_ptr<class Camera> camera;
+    std::shared_ptr<class ColorSampler> sampler;
+    std::shared_ptr<class Renderer> renderer;
+
+    int maxReflectionBounces;
+    int maxRefractionBounces;
+    int samplesPerPixel;
+    int waveSize;
+    int threadCount;
+};
@@ -1,14 +1,14 @@
 #include "common/Sampling/Adaptive/Simple/SimpleAdaptiveSampler.h"
 
 SimpleAdaptiveSampler::SimpleAdaptiveSampler() :
-    earlyExitThreshold(SMALL_EPSILON), minimumEarlyExitSamples(1)
+    earlyExitThreshold(SMALL_EPSILON), relativeEarlyExitThreshold(0.f), earlyExitConfidence(1.96f), minimumEarlyExitSamples(1)
 {
 }
 
-std::unique_ptr<SamplerState> SimpleAdaptiveSampler::CreateSampler(std::random_device& randomDevice, const int maxSamples, const int dimensions) const
+std::unique_ptr<SamplerState> SimpleAdaptiveSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
 {
-    std::unique_ptr<SimpleAdaptiveSamplerState> state = make_unique<SimpleAdaptiveSamplerState>(randomDevice, maxSamples, dimensions);
-    state->internalState = internalSampler->CreateSampler(randomDevice, maxSamples, dimensions);
+    std::unique_ptr<SimpleAdaptiveSamplerState> state = make_unique<SimpleAdaptiveSamplerState>(seed, maxSamples, dimensions);
+    state->internalState = internalSampler->CreateSampler(seed, maxSamples, dimensions);
     return std::move(state);
 }
 
@@ -30,26 +30,25 @@ void SimpleAdaptiveSampler::SetInternalSampler(std::shared_ptr<ColorSampler> inp
 
 bool SimpleAdaptiveSampler::NotifyColorSampleForEarlyExit(SamplerState& state, glm::vec3 inColor) const
 {
-    if (static_cast<int>(state.colorHistory.size()) < minimumEarlyExitSamples) {
+    // A variance estimate needs at least two samples.
+    if (state.recordedSamples < std::max(minimumEarlyExitSamples, 2)) {
         return false;
     }
 
-    glm::vec3 averageColor;
-    for (size_t i = 0; i < state.colorHistory.size(); ++i) {
-        averageColor += state.colorHistory[i];
-    }
-    averageColor /= static_cast<float>(state.colorHistory.size());
-
     // ASSIGNMENT 5 (OPTIONAL): Modify this line to change the adaptive condition.
-    if (glm::distance(averageColor, inColor) < earlyExitThreshold) {
-        return true;
-    }
-
-    return false;
+    const glm::vec3 standardError = glm::sqrt(state.ComputeColorVariance() / static_cast<float>(state.recordedSamples));
+    const glm::vec3 tolerance = glm::vec3(earlyExitThreshold) + relativeEarlyExitThreshold * glm::abs(state.colorMean);
+    return glm::all(glm::lessThanEqual(earlyExitConfidence * standardError, tolerance));
 }
 
 void SimpleAdaptiveSampler::SetEarlyExitParameters(float threshold, int minSampleCount)
 {
     earlyExitThreshold = threshold;
     minimumEarlyExitSamples = minSampleCount;
+}
+
+void SimpleAdaptiveSampler::SetRelativeErrorThreshold(float relativeThreshold, float confidence)
+{
+    relativeEarlyExitThreshold = relativeThreshold;
+    earlyExitConfidence = confidence;
 }
\ No newline at end of file
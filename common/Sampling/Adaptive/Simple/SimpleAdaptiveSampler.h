@@ -4,8 +4,8 @@
 
 struct SimpleAdaptiveSamplerState : public SamplerState
 {
-    SimpleAdaptiveSamplerState(std::random_device& device, int inputMax, int inputDim) :
-        SamplerState(device, inputMax, inputDim)
+    SimpleAdaptiveSamplerState(uint32_t inputSeed, int inputMax, int inputDim) :
+        SamplerState(inputSeed, inputMax, inputDim)
     {
     }
 
@@ -17,9 +17,13 @@ class SimpleAdaptiveSampler : public ColorSampler
 public:
     SimpleAdaptiveSampler();
     void SetInternalSampler(std::shared_ptr<ColorSampler> inputSampler);
+    // A pixel stops once, after at least minSampleCount samples, the confidence interval of its mean color is narrower
+    // than threshold + relativeThreshold * mean in every channel. confidence is the interval's half-width in standard
+    // errors (1.96 for 95%).
     void SetEarlyExitParameters(float threshold, int minSampleCount);
+    void SetRelativeErrorThreshold(float relativeThreshold, float confidence = 1.96f);
 
-    virtual std::unique_ptr<SamplerState> CreateSampler(std::random_device& randomDevice, const int maxSamples, const int dimensions) const override;
+    virtual std::unique_ptr<SamplerState> CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const override;
     virtual glm::vec3 ComputeSampleCoordinate(SamplerState& state) const override;
 
     virtual void InitializeSampler(class Application* app, class Scene* inputScene) override;
@@ -29,5 +33,7 @@ protected:
 private:
     std::shared_ptr<ColorSampler> internalSampler;
     float earlyExitThreshold;
+    float relativeEarlyExitThreshold;
+    float earlyExitConfidence;
     int minimumEarlyExitSamples;
 };
\ No newline at end of file
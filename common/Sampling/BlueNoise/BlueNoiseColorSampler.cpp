@@ -0,0 +1,75 @@
+#include "common/Sampling/BlueNoise/BlueNoiseColorSampler.h"
+
+namespace
+{
+// Scramble shared by every pixel; the blue-noise offsets do the decorrelation.
+const uint32_t SEQUENCE_SEED = 0x2545f491u;
+// Width of the Gaussian that measures how crowded a part of the mask is, in pixels.
+const float VOID_SIGMA = 1.9f;
+// Offsets into the mask for the three sample dimensions so that they do not share a value.
+const glm::ivec2 DIMENSION_OFFSETS[3] = { glm::ivec2(0, 0), glm::ivec2(23, 41), glm::ivec2(47, 11) };
+}
+
+BlueNoiseColorSampler::BlueNoiseColorSampler()
+{
+    // The mask only depends on constants, so every sampler shares the one generated first.
+    static const std::shared_ptr<const std::vector<float>> sharedMask = std::make_shared<const std::vector<float>>(GenerateMask());
+    mask = sharedMask;
+}
+
+std::unique_ptr<SamplerState> BlueNoiseColorSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
+{
+    std::unique_ptr<SobolSamplerState> state = make_unique<SobolSamplerState>(seed, maxSamples, dimensions);
+    state->scrambleSeed = SEQUENCE_SEED;
+    return std::move(state);
+}
+
+glm::vec3 BlueNoiseColorSampler::ComputeSampleCoordinate(SamplerState& state) const
+{
+    glm::vec3 sample = SobolColorSampler::ComputeSampleCoordinate(state);
+    for (int i = 0; i < 3; ++i) {
+        const glm::ivec2 maskPixel = (state.pixel + DIMENSION_OFFSETS[i]) & (MASK_SIZE - 1);
+        sample[i] += (*mask)[maskPixel.y * MASK_SIZE + maskPixel.x];
+    }
+    return glm::min(glm::fract(sample), glm::vec3(1.f - SMALL_EPSILON));
+}
+
+std::vector<float> BlueNoiseColorSampler::GenerateMask()
+{
+    const int totalPixels = MASK_SIZE * MASK_SIZE;
+
+    // Energy that a placed pixel adds at each toroidal offset from it.
+    std::vector<float> kernel(totalPixels);
+    for (int y = 0; y < MASK_SIZE; ++y) {
+        for (int x = 0; x < MASK_SIZE; ++x) {
+            const float dx = static_cast<float>(std::min(x, MASK_SIZE - x));
+            const float dy = static_cast<float>(std::min(y, MASK_SIZE - y));
+            kernel[y * MASK_SIZE + x] = std::exp(-(dx * dx + dy * dy) / (2.f * VOID_SIGMA * VOID_SIGMA));
+        }
+    }
+
+    std::vector<float> energy(totalPixels, 0.f);
+    std::vector<bool> placed(totalPixels, false);
+    std::vector<float> result(totalPixels);
+    for (int rank = 0; rank < totalPixels; ++rank) {
+        int voidPixel = -1;
+        for (int i = 0; i < totalPixels; ++i) {
+            if (!placed[i] && (voidPixel < 0 || energy[i] < energy[voidPixel])) {
+                voidPixel = i;
+            }
+        }
+
+        placed[voidPixel] = true;
+        result[voidPixel] = (static_cast<float>(rank) + 0.5f) / static_cast<float>(totalPixels);
+
+        const int voidX = voidPixel % MASK_SIZE;
+        const int voidY = voidPixel / MASK_SIZE;
+        for (int y = 0; y < MASK_SIZE; ++y) {
+            const int kernelY = (y - voidY) & (MASK_SIZE - 1);
+            for (int x = 0; x < MASK_SIZE; ++x) {
+                energy[y * MASK_SIZE + x] += kernel[kernelY * MASK_SIZE + ((x - voidX) & (MASK_SIZE - 1))];
+            }
+        }
+    }
+    return result;
+}
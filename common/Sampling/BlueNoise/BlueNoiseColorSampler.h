@@ -0,0 +1,26 @@
+#pragma once
+
+#include "common/Sampling/Sobol/SobolColorSampler.h"
+
+// Every pixel uses the same Sobol sequence, shifted (modulo 1) by the values of a tiled blue-noise mask at the pixel's
+// position in SamplerState::pixel. Neighboring pixels then get very different offsets, which turns the error left at
+// low sample counts into high-frequency noise that is much less visible than white noise and easy to filter.
+// ComputeSequenceSample knows no pixel, so dimensions drawn through it get the scrambled Sobol points of SobolColorSampler.
+class BlueNoiseColorSampler : public SobolColorSampler
+{
+public:
+    BlueNoiseColorSampler();
+
+    virtual std::unique_ptr<SamplerState> CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const override;
+    virtual glm::vec3 ComputeSampleCoordinate(SamplerState& state) const override;
+
+    // Side length of the mask in pixels.
+    static const int MASK_SIZE = 64;
+
+private:
+    // Ranks the pixels of a toroidal MASK_SIZE^2 tile with the void-and-cluster method: every pixel is placed in the
+    // largest remaining void, measured by a Gaussian energy of the pixels placed before it.
+    static std::vector<float> GenerateMask();
+
+    std::shared_ptr<const std::vector<float>> mask;
+};
@@ -1,6 +1,8 @@
 #include "common/Sampling/ColorSampler.h"
+#include "common/Utility/Random/RandomStream.h"
 
-ColorSampler::ColorSampler()
+ColorSampler::ColorSampler():
+    storedApp(nullptr), storedScene(nullptr), renderSeed(0)
 {
 }
 
@@ -10,35 +12,73 @@ void ColorSampler::InitializeSampler(Application* app, Scene* inputScene)
     storedScene = inputScene;
 }
 
-std::unique_ptr<SamplerState> ColorSampler::CreateSampler(std::random_device& randomDevice, const int maxSamples, const int dimensions) const
+std::unique_ptr<SamplerState> ColorSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
 {
-    return std::move(make_unique<SamplerState>(randomDevice, maxSamples, dimensions));
+    return std::move(make_unique<SamplerState>(seed, maxSamples, dimensions));
 }
 
-glm::vec3 ColorSampler::ComputeSamplesAndColor(const int maxSamples, const int dimensions, std::function<glm::vec3(glm::vec3)> colorComputer) const
+uint32_t ColorSampler::ComputePixelSeed(glm::ivec2 pixel) const
 {
-    std::random_device randomDevice;
-    std::unique_ptr<SamplerState> newState = CreateSampler(randomDevice, maxSamples, dimensions);
+    return RandomStream::Hash(renderSeed, static_cast<uint32_t>(pixel.x), static_cast<uint32_t>(pixel.y));
+}
+
+uint32_t ColorSampler::GetRenderSeed() const
+{
+    return renderSeed;
+}
+
+void ColorSampler::SetRenderSeed(uint32_t input)
+{
+    renderSeed = input;
+}
+
+uint32_t ColorSampler::ComputeSampleKey(uint32_t pixelSeed, int sampleIndex)
+{
+    return RandomStream::Hash(pixelSeed, static_cast<uint32_t>(sampleIndex));
+}
+
+bool ColorSampler::ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const
+{
+    return false;
+}
+
+glm::vec3 ColorSampler::ComputeSamplesAndColor(const int maxSamples, const int dimensions, glm::ivec2 pixel, std::function<glm::vec3(glm::vec3)> colorComputer) const
+{
+    std::unique_ptr<SamplerState> newState = CreateSampler(ComputePixelSeed(pixel), maxSamples, dimensions);
+    newState->pixel = pixel;
 
-    glm::vec3 finalColor;
     for (int i = 0; i < maxSamples; ++i) {
         // Compute normalized sample. 
         glm::vec3 sampleCoordinates = ComputeSampleCoordinate(*newState.get());
 
         // Compute sample color.
         glm::vec3 sampleColor = colorComputer(sampleCoordinates);
-        finalColor += sampleColor;
-        ++newState->samplesComputed;
-
-        if (NotifyColorSampleForEarlyExit(*newState.get(), sampleColor)) {
+        if (!RecordColorSample(*newState.get(), sampleColor)) {
             break;
         }
+    }
+    return ComputeFinalColor(*newState.get());
+}
 
-        newState->colorHistory.push_back(sampleColor);
-        
+bool ColorSampler::RecordColorSample(SamplerState& state, glm::vec3 sampleColor) const
+{
+    state.accumulatedColor += sampleColor;
+    ++state.samplesComputed;
+
+    ++state.recordedSamples;
+    const glm::vec3 deviation = sampleColor - state.colorMean;
+    state.colorMean += deviation / static_cast<float>(state.recordedSamples);
+    state.colorSquaredDeviations += deviation * (sampleColor - state.colorMean);
+
+    if (NotifyColorSampleForEarlyExit(state, sampleColor)) {
+        return false;
     }
-    finalColor /= static_cast<float>(newState->samplesComputed);
-    return finalColor;
+    return state.samplesComputed < state.maxSamples;
+}
+
+glm::vec3 ColorSampler::ComputeFinalColor(const SamplerState& state) const
+{
+    return state.accumulatedColor / static_cast<float>(state.samplesComputed);
 }
 
 glm::vec3 ColorSampler::ComputeSampleCoordinate(SamplerState& state) const
@@ -52,7 +92,11 @@ glm::vec3 ColorSampler::ComputeSampleCoordinate(SamplerState& state) const
 
 float ColorSampler::GenerateRandomNumber(SamplerState& state) const
 {
-    return static_cast<float>(state.dist(state.gen));
+    if (state.randomSample != state.samplesComputed) {
+        state.randomSample = state.samplesComputed;
+        state.randomDimension = 0;
+    }
+    return RandomStream::ToFloat(RandomStream::Hash(state.seed, static_cast<uint32_t>(state.samplesComputed), state.randomDimension++));
 }
 
 bool ColorSampler::NotifyColorSampleForEarlyExit(SamplerState& state, glm::vec3 inColor) const
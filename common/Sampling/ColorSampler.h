@@ -1,22 +1,38 @@
 #pragma once
 
 #include "common/common.h"
-#include <random>
 
 struct SamplerState
 {
-    SamplerState(std::random_device& device, int inputMax, int inputDim) :
-        maxSamples(inputMax), dimensions(inputDim), samplesComputed(0), gen(device()), dist(0, 1)
+    SamplerState(uint32_t inputSeed, int inputMax, int inputDim) :
+        maxSamples(inputMax), dimensions(inputDim), samplesComputed(0), recordedSamples(0), seed(inputSeed), randomSample(0), randomDimension(0)
     {
     }
 
-    std::vector<glm::vec3> colorHistory;
+    // Unbiased variance of the colors recorded so far; 0 until there are two of them.
+    glm::vec3 ComputeColorVariance() const
+    {
+        return (recordedSamples > 1) ? colorSquaredDeviations / static_cast<float>(recordedSamples - 1) : glm::vec3();
+    }
+
+    glm::vec3 accumulatedColor;
     const int maxSamples;
     const int dimensions;
     int samplesComputed;
+    // Pixel the samples are for; samplers that decorrelate pixels in screen space use it.
+    glm::ivec2 pixel;
+
+    // Running mean and sum of squared deviations from it (Welford) of the colors passed to RecordColorSample.
+    // Counted separately from samplesComputed, which callers may advance to continue a stratified sequence.
+    glm::vec3 colorMean;
+    glm::vec3 colorSquaredDeviations;
+    int recordedSamples;
 
-    std::mt19937 gen;
-    std::uniform_real_distribution<> dist;
+    // Random numbers are hashed from the seed, the sample index and the dimension within the sample, so a pixel's
+    // samples do not depend on the thread or on the samples of other pixels.
+    const uint32_t seed;
+    int randomSample;
+    uint32_t randomDimension;
 };
 
 class ColorSampler : public std::enable_shared_from_this<ColorSampler>
@@ -24,15 +40,33 @@ class ColorSampler : public std::enable_shared_from_this<ColorSampler>
 public:
     ColorSampler();
 
-    virtual std::unique_ptr<SamplerState> CreateSampler(std::random_device& randomDevice, const int maxSamples, const int dimensions) const;
+    virtual std::unique_ptr<SamplerState> CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const;
     virtual void InitializeSampler(class Application* app, class Scene* inputScene);
 
-    virtual glm::vec3 ComputeSamplesAndColor(const int maxSamples, const int dimensions, std::function<glm::vec3(glm::vec3)> colorComputer) const;
+    // Seed of the pixel's sampler state; changing the render seed gives a different, equally reproducible image.
+    uint32_t ComputePixelSeed(glm::ivec2 pixel) const;
+    uint32_t GetRenderSeed() const;
+    void SetRenderSeed(uint32_t input);
+    // Key of one camera sample, i.e. of the render seed, the pixel and the sample index; see IntersectionState::sampleKey.
+    static uint32_t ComputeSampleKey(uint32_t pixelSeed, int sampleIndex);
+
+    // Stateless counterpart of ComputeSampleCoordinate for dimensions that are not drawn per pixel, e.g. light samples and photon
+    // emission: writes sample index of the sequence with the given key to sample. Returns false if the sampler has no sequence of
+    // its own (plain random and jittered sampling), in which case callers stratify the samples themselves.
+    virtual bool ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const;
+
+    virtual glm::vec3 ComputeSamplesAndColor(const int maxSamples, const int dimensions, glm::ivec2 pixel, std::function<glm::vec3(glm::vec3)> colorComputer) const;
     virtual glm::vec3 ComputeSampleCoordinate(SamplerState& state) const;
+
+    // For callers that generate the samples of several pixels together (e.g. camera ray packets) instead of going through ComputeSamplesAndColor.
+    // RecordColorSample returns whether the pixel wants more samples.
+    bool RecordColorSample(SamplerState& state, glm::vec3 sampleColor) const;
+    glm::vec3 ComputeFinalColor(const SamplerState& state) const;
 protected:
     virtual float GenerateRandomNumber(SamplerState& state) const;
     virtual bool NotifyColorSampleForEarlyExit(SamplerState& state, glm::vec3 inColor) const;
 
     class Application* storedApp;
     class Scene* storedScene;
+    uint32_t renderSeed;
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "common/Sampling/Halton/HaltonColorSampler.h"
+#include "common/Utility/Random/RandomStream.h"
+
+std::unique_ptr<SamplerState> HaltonColorSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
+{
+    std::unique_ptr<HaltonSamplerState> state = make_unique<HaltonSamplerState>(seed, maxSamples, dimensions);
+    state->offset = ColorSampler::ComputeSampleCoordinate(*state.get());
+    return std::move(state);
+}
+
+glm::vec3 HaltonColorSampler::ComputeSampleCoordinate(SamplerState& state) const
+{
+    return ComputeShiftedSample(static_cast<uint32_t>(state.samplesComputed), static_cast<HaltonSamplerState&>(state).offset);
+}
+
+bool HaltonColorSampler::ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const
+{
+    // The offset that CreateSampler gives a state with the key as its seed.
+    glm::vec3 offset;
+    for (int i = 0; i < 3; ++i) {
+        offset[i] = RandomStream::ToFloat(RandomStream::Hash(key, 0u, static_cast<uint32_t>(i)));
+    }
+    sample = ComputeShiftedSample(index, offset);
+    return true;
+}
+
+glm::vec3 HaltonColorSampler::ComputeShiftedSample(uint32_t index, const glm::vec3& offset)
+{
+    const glm::vec3 sample = glm::vec3(ComputeRadicalInverse(index, 2), ComputeRadicalInverse(index, 3), ComputeRadicalInverse(index, 5)) + offset;
+    return glm::min(glm::fract(sample), glm::vec3(1.f - SMALL_EPSILON));
+}
+
+float HaltonColorSampler::ComputeRadicalInverse(uint32_t index, uint32_t base)
+{
+    const double inverseBase = 1.0 / base;
+    double digitWeight = inverseBase;
+    double result = 0.0;
+    for (; index; index /= base) {
+        result += (index % base) * digitWeight;
+        digitWeight *= inverseBase;
+    }
+    return static_cast<float>(result);
+}
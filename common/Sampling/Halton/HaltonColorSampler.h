@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common/Sampling/ColorSampler.h"
+
+struct HaltonSamplerState : public SamplerState
+{
+    HaltonSamplerState(uint32_t inputSeed, int inputMax, int inputDim) :
+        SamplerState(inputSeed, inputMax, inputDim)
+    {
+    }
+
+    glm::vec3 offset;
+};
+
+// Halton points in bases 2, 3 and 5. Every pixel's sequence is shifted by its own random offset (modulo 1), which
+// keeps the points evenly spread while decorrelating neighboring pixels. Unlike Sobol, the prefixes are well
+// distributed for any sample count rather than only for powers of two.
+class HaltonColorSampler : public ColorSampler
+{
+public:
+    virtual std::unique_ptr<SamplerState> CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const override;
+    virtual glm::vec3 ComputeSampleCoordinate(SamplerState& state) const override;
+    virtual bool ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const override;
+
+    static float ComputeRadicalInverse(uint32_t index, uint32_t base);
+
+private:
+    static glm::vec3 ComputeShiftedSample(uint32_t index, const glm::vec3& offset);
+};
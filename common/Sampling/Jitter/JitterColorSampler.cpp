@@ -17,9 +17,9 @@ glm::vec3 JitterColorSampler::ComputeSampleCoordinate(SamplerState& state) const
     return gridCellOffset + gridCellSize * random;
 }
 
-std::unique_ptr<SamplerState> JitterColorSampler::CreateSampler(std::random_device& randomDevice, const int maxSamples, const int dimensions) const
+std::unique_ptr<SamplerState> JitterColorSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
 {
-    std::unique_ptr<JitterSamplerState> state = make_unique<JitterSamplerState>(randomDevice, maxSamples, dimensions);
+    std::unique_ptr<JitterSamplerState> state = make_unique<JitterSamplerState>(seed, maxSamples, dimensions);
     state->samplesPerCell = maxSamples / (gridSize.x * gridSize.y * gridSize.z);
     assert(state->samplesPerCell > 0);
     return std::move(state);
@@ -0,0 +1,113 @@
+#include "common/Sampling/Sobol/SobolColorSampler.h"
+
+namespace
+{
+const int SOBOL_DIMENSIONS = 3;
+const int SOBOL_BITS = 32;
+
+struct SobolDirections
+{
+    uint32_t vectors[SOBOL_DIMENSIONS][SOBOL_BITS];
+
+    SobolDirections()
+    {
+        // Dimension 0 is the van der Corput sequence; dimensions 1 and 2 use the primitive polynomials x + 1 and
+        // x^2 + x + 1 with the initial direction numbers of Joe and Kuo.
+        const int degrees[SOBOL_DIMENSIONS] = { 0, 1, 2 };
+        const uint32_t coefficients[SOBOL_DIMENSIONS] = { 0, 0, 1 };
+        const uint32_t initialNumbers[SOBOL_DIMENSIONS][2] = { { 1, 1 }, { 1, 1 }, { 1, 3 } };
+        for (int i = 0; i < SOBOL_BITS; ++i) {
+            vectors[0][i] = 1u << (SOBOL_BITS - 1 - i);
+        }
+        for (int d = 1; d < SOBOL_DIMENSIONS; ++d) {
+            const int degree = degrees[d];
+            for (int i = 0; i < degree; ++i) {
+                vectors[d][i] = initialNumbers[d][i] << (SOBOL_BITS - 1 - i);
+            }
+            for (int i = degree; i < SOBOL_BITS; ++i) {
+                uint32_t value = vectors[d][i - degree] ^ (vectors[d][i - degree] >> degree);
+                for (int k = 1; k < degree; ++k) {
+                    if ((coefficients[d] >> (degree - 1 - k)) & 1) {
+                        value ^= vectors[d][i - k];
+                    }
+                }
+                vectors[d][i] = value;
+            }
+        }
+    }
+};
+
+const SobolDirections sobolDirections;
+
+uint32_t ReverseBits(uint32_t value)
+{
+    value = (value << 16) | (value >> 16);
+    value = ((value & 0x00ff00ffu) << 8) | ((value & 0xff00ff00u) >> 8);
+    value = ((value & 0x0f0f0f0fu) << 4) | ((value & 0xf0f0f0f0u) >> 4);
+    value = ((value & 0x33333333u) << 2) | ((value & 0xccccccccu) >> 2);
+    value = ((value & 0x55555555u) << 1) | ((value & 0xaaaaaaaau) >> 1);
+    return value;
+}
+
+uint32_t ScrambleNestedUniform(uint32_t value, uint32_t seed)
+{
+    // Laine-Karras permutation on the reversed bits: every bit is flipped depending only on the bits above it.
+    value = ReverseBits(value);
+    value += seed;
+    value ^= value * 0x6c50b47cu;
+    value ^= value * 0xb82f1e52u;
+    value ^= value * 0xc7afe638u;
+    value ^= value * 0x8d22f6e6u;
+    return ReverseBits(value);
+}
+}
+
+std::unique_ptr<SamplerState> SobolColorSampler::CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const
+{
+    std::unique_ptr<SobolSamplerState> state = make_unique<SobolSamplerState>(seed, maxSamples, dimensions);
+    state->scrambleSeed = HashSeed(seed, 0x5eedu);
+    return std::move(state);
+}
+
+glm::vec3 SobolColorSampler::ComputeSampleCoordinate(SamplerState& state) const
+{
+    const uint32_t seed = static_cast<SobolSamplerState&>(state).scrambleSeed;
+    const uint32_t index = static_cast<uint32_t>(state.samplesComputed);
+    return glm::vec3(ComputeSobolSample(index, 0, seed), ComputeSobolSample(index, 1, seed), ComputeSobolSample(index, 2, seed));
+}
+
+bool SobolColorSampler::ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const
+{
+    // Scrambled like the sequence of a SamplerState with the key as its seed.
+    const uint32_t seed = HashSeed(key, 0x5eedu);
+    sample = glm::vec3(ComputeSobolSample(index, 0, seed), ComputeSobolSample(index, 1, seed), ComputeSobolSample(index, 2, seed));
+    return true;
+}
+
+float SobolColorSampler::ComputeSobolSample(uint32_t index, int dimension, uint32_t seed)
+{
+    assert(dimension >= 0 && dimension < SOBOL_DIMENSIONS);
+    uint32_t value = 0;
+    for (int bit = 0; index; ++bit, index >>= 1) {
+        if (index & 1) {
+            value ^= sobolDirections.vectors[dimension][bit];
+        }
+    }
+    if (seed) {
+        value = ScrambleNestedUniform(value, HashSeed(seed, static_cast<uint32_t>(dimension)));
+    }
+    // Keep the top 24 bits so that the result stays below 1 as a float.
+    return static_cast<float>(value >> 8) * (1.f / 16777216.f);
+}
+
+uint32_t SobolColorSampler::HashSeed(uint32_t seed, uint32_t value)
+{
+    // Murmur3 finalizer over the combined values.
+    uint32_t hash = seed ^ (value * 0x9e3779b9u);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
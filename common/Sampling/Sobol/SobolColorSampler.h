@@ -0,0 +1,31 @@
+#pragma once
+
+#include "common/Sampling/ColorSampler.h"
+
+struct SobolSamplerState : public SamplerState
+{
+    SobolSamplerState(uint32_t inputSeed, int inputMax, int inputDim) :
+        SamplerState(inputSeed, inputMax, inputDim), scrambleSeed(0)
+    {
+    }
+
+    uint32_t scrambleSeed;
+};
+
+// Owen-scrambled Sobol points: every power-of-two prefix of a pixel's samples is stratified in each dimension and in
+// every pair of the first two dimensions, and the scrambling (Burley 2020, hash-based nested uniform scrambling)
+// randomizes each pixel's sequence without giving that up. Samples continue from samplesComputed, so callers that
+// resume a pixel keep the stratification of the earlier samples.
+class SobolColorSampler : public ColorSampler
+{
+public:
+    virtual std::unique_ptr<SamplerState> CreateSampler(uint32_t seed, const int maxSamples, const int dimensions) const override;
+    virtual glm::vec3 ComputeSampleCoordinate(SamplerState& state) const override;
+    virtual bool ComputeSequenceSample(uint32_t key, uint32_t index, glm::vec3& sample) const override;
+
+    // Dimension is 0, 1 or 2. A seed of 0 leaves the sequence unscrambled.
+    static float ComputeSobolSample(uint32_t index, int dimension, uint32_t seed);
+
+protected:
+    static uint32_t HashSeed(uint32_t seed, uint32_t value);
+};
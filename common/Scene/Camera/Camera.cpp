@@ -1,5 +1,34 @@
 #include "common/Scene/Camera/Camera.h"
+#include "common/Scene/Camera/CameraRayBatch.h"
 
 Camera::Camera()
 {
+}
+
+void Camera::GenerateRays(const glm::vec2* coordinates, int count, CameraRayBatch& output) const
+{
+    assert(count <= CameraRayBatch::MAX_RAYS);
+    for (int i = 0; i < count; ++i) {
+        std::shared_ptr<Ray> ray = GenerateRayForNormalizedCoordinates(coordinates[i]);
+        assert(ray);
+        output.SetRay(i, *ray.get());
+    }
+}
+
+Ray Camera::GenerateRay(glm::vec2 coordinate) const
+{
+    CameraRayBatch batch;
+    GenerateRays(&coordinate, 1, batch);
+    return batch.GetRay(0);
+}
+
+glm::vec2 Camera::ComputeNormalizedSampleCoordinates(int column, int row, glm::vec3 sample, int samplesPerPixel, glm::vec2 resolution)
+{
+    const glm::vec3 minRange(-0.5f, -0.5f, 0.f);
+    const glm::vec3 maxRange(0.5f, 0.5f, 0.f);
+    const glm::vec3 sampleOffset = (samplesPerPixel == 1) ? glm::vec3(0.f, 0.f, 0.f) : minRange + (maxRange - minRange) * sample;
+
+    glm::vec2 normalizedCoordinates(static_cast<float>(column) + sampleOffset.x, static_cast<float>(row) + sampleOffset.y);
+    normalizedCoordinates /= resolution;
+    return normalizedCoordinates;
 }
\ No newline at end of file
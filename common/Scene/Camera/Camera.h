@@ -8,4 +8,13 @@ public:
     Camera();
 
     virtual std::shared_ptr<class Ray> GenerateRayForNormalizedCoordinates(glm::vec2 coordinate) const = 0;
+
+    // Writes the rays for coordinates[0, count) into rays 0 to count - 1 of output; count is at most CameraRayBatch::MAX_RAYS.
+    // Cameras without a batched path generate the rays one at a time.
+    virtual void GenerateRays(const glm::vec2* coordinates, int count, struct CameraRayBatch& output) const;
+    // Single ray through GenerateRays, without the allocation of GenerateRayForNormalizedCoordinates.
+    class Ray GenerateRay(glm::vec2 coordinate) const;
+
+    // Maps a sample from the ColorSampler to normalized image coordinates inside the given pixel. Single sample renders always use the pixel center.
+    static glm::vec2 ComputeNormalizedSampleCoordinates(int column, int row, glm::vec3 sample, int samplesPerPixel, glm::vec2 resolution);
 };
\ No newline at end of file
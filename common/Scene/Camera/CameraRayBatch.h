@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+
+// Camera rays of up to MAX_RAYS samples, e.g. one packet or one chunk of a tile, filled by Camera::GenerateRays. Kept on
+// the caller's stack and laid out one component per array so that cameras can generate several rays at once.
+struct CameraRayBatch
+{
+    static const int MAX_RAYS = 64;
+
+    Ray GetRay(int index) const
+    {
+        return Ray(glm::vec3(originX[index], originY[index], originZ[index]), glm::vec3(directionX[index], directionY[index], directionZ[index]), maxT[index]);
+    }
+
+    void SetRay(int index, const Ray& ray)
+    {
+        const glm::vec4 position = ray.GetPosition();
+        const glm::vec3 direction = ray.GetRayDirection();
+        originX[index] = position.x;
+        originY[index] = position.y;
+        originZ[index] = position.z;
+        directionX[index] = direction.x;
+        directionY[index] = direction.y;
+        directionZ[index] = direction.z;
+        maxT[index] = ray.GetMaxT();
+    }
+
+    alignas(16) std::array<float, MAX_RAYS> originX;
+    alignas(16) std::array<float, MAX_RAYS> originY;
+    alignas(16) std::array<float, MAX_RAYS> originZ;
+    // Normalized.
+    alignas(16) std::array<float, MAX_RAYS> directionX;
+    alignas(16) std::array<float, MAX_RAYS> directionY;
+    alignas(16) std::array<float, MAX_RAYS> directionZ;
+    alignas(16) std::array<float, MAX_RAYS> maxT;
+};
\ No newline at end of file
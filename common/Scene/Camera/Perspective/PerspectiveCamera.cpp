@@ -1,31 +1,42 @@
 #include "common/Scene/Camera/Perspective/PerspectiveCamera.h"
+#include "common/Scene/Camera/CameraRayBatch.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
 
 PerspectiveCamera::PerspectiveCamera(float aspectRatio, float inputFov):
     aspectRatio(aspectRatio), fov(inputFov * PI / 180.f), zNear(0.f), zFar(std::numeric_limits<float>::max())
 {
+    UpdateImagePlane();
 }
 
 std::shared_ptr<Ray> PerspectiveCamera::GenerateRayForNormalizedCoordinates(glm::vec2 coordinate) const
 {
-    // Send ray from the camera to the image plane -- make the assumption that the image plane is at z = 1 in camera space.
-    const glm::vec3 rayOrigin = glm::vec3(GetPosition());
-
-    // Figure out where the ray is supposed to point to. 
-    // Imagine that a frustum exists in front of the camera (which we assume exists at a singular point).
-    // Then, given the aspect ratio and vertical field of view we can determine where in the world the 
-    // image plane will exist and how large it is assuming we know for sure that z = 1 (this is fairly arbitrary for now).
-    const float planeHeight = std::tan(fov / 2.f) * 2.f;
-    const float planeWidth = planeHeight * aspectRatio;
+    CameraRayBatch batch;
+    GenerateRays(&coordinate, 1, batch);
+    return std::make_shared<Ray>(batch.GetRay(0));
+}
 
-    // Assume that (0, 0) is the top left of the image which means that when coordinate is (0.5, 0.5) the 
+void PerspectiveCamera::GenerateRays(const glm::vec2* coordinates, int count, CameraRayBatch& output) const
+{
+    assert(count <= CameraRayBatch::MAX_RAYS);
+    // Assume that (0, 0) is the top left of the image which means that when coordinate is (0.5, 0.5) the
     // pixel is directly in front of the camera...
-    const float xOffset = planeWidth * (coordinate.x - 0.5f);
-    const float yOffset = -1.f * planeHeight  * (coordinate.y - 0.5f);
-    const glm::vec3 targetPosition = rayOrigin + glm::vec3(GetForwardDirection()) + glm::vec3(GetRightDirection()) * xOffset + glm::vec3(GetUpDirection()) * yOffset;
+    const float maxT = zFar - zNear;
+    for (int i = 0; i < count; ++i) {
+        const float xOffset = coordinates[i].x - 0.5f;
+        const float yOffset = 0.5f - coordinates[i].y;
+        const float directionX = forwardDirection.x + planeRight.x * xOffset + planeUp.x * yOffset;
+        const float directionY = forwardDirection.y + planeRight.y * xOffset + planeUp.y * yOffset;
+        const float directionZ = forwardDirection.z + planeRight.z * xOffset + planeUp.z * yOffset;
+        const float inverseLength = 1.f / std::sqrt(directionX * directionX + directionY * directionY + directionZ * directionZ);
 
-    const glm::vec3 rayDirection = glm::normalize(targetPosition - rayOrigin);
-    return std::make_shared<Ray>(rayOrigin + rayDirection * zNear, rayDirection, zFar - zNear);
+        output.directionX[i] = directionX * inverseLength;
+        output.directionY[i] = directionY * inverseLength;
+        output.directionZ[i] = directionZ * inverseLength;
+        output.originX[i] = cameraPosition.x + output.directionX[i] * zNear;
+        output.originY[i] = cameraPosition.y + output.directionY[i] * zNear;
+        output.originZ[i] = cameraPosition.z + output.directionZ[i] * zNear;
+        output.maxT[i] = maxT;
+    }
 }
 
 void PerspectiveCamera::SetZNear(float input)
@@ -36,4 +47,25 @@ void PerspectiveCamera::SetZNear(float input)
 void PerspectiveCamera::SetZFar(float input)
 {
     zFar = input;
+}
+
+void PerspectiveCamera::UpdateTransformationMatrix()
+{
+    Camera::UpdateTransformationMatrix();
+    UpdateImagePlane();
+}
+
+void PerspectiveCamera::UpdateImagePlane()
+{
+    // Send rays from the camera to the image plane -- make the assumption that the image plane is at z = 1 in camera space.
+    // Imagine that a frustum exists in front of the camera (which we assume exists at a singular point).
+    // Then, given the aspect ratio and vertical field of view we can determine where in the world the
+    // image plane will exist and how large it is assuming we know for sure that z = 1 (this is fairly arbitrary for now).
+    const float planeHeight = std::tan(fov / 2.f) * 2.f;
+    const float planeWidth = planeHeight * aspectRatio;
+
+    cameraPosition = glm::vec3(GetPosition());
+    forwardDirection = glm::vec3(GetForwardDirection());
+    planeRight = glm::vec3(GetRightDirection()) * planeWidth;
+    planeUp = glm::vec3(GetUpDirection()) * planeHeight;
 }
\ No newline at end of file
@@ -8,14 +8,27 @@ public:
     // inputFov is in degrees. 
     PerspectiveCamera(float aspectRatio, float inputFov);
     virtual std::shared_ptr<class Ray> GenerateRayForNormalizedCoordinates(glm::vec2 coordinate) const override;
+    virtual void GenerateRays(const glm::vec2* coordinates, int count, struct CameraRayBatch& output) const override;
 
     void SetZNear(float input);
     void SetZFar(float input);
 
+protected:
+    virtual void UpdateTransformationMatrix() override;
+
 private:
+    // Recomputes the cached image plane and basis below; called whenever the camera moves, rotates or changes its lens.
+    void UpdateImagePlane();
+
     float aspectRatio;
     float fov; // fov is stored as radians
 
     float zNear;
     float zFar;
+
+    glm::vec3 cameraPosition;
+    glm::vec3 forwardDirection;
+    // Right and up, scaled to the width and height of the image plane at distance 1.
+    glm::vec3 planeRight;
+    glm::vec3 planeUp;
 };
\ No newline at end of file
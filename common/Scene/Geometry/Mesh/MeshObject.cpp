@@ -1,17 +1,21 @@
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
 #include "common/Acceleration/AccelerationCommon.h"
 #include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Scene/Geometry/Primitives/Compressed/CompressedPrimitive.h"
+#include "common/Scene/Geometry/Primitives/Displaced/DisplacedTriangle.h"
+#include "common/Scene/Geometry/Primitives/Displaced/TessellationCache.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
 #include "common/Scene/SceneObject.h"
 #include "common/Intersection/IntersectionState.h"
 
 MeshObject::MeshObject() :
-    storedMaterial(nullptr)
+    compressGeometry(false), displacementApplied(false), storedMaterial(nullptr)
 {
 }
 
 MeshObject::MeshObject(std::shared_ptr<Material> inputMaterial) :
-    storedMaterial(std::move(inputMaterial))
+    compressGeometry(false), displacementApplied(false), storedMaterial(std::move(inputMaterial))
 {
 }
 
@@ -24,8 +28,92 @@ void MeshObject::AddPrimitive(std::shared_ptr<PrimitiveBase> newPrimitive)
     elements.emplace_back(std::move(newPrimitive));
 }
 
+void MeshObject::SetCompressedGeometry(bool enable)
+{
+    compressGeometry = enable;
+}
+
+void MeshObject::CompressPrimitives()
+{
+    // The quantization ranges cover every vertex based primitive in the mesh so that shared vertices stay watertight.
+    Box positionBounds;
+    positionBounds.Reset();
+    glm::vec2 minUV(std::numeric_limits<float>::max());
+    glm::vec2 maxUV(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        for (int v = 0; v < elements[i]->GetTotalVertices(); ++v) {
+            positionBounds.minVertex = glm::min(positionBounds.minVertex, elements[i]->GetVertexPosition(v));
+            positionBounds.maxVertex = glm::max(positionBounds.maxVertex, elements[i]->GetVertexPosition(v));
+            if (elements[i]->HasVertexUVs()) {
+                minUV = glm::min(minUV, elements[i]->GetVertexUV(v));
+                maxUV = glm::max(maxUV, elements[i]->GetVertexUV(v));
+            }
+        }
+    }
+    if (minUV.x > maxUV.x) {
+        minUV = maxUV = glm::vec2(0.f);
+    }
+    compressedFrame = make_unique<CompressedGeometryFrame>(positionBounds, minUV, maxUV);
+
+    for (size_t i = 0; i < elements.size(); ++i) {
+        // Primitives without vertices (e.g. analytic ones) are already compact and are left alone.
+        switch (elements[i]->GetTotalVertices()) {
+        case 3:
+            elements[i] = std::make_shared<CompressedPrimitive<3>>(*elements[i], *compressedFrame);
+            break;
+        case 4:
+            elements[i] = std::make_shared<CompressedPrimitive<4>>(*elements[i], *compressedFrame);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void MeshObject::SetDisplacement(std::shared_ptr<Texture> displacementTexture, float displacementScale, int subdivisions, std::shared_ptr<TessellationCache> cache)
+{
+    std::shared_ptr<DisplacementSettings> newDisplacement = std::make_shared<DisplacementSettings>();
+    newDisplacement->texture = std::move(displacementTexture);
+    newDisplacement->scale = displacementScale;
+    newDisplacement->subdivisions = subdivisions;
+    newDisplacement->cache = cache ? std::move(cache) : TessellationCache::GetDefault();
+    displacement = std::move(newDisplacement);
+}
+
+void MeshObject::DisplacePrimitives()
+{
+    std::vector<std::shared_ptr<PrimitiveBase>> displacedElements;
+    displacedElements.reserve(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const int totalVertices = elements[i]->GetTotalVertices();
+        if (totalVertices < 3) {
+            // Analytic and other vertex-less primitives are not displaced.
+            displacedElements.push_back(elements[i]);
+            continue;
+        }
+
+        for (int v = 1; v + 1 < totalVertices; ++v) {
+            displacedElements.push_back(std::make_shared<DisplacedTriangle>(elements[i], 0, v, v + 1, displacement));
+        }
+    }
+    elements = std::move(displacedElements);
+    displacementApplied = true;
+}
+
 void MeshObject::Finalize()
 {
+    if (compressGeometry && !compressedFrame) {
+        CompressPrimitives();
+    }
+
+    if (displacement && !displacementApplied) {
+        DisplacePrimitives();
+    }
+
+    if (storedMaterial) {
+        storedMaterial->Compile();
+    }
+
     boundingBox.Reset();
     for (size_t i = 0; i < elements.size(); ++i) {
         elements[i]->Finalize();
@@ -46,6 +134,16 @@ bool MeshObject::Trace(const SceneObject* parentObject, class Ray* inputRay, str
     return acceleration->Trace(parentObject, inputRay, outputIntersection);
 }
 
+const AccelerationStructure* MeshObject::GetNestedAcceleration(const SceneObject*& parentObject) const
+{
+    return acceleration.get();
+}
+
+uint64_t MeshObject::TracePacket(const SceneObject* parentObject, RayPacket& packet, uint64_t laneMask) const
+{
+    return acceleration->TracePacket(parentObject, packet, laneMask);
+}
+
 const Material* MeshObject::GetMaterial() const
 {
     return storedMaterial.get();
@@ -14,8 +14,18 @@ public:
     void SetName(const std::string& input);
     std::string GetName() const { return meshName; }
     void AddPrimitive(std::shared_ptr<class PrimitiveBase> newPrimitive);
+    size_t GetTotalPrimitives() const { return elements.size(); }
+    const class PrimitiveBase* GetPrimitive(size_t index) const { return elements[index].get(); }
     virtual void CreateAccelerationData(AccelerationTypes perObjectType);
 
+    // When enabled, triangles and quads are replaced with quantized copies at Finalize. See CompressedPrimitive.
+    void SetCompressedGeometry(bool enable);
+    const struct CompressedGeometryFrame* GetCompressedGeometryFrame() const { return compressedFrame.get(); }
+
+    // When set, every face is wrapped in a DisplacedTriangle at Finalize and tessellated lazily as rays reach it.
+    // Patches go into the given cache, or into TessellationCache::GetDefault() when none is given.
+    void SetDisplacement(std::shared_ptr<class Texture> displacementTexture, float displacementScale, int subdivisions, std::shared_ptr<class TessellationCache> cache = nullptr);
+
     virtual Box GetBoundingBox() const override
     {
         return boundingBox;
@@ -25,6 +35,8 @@ public:
     virtual const class Material* GetMaterial() const;
 
     virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual const class AccelerationStructure* GetNestedAcceleration(const class SceneObject*& parentObject) const override;
+    virtual uint64_t TracePacket(const class SceneObject* parentObject, struct RayPacket& packet, uint64_t laneMask) const override;
 
     friend class SceneObject;
 protected:
@@ -33,6 +45,14 @@ protected:
 
     class std::shared_ptr<class AccelerationStructure> acceleration;
 
+    void CompressPrimitives();
+    bool compressGeometry;
+    std::unique_ptr<struct CompressedGeometryFrame> compressedFrame;
+
+    void DisplacePrimitives();
+    std::shared_ptr<const struct DisplacementSettings> displacement;
+    bool displacementApplied;
+
 private:
     std::shared_ptr<class Material> storedMaterial;
     std::string meshName;
@@ -0,0 +1,103 @@
+#include "common/Scene/Geometry/Primitives/AnalyticPrimitive.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Textures/Texture.h"
+
+AnalyticPrimitive::AnalyticPrimitive(class MeshObject* inputParent):
+    parentMesh(inputParent)
+{
+}
+
+AnalyticPrimitive::~AnalyticPrimitive()
+{
+}
+
+void AnalyticPrimitive::Finalize()
+{
+    boundingBox = ComputeBoundingBox();
+}
+
+Box AnalyticPrimitive::GetBoundingBox() const
+{
+    return boundingBox;
+}
+
+const MeshObject* AnalyticPrimitive::GetParentMeshObject() const
+{
+    return parentMesh;
+}
+
+bool AnalyticPrimitive::HasNormalMap() const
+{
+    const Material* material = parentMesh->GetMaterial();
+    return (material && material->GetTexture(MaterialTextureSlot::NORMAL));
+}
+
+glm::vec3 AnalyticPrimitive::GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const
+{
+    assert(HasNormalMap());
+    const Material* material = parentMesh->GetMaterial();
+    Texture* normalTexture = material->GetTexture(MaterialTextureSlot::NORMAL);
+    glm::vec3 normalMap = glm::normalize(glm::vec3(normalTexture->Sample(uv)) * 2.f - 1.f);
+    return glm::mat3(worldTangent, worldBitangent, worldNormal) * normalMap;
+}
+
+glm::vec3 AnalyticPrimitive::ComputeIntersectionNormal(const IntersectionState& intersection) const
+{
+    const glm::vec3 objectPosition(intersection.primitiveIntersectionWeights[0], intersection.primitiveIntersectionWeights[1], intersection.primitiveIntersectionWeights[2]);
+
+    glm::vec3 normal, tangent, bitangent;
+    glm::vec2 uv;
+    ComputeSurfaceFrame(objectPosition, normal, tangent, bitangent, uv);
+
+    const glm::mat3& normalTransform = intersection.primitiveParent->GetNormalMatrix();
+    const glm::vec3 worldNormal = normalTransform * normal;
+    if (HasNormalMap()) {
+        return glm::normalize(GetVertexNormalMap(uv, normalTransform * tangent, normalTransform * bitangent, worldNormal));
+    }
+    return glm::normalize(worldNormal);
+}
+
+glm::vec2 AnalyticPrimitive::ComputeIntersectionUV(const IntersectionState& intersection) const
+{
+    const glm::vec3 objectPosition(intersection.primitiveIntersectionWeights[0], intersection.primitiveIntersectionWeights[1], intersection.primitiveIntersectionWeights[2]);
+
+    glm::vec3 normal, tangent, bitangent;
+    glm::vec2 uv;
+    ComputeSurfaceFrame(objectPosition, normal, tangent, bitangent, uv);
+    return uv;
+}
+
+bool AnalyticPrimitive::RecordIntersection(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection, float t, const glm::vec3& rayPos, const glm::vec3& rayDir) const
+{
+    if (t - inputRay->GetMaxT() > SMALL_EPSILON || t < -SMALL_EPSILON) {
+        return false;
+    }
+
+    if (outputIntersection) {
+        if (t - outputIntersection->intersectionT > SMALL_EPSILON) {
+            return false;
+        }
+        outputIntersection->intersectionRay = *inputRay;
+        outputIntersection->primitiveParent = parentObject;
+        outputIntersection->intersectionT = t;
+        outputIntersection->intersectedPrimitive = this;
+        outputIntersection->hasIntersection = true;
+
+        const glm::vec3 objectPosition = rayPos + t * rayDir;
+        for (int i = 0; i < 3; ++i) {
+            outputIntersection->primitiveIntersectionWeights[i] = objectPosition[i];
+        }
+    }
+    return true;
+}
+
+void AnalyticPrimitive::ComputeOrthonormalBasis(const glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent)
+{
+    const glm::vec3 helper = (std::abs(normal.x) > 0.9f) ? glm::vec3(0.f, 1.f, 0.f) : glm::vec3(1.f, 0.f, 0.f);
+    tangent = glm::normalize(glm::cross(helper, normal));
+    bitangent = glm::cross(normal, tangent);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+
+// Base class for primitives that are described by an implicit surface rather than a list of vertices.
+// Their normals, tangents and UVs are evaluated exactly at the hit point instead of being interpolated.
+class AnalyticPrimitive : public PrimitiveBase
+{
+public:
+    AnalyticPrimitive(class MeshObject* inputParent);
+    virtual ~AnalyticPrimitive();
+
+    // Vertex attributes do not apply to analytic surfaces.
+    virtual void SetVertexPosition(int index, glm::vec3 position) override {}
+    virtual void SetVertexNormal(int index, glm::vec3 normal) override {}
+    virtual void SetVertexUV(int index, glm::vec2 uv) override {}
+    virtual void SetVertexTangentBitangent(int index, glm::vec3 tangent, glm::vec3 bitangent) override {}
+    virtual int GetTotalVertices() const override { return 0; }
+    virtual glm::vec3 GetVertexPosition(int index) const override { return glm::vec3(); }
+    virtual bool HasVertexNormals() const override { return false; }
+    virtual bool HasVertexUVs() const override { return false; }
+    virtual bool HasVertexTangentBitangents() const override { return false; }
+    virtual glm::vec3 GetVertexNormal(int index) const override { return glm::vec3(); }
+    virtual glm::vec2 GetVertexUV(int index) const override { return glm::vec2(); }
+    virtual glm::vec3 GetVertexTangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetVertexBitangent(int index) const override { return glm::vec3(); }
+
+    virtual void Finalize() override;
+    virtual Box GetBoundingBox() const override;
+    virtual const class MeshObject* GetParentMeshObject() const override;
+
+    virtual bool HasNormalMap() const override;
+    virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const override;
+
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const override;
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const override;
+
+protected:
+    // Computes the object space shading frame and texture coordinates for a point on the surface.
+    virtual void ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const = 0;
+    virtual Box ComputeBoundingBox() const = 0;
+
+    // Common hit handling for subclasses. rayPos/rayDir are the object space ray used to compute t.
+    bool RecordIntersection(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection, float t, const glm::vec3& rayPos, const glm::vec3& rayDir) const;
+
+    // Builds an arbitrary orthonormal tangent frame around the given normal.
+    static void ComputeOrthonormalBasis(const glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent);
+
+    Box boundingBox;
+private:
+    const class MeshObject* parentMesh;
+};
@@ -0,0 +1,270 @@
+#include "common/Scene/Geometry/Primitives/Compressed/CompressedPrimitive.h"
+#include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
+#include "common/Scene/Geometry/Primitives/Quad/Quad.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Textures/Texture.h"
+#include "common/Intersection/IntersectionState.h"
+
+namespace
+{
+const float MAX_UNSIGNED_QUANTIZED = 65535.f;
+const float MAX_SIGNED_QUANTIZED = 32767.f;
+
+uint16_t QuantizeUnit(float value)
+{
+    return static_cast<uint16_t>(std::round(glm::clamp(value, 0.f, 1.f) * MAX_UNSIGNED_QUANTIZED));
+}
+
+float SafeInverse(float extent)
+{
+    return (extent > 0.f) ? 1.f / extent : 0.f;
+}
+
+glm::vec2 SignNotZero(const glm::vec2& v)
+{
+    return glm::vec2((v.x >= 0.f) ? 1.f : -1.f, (v.y >= 0.f) ? 1.f : -1.f);
+}
+
+// Overloads so that the templated primitive can reuse the uncompressed intersection code.
+bool IntersectCorners(const std::array<glm::vec3, 3>& positions, const PrimitiveBase* hitPrimitive, const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection)
+{
+    return Triangle::Intersect(positions, hitPrimitive, parentObject, inputRay, outputIntersection);
+}
+
+bool IntersectCorners(const std::array<glm::vec3, 4>& positions, const PrimitiveBase* hitPrimitive, const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection)
+{
+    return Quad::Intersect(positions, hitPrimitive, parentObject, inputRay, outputIntersection);
+}
+
+glm::vec3 ComputeCornersNormal(const std::array<glm::vec3, 3>& positions)
+{
+    return Triangle::ComputeFaceNormal(positions);
+}
+
+glm::vec3 ComputeCornersNormal(const std::array<glm::vec3, 4>& positions)
+{
+    return Quad::ComputeFaceNormal(positions);
+}
+}
+
+CompressedGeometryFrame::CompressedGeometryFrame(const Box& positionBounds, glm::vec2 minUV, glm::vec2 maxUV):
+    positionOrigin(positionBounds.minVertex), positionExtent(positionBounds.maxVertex - positionBounds.minVertex),
+    uvOrigin(minUV), uvExtent(maxUV - minUV)
+{
+}
+
+std::array<uint16_t, 3> CompressedGeometryFrame::EncodePosition(const glm::vec3& position) const
+{
+    const glm::vec3 offset = position - positionOrigin;
+    return {
+        QuantizeUnit(offset.x * SafeInverse(positionExtent.x)),
+        QuantizeUnit(offset.y * SafeInverse(positionExtent.y)),
+        QuantizeUnit(offset.z * SafeInverse(positionExtent.z))
+    };
+}
+
+glm::vec3 CompressedGeometryFrame::DecodePosition(const std::array<uint16_t, 3>& encoded) const
+{
+    return positionOrigin + glm::vec3(encoded[0], encoded[1], encoded[2]) * (positionExtent / MAX_UNSIGNED_QUANTIZED);
+}
+
+std::array<uint16_t, 2> CompressedGeometryFrame::EncodeUV(const glm::vec2& uv) const
+{
+    const glm::vec2 offset = uv - uvOrigin;
+    return {
+        QuantizeUnit(offset.x * SafeInverse(uvExtent.x)),
+        QuantizeUnit(offset.y * SafeInverse(uvExtent.y))
+    };
+}
+
+glm::vec2 CompressedGeometryFrame::DecodeUV(const std::array<uint16_t, 2>& encoded) const
+{
+    return uvOrigin + glm::vec2(encoded[0], encoded[1]) * (uvExtent / MAX_UNSIGNED_QUANTIZED);
+}
+
+std::array<int16_t, 2> CompressedGeometryFrame::EncodeDirection(const glm::vec3& direction)
+{
+    const float manhattanLength = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (manhattanLength <= 0.f) {
+        return { 0, 0 };
+    }
+
+    // Project onto the octahedron and fold the lower hemisphere over the diagonals.
+    glm::vec2 projected = glm::vec2(direction.x, direction.y) / manhattanLength;
+    if (direction.z < 0.f) {
+        projected = (1.f - glm::abs(glm::vec2(projected.y, projected.x))) * SignNotZero(projected);
+    }
+    projected = glm::clamp(projected, -1.f, 1.f);
+    return {
+        static_cast<int16_t>(std::round(projected.x * MAX_SIGNED_QUANTIZED)),
+        static_cast<int16_t>(std::round(projected.y * MAX_SIGNED_QUANTIZED))
+    };
+}
+
+glm::vec3 CompressedGeometryFrame::DecodeDirection(const std::array<int16_t, 2>& encoded)
+{
+    const glm::vec2 projected = glm::vec2(encoded[0], encoded[1]) / MAX_SIGNED_QUANTIZED;
+    glm::vec3 direction(projected.x, projected.y, 1.f - std::abs(projected.x) - std::abs(projected.y));
+    if (direction.z < 0.f) {
+        const glm::vec2 unfolded = (1.f - glm::abs(glm::vec2(direction.y, direction.x))) * SignNotZero(projected);
+        direction.x = unfolded.x;
+        direction.y = unfolded.y;
+    }
+    return glm::normalize(direction);
+}
+
+template<int N>
+CompressedPrimitive<N>::CompressedPrimitive(const PrimitiveBase& source, const CompressedGeometryFrame& frame):
+    attributeFlags(0), parentMesh(source.GetParentMeshObject())
+{
+    static_assert(N <= IntersectionState::MAX_PRIMITIVE_VERTICES, "Hit records cannot hold the weights for this primitive.");
+    assert(source.GetTotalVertices() == N);
+
+    if (source.HasVertexNormals()) {
+        attributeFlags |= HAS_NORMALS;
+    }
+    if (source.HasVertexUVs()) {
+        attributeFlags |= HAS_UVS;
+    }
+    if (source.HasVertexTangentBitangents()) {
+        attributeFlags |= HAS_TANGENT_BITANGENTS;
+    }
+
+    for (int i = 0; i < N; ++i) {
+        positions[i] = frame.EncodePosition(source.GetVertexPosition(i));
+        normals[i] = CompressedGeometryFrame::EncodeDirection(source.GetVertexNormal(i));
+        tangents[i] = CompressedGeometryFrame::EncodeDirection(source.GetVertexTangent(i));
+        bitangents[i] = CompressedGeometryFrame::EncodeDirection(source.GetVertexBitangent(i));
+        uvs[i] = frame.EncodeUV(source.GetVertexUV(i));
+    }
+}
+
+template<int N>
+Box CompressedPrimitive<N>::GetBoundingBox() const
+{
+    Box boundingBox;
+    boundingBox.Reset();
+    const std::array<glm::vec3, N> decoded = DecodePositions();
+    for (int i = 0; i < N; ++i) {
+        boundingBox.maxVertex = glm::max(boundingBox.maxVertex, decoded[i]);
+        boundingBox.minVertex = glm::min(boundingBox.minVertex, decoded[i]);
+    }
+    return boundingBox;
+}
+
+template<int N>
+bool CompressedPrimitive<N>::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    return IntersectCorners(DecodePositions(), this, parentObject, inputRay, outputIntersection);
+}
+
+template<int N>
+const MeshObject* CompressedPrimitive<N>::GetParentMeshObject() const
+{
+    return parentMesh;
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetVertexPosition(int index) const
+{
+    return GetFrame().DecodePosition(positions[index]);
+}
+
+template<int N>
+bool CompressedPrimitive<N>::HasVertexNormals() const
+{
+    return (attributeFlags & HAS_NORMALS) != 0;
+}
+
+template<int N>
+bool CompressedPrimitive<N>::HasVertexUVs() const
+{
+    return (attributeFlags & HAS_UVS) != 0;
+}
+
+template<int N>
+bool CompressedPrimitive<N>::HasVertexTangentBitangents() const
+{
+    return (attributeFlags & HAS_TANGENT_BITANGENTS) != 0;
+}
+
+template<int N>
+bool CompressedPrimitive<N>::HasNormalMap() const
+{
+    const Material* material = parentMesh->GetMaterial();
+    return material && HasVertexUVs() && material->GetTexture(MaterialTextureSlot::NORMAL);
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetVertexNormal(int index) const
+{
+    return CompressedGeometryFrame::DecodeDirection(normals[index]);
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const
+{
+    assert(HasNormalMap());
+    Texture* normalTexture = parentMesh->GetMaterial()->GetTexture(MaterialTextureSlot::NORMAL);
+    glm::vec3 normalMap = glm::normalize(glm::vec3(normalTexture->Sample(uv)) * 2.f - 1.f);
+    return glm::mat3(worldTangent, worldBitangent, worldNormal) * normalMap;
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetPrimitiveNormal() const
+{
+    return ComputeCornersNormal(DecodePositions());
+}
+
+template<int N>
+glm::vec2 CompressedPrimitive<N>::GetVertexUV(int index) const
+{
+    return GetFrame().DecodeUV(uvs[index]);
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetVertexTangent(int index) const
+{
+    return CompressedGeometryFrame::DecodeDirection(tangents[index]);
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::GetVertexBitangent(int index) const
+{
+    return CompressedGeometryFrame::DecodeDirection(bitangents[index]);
+}
+
+template<int N>
+glm::vec3 CompressedPrimitive<N>::ComputeIntersectionNormal(const IntersectionState& intersection) const
+{
+    return InterpolateIntersectionNormal(intersection);
+}
+
+template<int N>
+glm::vec2 CompressedPrimitive<N>::ComputeIntersectionUV(const IntersectionState& intersection) const
+{
+    return InterpolateIntersectionUV(intersection);
+}
+
+template<int N>
+std::array<glm::vec3, N> CompressedPrimitive<N>::DecodePositions() const
+{
+    const CompressedGeometryFrame& frame = GetFrame();
+    std::array<glm::vec3, N> decoded;
+    for (int i = 0; i < N; ++i) {
+        decoded[i] = frame.DecodePosition(positions[i]);
+    }
+    return decoded;
+}
+
+template<int N>
+const CompressedGeometryFrame& CompressedPrimitive<N>::GetFrame() const
+{
+    const CompressedGeometryFrame* frame = parentMesh->GetCompressedGeometryFrame();
+    assert(frame);
+    return *frame;
+}
+
+template class CompressedPrimitive<3>;
+template class CompressedPrimitive<4>;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+
+// Quantization ranges shared by all of the compressed primitives in a mesh.
+struct CompressedGeometryFrame
+{
+    CompressedGeometryFrame(const Box& positionBounds, glm::vec2 minUV, glm::vec2 maxUV);
+
+    std::array<uint16_t, 3> EncodePosition(const glm::vec3& position) const;
+    glm::vec3 DecodePosition(const std::array<uint16_t, 3>& encoded) const;
+
+    std::array<uint16_t, 2> EncodeUV(const glm::vec2& uv) const;
+    glm::vec2 DecodeUV(const std::array<uint16_t, 2>& encoded) const;
+
+    // Unit vectors are mapped onto an octahedron and stored as two signed 16-bit values.
+    static std::array<int16_t, 2> EncodeDirection(const glm::vec3& direction);
+    static glm::vec3 DecodeDirection(const std::array<int16_t, 2>& encoded);
+
+    glm::vec3 positionOrigin;
+    glm::vec3 positionExtent;
+    glm::vec2 uvOrigin;
+    glm::vec2 uvExtent;
+};
+
+// Compact copy of a triangle or quad. Positions are stored as 16-bit offsets inside the mesh bounds, UVs as 16-bit
+// offsets inside the mesh's UV bounds and normals/tangents/bitangents as octahedral directions. Everything is
+// decoded on demand, so this is meant for meshes whose shading data does not fit in cache.
+template<int N>
+class CompressedPrimitive : public PrimitiveBase
+{
+public:
+    CompressedPrimitive(const PrimitiveBase& source, const CompressedGeometryFrame& frame);
+
+    // Compressed primitives are immutable, so the vertex setters do nothing.
+    virtual void SetVertexPosition(int index, glm::vec3 position) override {}
+    virtual void SetVertexNormal(int index, glm::vec3 normal) override {}
+    virtual void SetVertexUV(int index, glm::vec2 uv) override {}
+    virtual void SetVertexTangentBitangent(int index, glm::vec3 tangent, glm::vec3 bitangent) override {}
+    virtual int GetTotalVertices() const override { return N; }
+    virtual void Finalize() override {}
+
+    virtual Box GetBoundingBox() const override;
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual const class MeshObject* GetParentMeshObject() const override;
+
+    virtual glm::vec3 GetVertexPosition(int index) const override;
+    virtual bool HasVertexNormals() const override;
+    virtual bool HasVertexUVs() const override;
+    virtual bool HasVertexTangentBitangents() const override;
+    virtual bool HasNormalMap() const override;
+    virtual glm::vec3 GetVertexNormal(int index) const override;
+    virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+    virtual glm::vec2 GetVertexUV(int index) const override;
+    virtual glm::vec3 GetVertexTangent(int index) const override;
+    virtual glm::vec3 GetVertexBitangent(int index) const override;
+
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const override;
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const override;
+
+private:
+    enum AttributeFlags : uint8_t
+    {
+        HAS_NORMALS = 1 << 0,
+        HAS_UVS = 1 << 1,
+        HAS_TANGENT_BITANGENTS = 1 << 2
+    };
+
+    std::array<glm::vec3, N> DecodePositions() const;
+    const CompressedGeometryFrame& GetFrame() const;
+
+    std::array<std::array<uint16_t, 3>, N> positions;
+    std::array<std::array<int16_t, 2>, N> normals;
+    std::array<std::array<int16_t, 2>, N> tangents;
+    std::array<std::array<int16_t, 2>, N> bitangents;
+    std::array<std::array<uint16_t, 2>, N> uvs;
+    uint8_t attributeFlags;
+
+    const class MeshObject* parentMesh;
+};
+
+extern template class CompressedPrimitive<3>;
+extern template class CompressedPrimitive<4>;
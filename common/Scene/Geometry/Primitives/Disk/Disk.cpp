@@ -0,0 +1,65 @@
+#include "common/Scene/Geometry/Primitives/Disk/Disk.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+
+Disk::Disk(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, float inputRadius, float inputInnerRadius):
+    AnalyticPrimitive(inputParent), center(inputCenter), diskNormal(glm::normalize(inputNormal)), radius(inputRadius), innerRadius(inputInnerRadius)
+{
+    assert(radius > innerRadius && innerRadius >= 0.f);
+    ComputeOrthonormalBasis(diskNormal, diskTangent, diskBitangent);
+}
+
+glm::vec3 Disk::GetPrimitiveNormal() const
+{
+    return diskNormal;
+}
+
+bool Disk::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    DIAGNOSTICS_STAT(DiagnosticsType::ANALYTIC_INTERSECTIONS);
+    assert(parentObject);
+    // Convert ray into object space.
+    const glm::vec3 rayPos = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetPosition());
+    const glm::vec3 rayDir = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetForwardDirection());
+
+    const float NdD = glm::dot(diskNormal, rayDir);
+    if (NdD > -SMALL_EPSILON && NdD < SMALL_EPSILON) {
+        return false;
+    }
+
+    const float t = glm::dot(center - rayPos, diskNormal) / NdD;
+    const float distanceSquared = glm::length2(rayPos + t * rayDir - center);
+    if (distanceSquared > radius * radius || distanceSquared < innerRadius * innerRadius) {
+        return false;
+    }
+    return RecordIntersection(parentObject, inputRay, outputIntersection, t, rayPos, rayDir);
+}
+
+void Disk::ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const
+{
+    const glm::vec3 localPosition = objectPosition - center;
+    const float x = glm::dot(localPosition, diskTangent);
+    const float y = glm::dot(localPosition, diskBitangent);
+    const float distance = std::sqrt(x * x + y * y);
+    const float phi = std::atan2(y, x);
+
+    normal = diskNormal;
+    uv = glm::vec2(phi / (2.f * PI) + 0.5f, (distance - innerRadius) / (radius - innerRadius));
+
+    // Tangent follows increasing angle, bitangent points outwards.
+    if (distance < SMALL_EPSILON) {
+        tangent = diskTangent;
+        bitangent = diskBitangent;
+        return;
+    }
+    bitangent = localPosition / distance;
+    tangent = glm::cross(normal, bitangent);
+}
+
+Box Disk::ComputeBoundingBox() const
+{
+    // Extent of a disk along each axis is radius * sin(angle between the axis and the disk normal).
+    const glm::vec3 halfExtent = radius * glm::sqrt(glm::max(glm::vec3(1.f) - diskNormal * diskNormal, glm::vec3(0.f)));
+    return Box(center - halfExtent, center + halfExtent);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/AnalyticPrimitive.h"
+
+// Flat disk (or annulus when innerRadius is non-zero). U runs around the disk, V runs from the inner to the outer radius.
+class Disk : public AnalyticPrimitive
+{
+public:
+    Disk(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, float inputRadius, float inputInnerRadius = 0.f);
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+
+protected:
+    virtual void ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const override;
+    virtual Box ComputeBoundingBox() const override;
+
+private:
+    glm::vec3 center;
+    glm::vec3 diskNormal;
+    glm::vec3 diskTangent;
+    glm::vec3 diskBitangent;
+    float radius;
+    float innerRadius;
+};
@@ -0,0 +1,260 @@
+#include "common/Scene/Geometry/Primitives/Displaced/DisplacedTriangle.h"
+#include "common/Scene/Geometry/Primitives/Displaced/TessellationCache.h"
+#include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Acceleration/AccelerationCommon.h"
+#include "common/Acceleration/BVH/Internal/BVHNode.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Textures/Texture.h"
+
+namespace
+{
+// Minimal triangle used inside a tessellated patch. It only stores its displaced corners and their barycentric
+// coordinates on the base triangle, which it reports as its UVs; shading always goes through the DisplacedTriangle.
+class MicroTriangle : public PrimitiveBase
+{
+public:
+    MicroTriangle(const std::array<glm::vec3, 3>& inputPositions, const std::array<glm::vec2, 3>& inputBaseWeights):
+        positions(inputPositions), baseWeights(inputBaseWeights)
+    {
+    }
+
+    virtual void SetVertexPosition(int index, glm::vec3 position) override {}
+    virtual void SetVertexNormal(int index, glm::vec3 normal) override {}
+    virtual void SetVertexUV(int index, glm::vec2 uv) override {}
+    virtual void SetVertexTangentBitangent(int index, glm::vec3 tangent, glm::vec3 bitangent) override {}
+    virtual int GetTotalVertices() const override { return 3; }
+    virtual void Finalize() override {}
+    virtual const MeshObject* GetParentMeshObject() const override { return nullptr; }
+    virtual glm::vec3 GetVertexPosition(int index) const override { return positions[index]; }
+    virtual bool HasVertexNormals() const override { return false; }
+    virtual bool HasVertexUVs() const override { return true; }
+    virtual bool HasVertexTangentBitangents() const override { return false; }
+    virtual bool HasNormalMap() const override { return false; }
+    virtual glm::vec3 GetVertexNormal(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const override { return worldNormal; }
+    virtual glm::vec3 GetPrimitiveNormal() const override { return Triangle::ComputeFaceNormal(positions); }
+    virtual glm::vec2 GetVertexUV(int index) const override { return baseWeights[index]; }
+    virtual glm::vec3 GetVertexTangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetVertexBitangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 ComputeIntersectionNormal(const IntersectionState& intersection) const override { return InterpolateIntersectionNormal(intersection); }
+    virtual glm::vec2 ComputeIntersectionUV(const IntersectionState& intersection) const override { return InterpolateIntersectionUV(intersection); }
+
+    virtual Box GetBoundingBox() const override
+    {
+        Box boundingBox;
+        boundingBox.Reset();
+        for (int i = 0; i < 3; ++i) {
+            boundingBox.minVertex = glm::min(boundingBox.minVertex, positions[i]);
+            boundingBox.maxVertex = glm::max(boundingBox.maxVertex, positions[i]);
+        }
+        return boundingBox;
+    }
+
+    virtual bool Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const override
+    {
+        return Triangle::Intersect(positions, this, parentObject, inputRay, outputIntersection);
+    }
+
+private:
+    std::array<glm::vec3, 3> positions;
+    std::array<glm::vec2, 3> baseWeights;
+};
+}
+
+DisplacedTriangle::DisplacedTriangle(std::shared_ptr<PrimitiveBase> inputBase, int vertex0, int vertex1, int vertex2, std::shared_ptr<const DisplacementSettings> inputSettings):
+    base(std::move(inputBase)), vertexIndices({ { vertex0, vertex1, vertex2 } }), settings(std::move(inputSettings))
+{
+    assert(settings && settings->cache);
+}
+
+void DisplacedTriangle::Finalize()
+{
+    // Normals are unit length and heights are in [0, 1], so no point can move further than the displacement scale.
+    boundingBox.Reset();
+    for (int i = 0; i < 3; ++i) {
+        boundingBox.minVertex = glm::min(boundingBox.minVertex, base->GetVertexPosition(vertexIndices[i]));
+        boundingBox.maxVertex = glm::max(boundingBox.maxVertex, base->GetVertexPosition(vertexIndices[i]));
+    }
+    // Box::Expand grows along the diagonal, which would leave flat patches without any room to displace into.
+    const glm::vec3 expansion(std::abs(settings->scale) + SMALL_EPSILON);
+    boundingBox.minVertex -= expansion;
+    boundingBox.maxVertex += expansion;
+}
+
+Box DisplacedTriangle::GetBoundingBox() const
+{
+    return boundingBox;
+}
+
+const MeshObject* DisplacedTriangle::GetParentMeshObject() const
+{
+    return base->GetParentMeshObject();
+}
+
+glm::vec3 DisplacedTriangle::GetPrimitiveNormal() const
+{
+    return Triangle::ComputeFaceNormal({ { base->GetVertexPosition(vertexIndices[0]), base->GetVertexPosition(vertexIndices[1]), base->GetVertexPosition(vertexIndices[2]) } });
+}
+
+bool DisplacedTriangle::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    const TessellatedPatch& patch = settings->cache->Acquire(*this);
+    if (!outputIntersection) {
+        return patch.acceleration->Trace(parentObject, inputRay, nullptr);
+    }
+
+    IntersectionState microIntersection;
+    microIntersection.intersectionT = outputIntersection->intersectionT;
+    if (!patch.acceleration->Trace(parentObject, inputRay, &microIntersection)) {
+        return false;
+    }
+
+    // The micro triangles report the barycentric coordinates of the base triangle as their UVs.
+    const glm::vec2 baseWeights = microIntersection.ComputeUV();
+    outputIntersection->intersectionRay = *inputRay;
+    outputIntersection->primitiveParent = parentObject;
+    outputIntersection->intersectionT = microIntersection.intersectionT;
+    outputIntersection->intersectedPrimitive = this;
+    outputIntersection->hasIntersection = true;
+    outputIntersection->primitiveIntersectionWeights[0] = 1.f - baseWeights.x - baseWeights.y;
+    outputIntersection->primitiveIntersectionWeights[1] = baseWeights.x;
+    outputIntersection->primitiveIntersectionWeights[2] = baseWeights.y;
+    return true;
+}
+
+bool DisplacedTriangle::HasNormalMap() const
+{
+    const Material* material = GetParentMeshObject()->GetMaterial();
+    return (material && base->HasVertexUVs() && material->GetTexture(MaterialTextureSlot::NORMAL));
+}
+
+glm::vec3 DisplacedTriangle::GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const
+{
+    assert(HasNormalMap());
+    Texture* normalTexture = GetParentMeshObject()->GetMaterial()->GetTexture(MaterialTextureSlot::NORMAL);
+    glm::vec3 normalMap = glm::normalize(glm::vec3(normalTexture->Sample(uv)) * 2.f - 1.f);
+    return glm::mat3(worldTangent, worldBitangent, worldNormal) * normalMap;
+}
+
+glm::vec3 DisplacedTriangle::ComputeIntersectionNormal(const IntersectionState& intersection) const
+{
+    const glm::vec3 weights(intersection.primitiveIntersectionWeights[0], intersection.primitiveIntersectionWeights[1], intersection.primitiveIntersectionWeights[2]);
+
+    // Differentiate the displaced surface with central differences about a quarter of a micro triangle wide, so the
+    // shading normal follows the height texture rather than the facets of the tessellation.
+    const float delta = 0.25f / static_cast<float>(std::max(settings->subdivisions, 1));
+    const glm::vec3 dSurfaceDb1 = (EvaluateSurface(weights.y + delta, weights.z) - EvaluateSurface(weights.y - delta, weights.z)) / (2.f * delta);
+    const glm::vec3 dSurfaceDb2 = (EvaluateSurface(weights.y, weights.z + delta) - EvaluateSurface(weights.y, weights.z - delta)) / (2.f * delta);
+
+    const glm::vec3 baseNormal = InterpolateNormal(weights);
+    glm::vec3 displacedNormal = glm::cross(dSurfaceDb1, dSurfaceDb2);
+    if (glm::length(displacedNormal) < SMALL_EPSILON) {
+        displacedNormal = baseNormal;
+    } else if (glm::dot(displacedNormal, baseNormal) < 0.f) {
+        displacedNormal = -displacedNormal;
+    }
+
+    const glm::mat3& normalTransform = intersection.primitiveParent->GetNormalMatrix();
+    const glm::vec3 worldNormal = glm::normalize(normalTransform * displacedNormal);
+    if (HasNormalMap() && base->HasVertexTangentBitangents()) {
+        glm::vec3 retTangent;
+        glm::vec3 retBitangent;
+        for (int i = 0; i < 3; ++i) {
+            retTangent += weights[i] * normalTransform * base->GetVertexTangent(vertexIndices[i]);
+            retBitangent += weights[i] * normalTransform * base->GetVertexBitangent(vertexIndices[i]);
+        }
+        return glm::normalize(GetVertexNormalMap(ComputeIntersectionUV(intersection), retTangent, retBitangent, worldNormal));
+    }
+    return worldNormal;
+}
+
+glm::vec2 DisplacedTriangle::ComputeIntersectionUV(const IntersectionState& intersection) const
+{
+    return InterpolateUV(glm::vec3(intersection.primitiveIntersectionWeights[0], intersection.primitiveIntersectionWeights[1], intersection.primitiveIntersectionWeights[2]));
+}
+
+std::shared_ptr<TessellatedPatch> DisplacedTriangle::Tessellate(size_t& outputBytes) const
+{
+    const int segments = std::max(settings->subdivisions, 1);
+
+    // Displaced vertices on a triangular lattice; row i holds the vertices with b1 = i / segments.
+    std::vector<glm::vec3> lattice((segments + 1) * (segments + 1));
+    const auto latticeIndex = [segments](int i, int j) { return i * (segments + 1) + j; };
+    for (int i = 0; i <= segments; ++i) {
+        for (int j = 0; i + j <= segments; ++j) {
+            lattice[latticeIndex(i, j)] = EvaluateSurface(static_cast<float>(i) / segments, static_cast<float>(j) / segments);
+        }
+    }
+
+    std::shared_ptr<TessellatedPatch> patch = std::make_shared<TessellatedPatch>();
+    const auto addMicroTriangle = [&](int i0, int j0, int i1, int j1, int i2, int j2) {
+        const int corners[3][2] = { { i0, j0 }, { i1, j1 }, { i2, j2 } };
+        std::array<glm::vec3, 3> positions;
+        std::array<glm::vec2, 3> baseWeights;
+        for (int c = 0; c < 3; ++c) {
+            positions[c] = lattice[latticeIndex(corners[c][0], corners[c][1])];
+            baseWeights[c] = glm::vec2(corners[c][0], corners[c][1]) / static_cast<float>(segments);
+        }
+        patch->microTriangles.push_back(std::make_shared<MicroTriangle>(positions, baseWeights));
+    };
+
+    for (int i = 0; i < segments; ++i) {
+        for (int j = 0; i + j < segments; ++j) {
+            addMicroTriangle(i, j, i + 1, j, i, j + 1);
+            if (i + j + 1 < segments) {
+                addMicroTriangle(i + 1, j, i + 1, j + 1, i, j + 1);
+            }
+        }
+    }
+
+    patch->acceleration = AccelerationGenerator::CreateStructureFromType(AccelerationTypes::BVH);
+    patch->acceleration->Initialize(patch->microTriangles);
+
+    // A binary BVH has about as many nodes as it has leaves.
+    outputBytes = sizeof(TessellatedPatch) + patch->microTriangles.size() * (sizeof(MicroTriangle) + sizeof(std::shared_ptr<PrimitiveBase>) + sizeof(BVHNode));
+    return patch;
+}
+
+glm::vec3 DisplacedTriangle::InterpolateNormal(const glm::vec3& weights) const
+{
+    if (!base->HasVertexNormals()) {
+        return GetPrimitiveNormal();
+    }
+
+    glm::vec3 normal;
+    for (int i = 0; i < 3; ++i) {
+        normal += weights[i] * base->GetVertexNormal(vertexIndices[i]);
+    }
+    return glm::normalize(normal);
+}
+
+glm::vec2 DisplacedTriangle::InterpolateUV(const glm::vec3& weights) const
+{
+    glm::vec2 uv;
+    for (int i = 0; i < 3; ++i) {
+        uv += weights[i] * base->GetVertexUV(vertexIndices[i]);
+    }
+    return uv;
+}
+
+float DisplacedTriangle::SampleHeight(const glm::vec2& uv) const
+{
+    if (!settings->texture || !base->HasVertexUVs()) {
+        return 0.f;
+    }
+    const glm::vec4 texel = settings->texture->Sample(uv);
+    return glm::clamp((texel.r + texel.g + texel.b) / 3.f, 0.f, 1.f);
+}
+
+glm::vec3 DisplacedTriangle::EvaluateSurface(float b1, float b2) const
+{
+    const glm::vec3 weights(1.f - b1 - b2, b1, b2);
+    glm::vec3 position;
+    for (int i = 0; i < 3; ++i) {
+        position += weights[i] * base->GetVertexPosition(vertexIndices[i]);
+    }
+    return position + InterpolateNormal(weights) * settings->scale * SampleHeight(InterpolateUV(weights));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+
+struct DisplacementSettings
+{
+    // Heights are read from the average of the RGB channels and move the surface along its normal by height * scale.
+    std::shared_ptr<class Texture> texture;
+    float scale;
+    // Number of segments each edge of a patch is split into.
+    int subdivisions;
+    std::shared_ptr<class TessellationCache> cache;
+};
+
+// Triangle of a base primitive whose surface is displaced by a height texture. Only the base triangle and its
+// conservatively expanded bounds are stored; the displaced micro triangles are built lazily through the
+// TessellationCache. Hits are recorded against the patch with barycentric weights of the base triangle.
+class DisplacedTriangle : public PrimitiveBase
+{
+public:
+    DisplacedTriangle(std::shared_ptr<PrimitiveBase> inputBase, int vertex0, int vertex1, int vertex2, std::shared_ptr<const DisplacementSettings> inputSettings);
+
+    // The displaced surface is not described by vertices.
+    virtual void SetVertexPosition(int index, glm::vec3 position) override {}
+    virtual void SetVertexNormal(int index, glm::vec3 normal) override {}
+    virtual void SetVertexUV(int index, glm::vec2 uv) override {}
+    virtual void SetVertexTangentBitangent(int index, glm::vec3 tangent, glm::vec3 bitangent) override {}
+    virtual int GetTotalVertices() const override { return 0; }
+    virtual glm::vec3 GetVertexPosition(int index) const override { return glm::vec3(); }
+    virtual bool HasVertexNormals() const override { return false; }
+    virtual bool HasVertexUVs() const override { return false; }
+    virtual bool HasVertexTangentBitangents() const override { return false; }
+    virtual glm::vec3 GetVertexNormal(int index) const override { return glm::vec3(); }
+    virtual glm::vec2 GetVertexUV(int index) const override { return glm::vec2(); }
+    virtual glm::vec3 GetVertexTangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetVertexBitangent(int index) const override { return glm::vec3(); }
+
+    virtual void Finalize() override;
+    virtual Box GetBoundingBox() const override;
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual const class MeshObject* GetParentMeshObject() const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+
+    virtual bool HasNormalMap() const override;
+    virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const override;
+
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const override;
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const override;
+
+    // Builds the displaced micro triangles and their BVH. Called by the TessellationCache on a miss.
+    std::shared_ptr<struct TessellatedPatch> Tessellate(size_t& outputBytes) const;
+
+private:
+    glm::vec3 InterpolateNormal(const glm::vec3& weights) const;
+    glm::vec2 InterpolateUV(const glm::vec3& weights) const;
+    float SampleHeight(const glm::vec2& uv) const;
+    // Displaced object space position for barycentric coordinates (b1, b2) of the base triangle.
+    glm::vec3 EvaluateSurface(float b1, float b2) const;
+
+    std::shared_ptr<PrimitiveBase> base;
+    std::array<int, 3> vertexIndices;
+    std::shared_ptr<const DisplacementSettings> settings;
+    Box boundingBox;
+};
@@ -0,0 +1,35 @@
+#include "common/Scene/Geometry/Primitives/Displaced/TessellationCache.h"
+#include "common/Scene/Geometry/Primitives/Displaced/DisplacedTriangle.h"
+
+namespace
+{
+const size_t DEFAULT_TESSELLATION_BUDGET = size_t(256) * 1024 * 1024;
+}
+
+TessellationCache::TessellationCache(size_t budgetBytes):
+    patches(budgetBytes, DiagnosticsType::TESSELLATION_CACHE_HITS, DiagnosticsType::TESSELLATION_CACHE_MISSES, DiagnosticsType::TESSELLATION_CACHE_EVICTIONS)
+{
+}
+
+std::shared_ptr<TessellationCache> TessellationCache::GetDefault()
+{
+    static std::shared_ptr<TessellationCache> defaultCache = std::make_shared<TessellationCache>(DEFAULT_TESSELLATION_BUDGET);
+    return defaultCache;
+}
+
+const TessellatedPatch& TessellationCache::Acquire(const DisplacedTriangle& patch)
+{
+    return patches.FindOrCreatePinned(patch.GetUniqueId(), [&patch](size_t& patchBytes) {
+        return patch.Tessellate(patchBytes);
+    });
+}
+
+void TessellationCache::SetBudget(size_t budgetBytes)
+{
+    patches.SetBudget(budgetBytes);
+}
+
+size_t TessellationCache::GetUsedBytes() const
+{
+    return patches.GetUsedBytes();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Utility/Cache/LruCache.h"
+
+// Displaced micro triangles of one patch together with the BVH built over them.
+struct TessellatedPatch
+{
+    std::vector<std::shared_ptr<class PrimitiveBase>> microTriangles;
+    std::shared_ptr<class AccelerationStructure> acceleration;
+};
+
+// Bounded cache of tessellated patches. Patches are built the first time a ray reaches them and are rebuilt if a ray
+// comes back after they were evicted.
+class TessellationCache
+{
+public:
+    TessellationCache(size_t budgetBytes);
+
+    // Cache used by displaced meshes that were not given one explicitly.
+    static std::shared_ptr<TessellationCache> GetDefault();
+
+    // Patches stay pinned by the calling thread, so acquiring a patch again on the same thread takes no lock; see
+    // LruCache::FindOrCreatePinned for how long the returned patch stays valid.
+    const TessellatedPatch& Acquire(const class DisplacedTriangle& patch);
+
+    void SetBudget(size_t budgetBytes);
+    size_t GetUsedBytes() const;
+
+private:
+    LruCache<uint64_t, TessellatedPatch> patches;
+};
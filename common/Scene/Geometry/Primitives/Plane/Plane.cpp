@@ -0,0 +1,61 @@
+#include "common/Scene/Geometry/Primitives/Plane/Plane.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+
+Plane::Plane(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, const glm::vec2& inputSize):
+    AnalyticPrimitive(inputParent), center(inputCenter), planeNormal(glm::normalize(inputNormal)), size(inputSize)
+{
+    ComputeOrthonormalBasis(planeNormal, planeTangent, planeBitangent);
+}
+
+Plane::Plane(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, const glm::vec3& inputTangent, const glm::vec2& inputSize):
+    AnalyticPrimitive(inputParent), center(inputCenter), planeNormal(glm::normalize(inputNormal)), size(inputSize)
+{
+    // Make sure the tangent is actually in the plane.
+    planeTangent = glm::normalize(inputTangent - glm::dot(inputTangent, planeNormal) * planeNormal);
+    planeBitangent = glm::cross(planeNormal, planeTangent);
+}
+
+glm::vec3 Plane::GetPrimitiveNormal() const
+{
+    return planeNormal;
+}
+
+bool Plane::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    DIAGNOSTICS_STAT(DiagnosticsType::ANALYTIC_INTERSECTIONS);
+    assert(parentObject);
+    // Convert ray into object space.
+    const glm::vec3 rayPos = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetPosition());
+    const glm::vec3 rayDir = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetForwardDirection());
+
+    const float NdD = glm::dot(planeNormal, rayDir);
+    if (NdD > -SMALL_EPSILON && NdD < SMALL_EPSILON) {
+        return false;
+    }
+
+    const float t = glm::dot(center - rayPos, planeNormal) / NdD;
+    const glm::vec3 localPosition = rayPos + t * rayDir - center;
+    if (std::abs(glm::dot(localPosition, planeTangent)) > 0.5f * size.x || std::abs(glm::dot(localPosition, planeBitangent)) > 0.5f * size.y) {
+        return false;
+    }
+    return RecordIntersection(parentObject, inputRay, outputIntersection, t, rayPos, rayDir);
+}
+
+void Plane::ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const
+{
+    const glm::vec3 localPosition = objectPosition - center;
+    normal = planeNormal;
+    tangent = planeTangent;
+    bitangent = planeBitangent;
+    uv = glm::vec2(glm::dot(localPosition, planeTangent) / size.x, glm::dot(localPosition, planeBitangent) / size.y) + 0.5f;
+}
+
+Box Plane::ComputeBoundingBox() const
+{
+    const glm::vec3 halfU = 0.5f * size.x * planeTangent;
+    const glm::vec3 halfV = 0.5f * size.y * planeBitangent;
+    const glm::vec3 halfExtent = glm::abs(halfU) + glm::abs(halfV);
+    return Box(center - halfExtent, center + halfExtent);
+}
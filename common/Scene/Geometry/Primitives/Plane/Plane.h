@@ -0,0 +1,25 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/AnalyticPrimitive.h"
+
+// Planar rectangle centered at 'center'. The extent keeps the bounding box finite so planes can live in any acceleration structure.
+// UVs span [0, 1] across the rectangle with U along the tangent direction.
+class Plane : public AnalyticPrimitive
+{
+public:
+    Plane(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, const glm::vec2& inputSize);
+    Plane(class MeshObject* inputParent, const glm::vec3& inputCenter, const glm::vec3& inputNormal, const glm::vec3& inputTangent, const glm::vec2& inputSize);
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+
+protected:
+    virtual void ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const override;
+    virtual Box ComputeBoundingBox() const override;
+
+private:
+    glm::vec3 center;
+    glm::vec3 planeNormal;
+    glm::vec3 planeTangent;
+    glm::vec3 planeBitangent;
+    glm::vec2 size;
+};
@@ -5,6 +5,7 @@
 #include "common/Rendering/Material/Material.h"
 #include "common/Rendering/Textures/Texture.h"
 #include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
 
 template<int N>
 class Primitive : public PrimitiveBase, public SceneObject
@@ -65,16 +66,37 @@ public:
         return boundingBox;
     }
 
+    // Primitives have no acceleration data of their own, so SceneObject's packet path does not apply to them.
+    virtual uint64_t TracePacket(const class SceneObject* parentObject, struct RayPacket& packet, uint64_t laneMask) const override
+    {
+        return PrimitiveBase::TracePacket(parentObject, packet, laneMask);
+    }
+
     virtual const class MeshObject* GetParentMeshObject() const override
     {
         return parentMesh;
     }
 
+    virtual glm::vec3 GetVertexPosition(int index) const override
+    {
+        return positions[index];
+    }
+
     virtual bool HasVertexNormals() const override
     {
         return hasNormals;
     }
 
+    virtual bool HasVertexUVs() const override
+    {
+        return hasUVs;
+    }
+
+    virtual bool HasVertexTangentBitangents() const override
+    {
+        return hasTangentBitangents;
+    }
+
     virtual glm::vec3 GetVertexNormal(int index) const override
     {
         return normals[index];
@@ -84,7 +106,7 @@ public:
     {
         const Material* material = parentMesh->GetMaterial();
         if (material && hasUVs) {
-            Texture* normalTexture = material->GetTexture("normalTexture");
+            Texture* normalTexture = material->GetTexture(MaterialTextureSlot::NORMAL);
             if (normalTexture) {
                 return true;
             }
@@ -96,7 +118,7 @@ public:
     {
         assert(HasNormalMap());
         const Material* material = parentMesh->GetMaterial();
-        Texture* normalTexture = material->GetTexture("normalTexture");
+        Texture* normalTexture = material->GetTexture(MaterialTextureSlot::NORMAL);
         glm::vec3 normalMap = glm::normalize(glm::vec3(normalTexture->Sample(uv)) * 2.f - 1.f);
         return glm::mat3(worldTangent, worldBitangent, worldNormal) * normalMap;
     }
@@ -116,6 +138,17 @@ public:
         return bitangents[index];
     }
 
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const override
+    {
+        static_assert(N <= IntersectionState::MAX_PRIMITIVE_VERTICES, "Hit records cannot hold the weights for this primitive.");
+        return InterpolateIntersectionNormal(intersection);
+    }
+
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const override
+    {
+        return InterpolateIntersectionUV(intersection);
+    }
+
 protected:
     std::array<glm::vec3, N> positions;
     std::array<glm::vec3, N> normals;
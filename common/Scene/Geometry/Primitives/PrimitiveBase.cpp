@@ -0,0 +1,38 @@
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+
+glm::vec3 PrimitiveBase::InterpolateIntersectionNormal(const IntersectionState& intersection) const
+{
+    const glm::mat3& normalTransform = intersection.primitiveParent->GetNormalMatrix();
+
+    if (HasVertexNormals()) {
+        // If the mesh has normals, linearly interpolate the normals to get the normal to use.
+        glm::vec3 retNormal;
+        glm::vec3 retTangent;
+        glm::vec3 retBitangent;
+        for (int i = 0; i < GetTotalVertices(); ++i) {
+            retNormal += intersection.primitiveIntersectionWeights[i] * normalTransform * GetVertexNormal(i);
+            retTangent += intersection.primitiveIntersectionWeights[i] * normalTransform * GetVertexTangent(i);
+            retBitangent += intersection.primitiveIntersectionWeights[i] * normalTransform * GetVertexBitangent(i);
+        }
+
+        if (HasNormalMap()) {
+            return glm::normalize(GetVertexNormalMap(ComputeIntersectionUV(intersection), retTangent, retBitangent, retNormal));
+        }
+
+        return glm::normalize(retNormal);
+    }
+
+    // Otherwise, use the face normal.
+    return glm::normalize(normalTransform * GetPrimitiveNormal());
+}
+
+glm::vec2 PrimitiveBase::InterpolateIntersectionUV(const IntersectionState& intersection) const
+{
+    glm::vec2 retUV;
+    for (int i = 0; i < GetTotalVertices(); ++i) {
+        retUV += intersection.primitiveIntersectionWeights[i] * GetVertexUV(i);
+    }
+    return retUV;
+}
@@ -14,7 +14,10 @@ public:
     virtual int GetTotalVertices() const = 0;
     virtual void Finalize() = 0;
 
+    virtual glm::vec3 GetVertexPosition(int index) const = 0;
     virtual bool HasVertexNormals() const = 0;
+    virtual bool HasVertexUVs() const = 0;
+    virtual bool HasVertexTangentBitangents() const = 0;
     virtual bool HasNormalMap() const = 0;
     virtual glm::vec3 GetVertexNormal(int index) const = 0;
     virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const = 0;
@@ -22,4 +25,13 @@ public:
     virtual glm::vec2 GetVertexUV(int index) const = 0;
     virtual glm::vec3 GetVertexTangent(int index) const = 0;
     virtual glm::vec3 GetVertexBitangent(int index) const = 0;
+
+    // Shading attributes at a hit recorded by this primitive's Trace (normal is in world space).
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const = 0;
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const = 0;
+
+protected:
+    // Interpolates the per-vertex attributes using the hit weights; shared by all vertex based primitives.
+    glm::vec3 InterpolateIntersectionNormal(const struct IntersectionState& intersection) const;
+    glm::vec2 InterpolateIntersectionUV(const struct IntersectionState& intersection) const;
 };
\ No newline at end of file
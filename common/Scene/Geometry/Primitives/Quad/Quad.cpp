@@ -0,0 +1,174 @@
+#include "common/Scene/Geometry/Primitives/Quad/Quad.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Scene/SceneObject.h"
+
+Quad::Quad(class MeshObject* inputParent):
+    Primitive<4>(inputParent)
+{
+}
+
+glm::vec3 Quad::GetPrimitiveNormal() const
+{
+    return ComputeFaceNormal(positions);
+}
+
+glm::vec3 Quad::ComputeFaceNormal(const std::array<glm::vec3, 4>& positions)
+{
+    // The cross product of the diagonals is well defined for every non-degenerate quad.
+    return glm::normalize(glm::cross(positions[2] - positions[0], positions[3] - positions[1]));
+}
+
+bool Quad::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    return Intersect(positions, this, parentObject, inputRay, outputIntersection);
+}
+
+bool Quad::Intersect(const std::array<glm::vec3, 4>& positions, const PrimitiveBase* hitPrimitive, const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection)
+{
+    DIAGNOSTICS_STAT(DiagnosticsType::QUAD_INTERSECTIONS);
+    assert(parentObject);
+    // Convert ray into object space.
+    const glm::vec3 rayPos = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetPosition());
+    const glm::vec3 rayDir = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetForwardDirection());
+
+    // Use Lagae-Dutre Intersection (An Efficient Ray-Quadrilateral Intersection Test)
+    // Paper: http://graphics.cs.kuleuven.be/publications/LD05ERQIT/LD05ERQIT_paper.pdf
+    // The quad is V00 = 0, V10 = 1, V11 = 2, V01 = 3. First test against the triangle (V00, V10, V01). Alpha and beta
+    // are not bounded above by one since V11 may lie outside of the parallelogram spanned by the two edges.
+    const glm::vec3 e01 = positions[1] - positions[0];
+    const glm::vec3 e03 = positions[3] - positions[0];
+    const glm::vec3 pvec = glm::cross(rayDir, e03);
+    const float det = glm::dot(e01, pvec);
+    if (det > -SMALL_EPSILON && det < SMALL_EPSILON) {
+        return false;
+    }
+
+    const float invDet = 1.f / det;
+    const glm::vec3 tvec = rayPos - positions[0];
+    const float alpha = glm::dot(tvec, pvec) * invDet;
+    if (alpha < 0.f) {
+        return false;
+    }
+
+    const glm::vec3 qvec = glm::cross(tvec, e01);
+    const float beta = glm::dot(rayDir, qvec) * invDet;
+    if (beta < 0.f) {
+        return false;
+    }
+
+    // Outside of the first triangle, so make sure we're inside the second triangle (V11, V01, V10).
+    if (alpha + beta > 1.f) {
+        const glm::vec3 e23 = positions[3] - positions[2];
+        const glm::vec3 e21 = positions[1] - positions[2];
+        const glm::vec3 pvec2 = glm::cross(rayDir, e21);
+        const float det2 = glm::dot(e23, pvec2);
+        if (det2 > -SMALL_EPSILON && det2 < SMALL_EPSILON) {
+            return false;
+        }
+
+        const float invDet2 = 1.f / det2;
+        const glm::vec3 tvec2 = rayPos - positions[2];
+        const float alpha2 = glm::dot(tvec2, pvec2) * invDet2;
+        if (alpha2 < 0.f) {
+            return false;
+        }
+
+        const glm::vec3 qvec2 = glm::cross(tvec2, e23);
+        const float beta2 = glm::dot(rayDir, qvec2) * invDet2;
+        if (beta2 < 0.f) {
+            return false;
+        }
+    }
+
+    const float t = glm::dot(e03, qvec) * invDet;
+    if (t - inputRay->GetMaxT() > SMALL_EPSILON || t < -SMALL_EPSILON) {
+        return false;
+    }
+
+    if (outputIntersection) {
+        if (t - outputIntersection->intersectionT > SMALL_EPSILON) {
+            return false;
+        }
+
+        // Compute the bilinear coordinates of the intersection from the barycentric coordinates of V11.
+        const glm::vec3 e02 = positions[2] - positions[0];
+        const glm::vec3 normal = glm::cross(e01, e03);
+        const glm::vec3 absNormal = glm::abs(normal);
+        float alpha11, beta11;
+        if (absNormal.x >= absNormal.y && absNormal.x >= absNormal.z) {
+            alpha11 = (e02.y * e03.z - e02.z * e03.y) / normal.x;
+            beta11 = (e01.y * e02.z - e01.z * e02.y) / normal.x;
+        } else if (absNormal.y >= absNormal.z) {
+            alpha11 = (e02.z * e03.x - e02.x * e03.z) / normal.y;
+            beta11 = (e01.z * e02.x - e01.x * e02.z) / normal.y;
+        } else {
+            alpha11 = (e02.x * e03.y - e02.y * e03.x) / normal.z;
+            beta11 = (e01.x * e02.y - e01.y * e02.x) / normal.z;
+        }
+
+        float u, v;
+        if (std::abs(alpha11 - 1.f) < SMALL_EPSILON) {
+            // The quad is a trapezoid with V01-V11 parallel to V00-V10 (or a parallelogram).
+            u = alpha;
+            v = (std::abs(beta11 - 1.f) < SMALL_EPSILON) ? beta : beta / (u * (beta11 - 1.f) + 1.f);
+        } else if (std::abs(beta11 - 1.f) < SMALL_EPSILON) {
+            v = beta;
+            u = alpha / (v * (alpha11 - 1.f) + 1.f);
+        } else {
+            const float a = -(beta11 - 1.f);
+            const float b = alpha * (beta11 - 1.f) - beta * (alpha11 - 1.f) - 1.f;
+            const float c = alpha;
+            const float discriminant = std::max(b * b - 4.f * a * c, 0.f);
+            const float q = -0.5f * (b + ((b < 0.f) ? -1.f : 1.f) * std::sqrt(discriminant));
+            u = q / a;
+            if (u < 0.f || u > 1.f) {
+                u = c / q;
+            }
+            v = beta / (u * (beta11 - 1.f) + 1.f);
+        }
+
+        outputIntersection->intersectionRay = *inputRay;
+        outputIntersection->primitiveParent = parentObject;
+        outputIntersection->intersectionT = t;
+        outputIntersection->intersectedPrimitive = hitPrimitive;
+        outputIntersection->hasIntersection = true;
+
+        outputIntersection->primitiveIntersectionWeights[0] = (1.f - u) * (1.f - v);
+        outputIntersection->primitiveIntersectionWeights[1] = u * (1.f - v);
+        outputIntersection->primitiveIntersectionWeights[2] = u * v;
+        outputIntersection->primitiveIntersectionWeights[3] = (1.f - u) * v;
+    }
+
+    return true;
+}
+
+bool Quad::IsPlanarAndConvex(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3)
+{
+    const glm::vec3 diagonalNormal = glm::cross(p2 - p0, p3 - p1);
+    const float diagonalArea = glm::length(diagonalNormal);
+    if (diagonalArea < SMALL_EPSILON) {
+        return false;
+    }
+
+    // All corners should lie on the plane through the centroid...
+    const glm::vec3 normal = diagonalNormal / diagonalArea;
+    const glm::vec3 centroid = 0.25f * (p0 + p1 + p2 + p3);
+    const float tolerance = LARGE_EPSILON * std::sqrt(diagonalArea);
+    const glm::vec3 corners[4] = { p0, p1, p2, p3 };
+    for (int i = 0; i < 4; ++i) {
+        if (std::abs(glm::dot(corners[i] - centroid, normal)) > tolerance) {
+            return false;
+        }
+    }
+
+    // ...and every corner should turn in the same direction.
+    for (int i = 0; i < 4; ++i) {
+        const glm::vec3 edgeIn = corners[i] - corners[(i + 3) % 4];
+        const glm::vec3 edgeOut = corners[(i + 1) % 4] - corners[i];
+        if (glm::dot(glm::cross(edgeIn, edgeOut), normal) < SMALL_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
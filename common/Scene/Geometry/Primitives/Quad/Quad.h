@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/Primitive.h"
+
+// Planar, convex quadrilateral. Vertices are given in winding order, so vertex 0 and vertex 2 are opposite corners.
+class Quad : public Primitive<4>
+{
+public:
+    Quad(class MeshObject* inputParent);
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+
+    static glm::vec3 ComputeFaceNormal(const std::array<glm::vec3, 4>& positions);
+
+    // Intersection test shared with other primitives that store their corners differently. Hits are recorded against hitPrimitive.
+    static bool Intersect(const std::array<glm::vec3, 4>& positions, const PrimitiveBase* hitPrimitive, const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection);
+
+    // Whether the four positions are close enough to planar and convex for the quad intersection test to be exact.
+    static bool IsPlanarAndConvex(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3);
+};
@@ -0,0 +1,66 @@
+#include "common/Scene/Geometry/Primitives/Sphere/Sphere.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+
+Sphere::Sphere(class MeshObject* inputParent, const glm::vec3& inputCenter, float inputRadius):
+    AnalyticPrimitive(inputParent), center(inputCenter), radius(inputRadius)
+{
+    assert(radius > 0.f);
+}
+
+glm::vec3 Sphere::GetPrimitiveNormal() const
+{
+    // There is no single face normal; shading always goes through ComputeSurfaceFrame.
+    return glm::vec3(0.f, 1.f, 0.f);
+}
+
+bool Sphere::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    DIAGNOSTICS_STAT(DiagnosticsType::ANALYTIC_INTERSECTIONS);
+    assert(parentObject);
+    // Convert ray into object space.
+    const glm::vec3 rayPos = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetPosition());
+    const glm::vec3 rayDir = glm::vec3(parentObject->GetWorldToObjectMatrix() * inputRay->GetForwardDirection());
+
+    // Solve |rayPos + t * rayDir - center|^2 = radius^2 using the half-b form of the quadratic.
+    const glm::vec3 centerToRay = rayPos - center;
+    const float a = glm::dot(rayDir, rayDir);
+    const float halfB = glm::dot(centerToRay, rayDir);
+    const float c = glm::dot(centerToRay, centerToRay) - radius * radius;
+    const float discriminant = halfB * halfB - a * c;
+    if (discriminant < 0.f || a < SMALL_EPSILON) {
+        return false;
+    }
+
+    const float root = std::sqrt(discriminant);
+    float t = (-halfB - root) / a;
+    if (t < SMALL_EPSILON) {
+        // We are inside the sphere (or it is behind us), use the far intersection.
+        t = (-halfB + root) / a;
+    }
+    return RecordIntersection(parentObject, inputRay, outputIntersection, t, rayPos, rayDir);
+}
+
+void Sphere::ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const
+{
+    normal = glm::normalize(objectPosition - center);
+
+    const float phi = std::atan2(normal.x, normal.z);
+    const float theta = std::acos(glm::clamp(normal.y, -1.f, 1.f));
+    uv = glm::vec2(phi / (2.f * PI) + 0.5f, 1.f - theta / PI);
+
+    // Tangent follows increasing u (around the pole), bitangent follows increasing v (towards +Y).
+    const float sinTheta = std::sqrt(normal.x * normal.x + normal.z * normal.z);
+    if (sinTheta < SMALL_EPSILON) {
+        ComputeOrthonormalBasis(normal, tangent, bitangent);
+        return;
+    }
+    tangent = glm::vec3(normal.z, 0.f, -normal.x) / sinTheta;
+    bitangent = glm::cross(normal, tangent);
+}
+
+Box Sphere::ComputeBoundingBox() const
+{
+    return Box(center - glm::vec3(radius), center + glm::vec3(radius));
+}
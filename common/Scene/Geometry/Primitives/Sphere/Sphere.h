@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/AnalyticPrimitive.h"
+
+// Sphere in the object space of its parent. The texture poles lie along the +/- Y axis.
+class Sphere : public AnalyticPrimitive
+{
+public:
+    Sphere(class MeshObject* inputParent, const glm::vec3& inputCenter, float inputRadius);
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual glm::vec3 GetPrimitiveNormal() const override;
+
+protected:
+    virtual void ComputeSurfaceFrame(const glm::vec3& objectPosition, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent, glm::vec2& uv) const override;
+    virtual Box ComputeBoundingBox() const override;
+
+private:
+    glm::vec3 center;
+    float radius;
+};
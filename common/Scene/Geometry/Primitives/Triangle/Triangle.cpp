@@ -1,6 +1,7 @@
 #include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
 #include "common/Intersection/IntersectionState.h"
+#include "common/Scene/SceneObject.h"
 
 Triangle::Triangle(class MeshObject* inputParent):
     Primitive<3>(inputParent)
@@ -8,6 +9,11 @@ Triangle::Triangle(class MeshObject* inputParent):
 }
 
 glm::vec3 Triangle::GetPrimitiveNormal() const
+{
+    return ComputeFaceNormal(positions);
+}
+
+glm::vec3 Triangle::ComputeFaceNormal(const std::array<glm::vec3, 3>& positions)
 {
     const glm::vec3 edge1 = glm::normalize(positions[1] - positions[0]);
     const glm::vec3 edge2 = glm::normalize(positions[2] - positions[0]);
@@ -15,6 +21,11 @@ glm::vec3 Triangle::GetPrimitiveNormal() const
 }
 
 bool Triangle::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    return Intersect(positions, this, parentObject, inputRay, outputIntersection);
+}
+
+bool Triangle::Intersect(const std::array<glm::vec3, 3>& positions, const PrimitiveBase* hitPrimitive, const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection)
 {
     DIAGNOSTICS_STAT(DiagnosticsType::TRIANGLE_INTERSECTIONS);
     assert(parentObject);
@@ -60,13 +71,12 @@ bool Triangle::Trace(const SceneObject* parentObject, Ray* inputRay, Intersectio
         outputIntersection->intersectionRay = *inputRay;
         outputIntersection->primitiveParent = parentObject;
         outputIntersection->intersectionT = t;
-        outputIntersection->intersectedPrimitive = this;
+        outputIntersection->intersectedPrimitive = hitPrimitive;
         outputIntersection->hasIntersection = true;
 
-        outputIntersection->primitiveIntersectionWeights.clear();
-        outputIntersection->primitiveIntersectionWeights.emplace_back(1.f - u - v);
-        outputIntersection->primitiveIntersectionWeights.emplace_back(u);
-        outputIntersection->primitiveIntersectionWeights.emplace_back(v);
+        outputIntersection->primitiveIntersectionWeights[0] = 1.f - u - v;
+        outputIntersection->primitiveIntersectionWeights[1] = u;
+        outputIntersection->primitiveIntersectionWeights[2] = v;
     }
 
     return true;
@@ -8,4 +8,9 @@ public:
     Triangle(class MeshObject* inputParent);
     virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
     virtual glm::vec3 GetPrimitiveNormal() const override;
+
+    static glm::vec3 ComputeFaceNormal(const std::array<glm::vec3, 3>& positions);
+
+    // Intersection test shared with other primitives that store their corners differently. Hits are recorded against hitPrimitive.
+    static bool Intersect(const std::array<glm::vec3, 3>& positions, const PrimitiveBase* hitPrimitive, const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection);
 };
\ No newline at end of file
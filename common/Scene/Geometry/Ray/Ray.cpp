@@ -1,15 +1,13 @@
 #include "common/Scene/Geometry/Ray/Ray.h"
 
 Ray::Ray() :
-    rayDirection(glm::vec3(0.f, 0.f, -1.f)), maxT(std::numeric_limits<float>::max())
+    position(0.f, 0.f, 0.f, 1.f), rayDirection(glm::vec3(0.f, 0.f, -1.f)), maxT(std::numeric_limits<float>::max()), traceMask(), totalTraceMasks(0)
 {
-    position = glm::vec4(0.f, 0.f, 0.f, 1.f);
 }
 
 Ray::Ray(glm::vec3 inputPosition, glm::vec3 inputDirection, float inputMaxT):
-    rayDirection(glm::normalize(inputDirection)), maxT(inputMaxT)
+    position(inputPosition, 1.f), rayDirection(glm::normalize(inputDirection)), maxT(inputMaxT), traceMask(), totalTraceMasks(0)
 {
-    position = glm::vec4(inputPosition, 1.f);
 }
 
 glm::vec4 Ray::GetForwardDirection() const
@@ -39,12 +37,19 @@ glm::vec3 Ray::GetRayPosition(float t) const
 
 void Ray::SetRayMask(uint64_t objectId)
 {
-    traceMask[objectId] = true;
+    traceMask[totalTraceMasks % MAX_TRACE_MASK] = objectId;
+    ++totalTraceMasks;
 }
 
-bool Ray::IsObjectMasked(uint64_t objectId)
+bool Ray::IsObjectMasked(uint64_t objectId) const
 {
-    return traceMask[objectId];
+    const int usedMasks = std::min(totalTraceMasks, MAX_TRACE_MASK);
+    for (int i = 0; i < usedMasks; ++i) {
+        if (traceMask[i] == objectId) {
+            return true;
+        }
+    }
+    return false;
 }
 
 glm::vec3 Ray::RefractRay(const glm::vec3& normal, float n1, float& n2) const
@@ -1,8 +1,10 @@
 #pragma once
 
-#include "common/Scene/SceneObject.h"
+#include "common/common.h"
 
-class Ray : public SceneObject
+// Rays are copied into every hit record and every shadow/secondary sample so they are kept
+// small and trivially copyable -- no heap storage, no scene object bookkeeping.
+class Ray
 {
 public:
     Ray();
@@ -11,7 +13,8 @@ public:
     void SetRayPosition(const glm::vec3& input) { position = glm::vec4(input, 1.f); }
     void SetRayDirection(const glm::vec3& input) { rayDirection = input; } 
 
-    virtual glm::vec4 GetForwardDirection() const override;
+    glm::vec4 GetPosition() const { return position; }
+    glm::vec4 GetForwardDirection() const;
     glm::vec3 GetRayDirection() const;
 
     glm::vec3 GetRayPosition(float t) const;
@@ -20,12 +23,16 @@ public:
     void SetMaxT(float input);
 
     void SetRayMask(uint64_t objectId);
-    bool IsObjectMasked(uint64_t objectId);
+    bool IsObjectMasked(uint64_t objectId) const;
 
     glm::vec3 RefractRay(const glm::vec3& normal, float n1, float& n2) const;
 private:
+    glm::vec4 position;
     glm::vec3 rayDirection;
     float maxT;
 
-    std::unordered_map<uint64_t, bool> traceMask;
-};
\ No newline at end of file
+    // The trace mask only remembers the most recently missed objects; forgetting one just means it gets tested again.
+    static const int MAX_TRACE_MASK = 8;
+    std::array<uint64_t, MAX_TRACE_MASK> traceMask;
+    int totalTraceMasks;
+};
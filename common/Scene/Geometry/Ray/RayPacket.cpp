@@ -0,0 +1,96 @@
+#include "common/Scene/Geometry/Ray/RayPacket.h"
+#include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Intersection/IntersectionState.h"
+
+namespace
+{
+// Directions are never exactly zero in the frame so that the slab tests never multiply zero by infinity.
+const float MINIMUM_DIRECTION_COMPONENT = 1e-20f;
+
+float SafeInverse(float value)
+{
+    if (std::abs(value) < MINIMUM_DIRECTION_COMPONENT) {
+        value = (value < 0.f) ? -MINIMUM_DIRECTION_COMPONENT : MINIMUM_DIRECTION_COMPONENT;
+    }
+    return 1.f / value;
+}
+}
+
+RayPacket::RayPacket():
+    totalRays(0)
+{
+}
+
+void RayPacket::Clear()
+{
+    totalRays = 0;
+}
+
+int RayPacket::AddRay(Ray* ray, IntersectionState* output)
+{
+    assert(totalRays < MAX_RAYS && ray && output);
+    rays[totalRays] = ray;
+    outputs[totalRays] = output;
+    return totalRays++;
+}
+
+uint64_t RayPacket::GetLaneMask() const
+{
+    return (totalRays >= MAX_RAYS) ? ~uint64_t(0) : ((uint64_t(1) << totalRays) - 1);
+}
+
+int RayPacket::PopLane(uint64_t& laneMask)
+{
+    assert(laneMask);
+#if defined(__GNUC__) || defined(__clang__)
+    const int lane = __builtin_ctzll(laneMask);
+#else
+    int lane = 0;
+    while (!(laneMask & (uint64_t(1) << lane))) {
+        ++lane;
+    }
+#endif
+    laneMask &= laneMask - 1;
+    return lane;
+}
+
+int RayPacket::CountLanes(uint64_t laneMask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(laneMask);
+#else
+    int count = 0;
+    for (; laneMask; laneMask &= laneMask - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+RayPacketFrame::RayPacketFrame(const RayPacket& packet, uint64_t laneMask, const glm::mat4& worldToObject):
+    originX(), originY(), originZ(), inverseDirectionX(), inverseDirectionY(), inverseDirectionZ(), closestT()
+{
+    // Inactive lanes are still loaded by the 4-wide box tests, so they are left zeroed rather than uninitialized.
+    while (laneMask) {
+        const int lane = RayPacket::PopLane(laneMask);
+        const Ray* ray = packet.rays[lane];
+        // The direction is not renormalized, so distances along the ray match the ones in world space.
+        const glm::vec3 origin = glm::vec3(worldToObject * ray->GetPosition());
+        const glm::vec3 direction = glm::vec3(worldToObject * ray->GetForwardDirection());
+        originX[lane] = origin.x;
+        originY[lane] = origin.y;
+        originZ[lane] = origin.z;
+        inverseDirectionX[lane] = SafeInverse(direction.x);
+        inverseDirectionY[lane] = SafeInverse(direction.y);
+        inverseDirectionZ[lane] = SafeInverse(direction.z);
+        closestT[lane] = std::min(ray->GetMaxT(), packet.outputs[lane]->intersectionT);
+    }
+}
+
+void RayPacketFrame::UpdateClosestT(const RayPacket& packet, uint64_t laneMask)
+{
+    while (laneMask) {
+        const int lane = RayPacket::PopLane(laneMask);
+        closestT[lane] = std::min(packet.rays[lane]->GetMaxT(), packet.outputs[lane]->intersectionT);
+    }
+}
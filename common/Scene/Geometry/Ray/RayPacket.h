@@ -0,0 +1,43 @@
+#pragma once
+
+#include "common/common.h"
+
+// Group of rays that are traced together, e.g. the camera rays of a block of pixels. Lanes are addressed through
+// 64-bit masks where bit i refers to rays[i] / outputs[i].
+struct RayPacket
+{
+    static const int MAX_RAYS = 64;
+
+    RayPacket();
+
+    void Clear();
+    // Returns the lane of the new ray. Packets only support closest hit queries, so output must be valid.
+    int AddRay(class Ray* ray, struct IntersectionState* output);
+    uint64_t GetLaneMask() const;
+
+    // Returns the lowest lane in the mask and removes it from the mask.
+    static int PopLane(uint64_t& laneMask);
+    static int CountLanes(uint64_t laneMask);
+
+    int totalRays;
+    std::array<class Ray*, MAX_RAYS> rays;
+    std::array<struct IntersectionState*, MAX_RAYS> outputs;
+};
+
+// Rays of a packet in the object space of one scene object, laid out so that four lanes can be slab tested at once.
+struct RayPacketFrame
+{
+    RayPacketFrame(const RayPacket& packet, uint64_t laneMask, const glm::mat4& worldToObject);
+
+    // Refreshes the closest distances from the hit records of the given lanes.
+    void UpdateClosestT(const RayPacket& packet, uint64_t laneMask);
+
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> originX;
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> originY;
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> originZ;
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> inverseDirectionX;
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> inverseDirectionY;
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> inverseDirectionZ;
+    // Minimum of the ray's max T and the closest hit found so far.
+    alignas(16) std::array<float, RayPacket::MAX_RAYS> closestT;
+};
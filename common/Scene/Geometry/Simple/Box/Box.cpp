@@ -1,8 +1,16 @@
 #include "common/Scene/Geometry/Simple/Box/Box.h"
 #include "common/Scene/SceneObject.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Intersection/IntersectionState.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define BOX_PACKET_USE_SSE 1
+#else
+#define BOX_PACKET_USE_SSE 0
+#endif
+
 Box::Box() :
     minVertex(std::numeric_limits<float>::max()), maxVertex(std::numeric_limits<float>::lowest())
 {
@@ -96,6 +104,58 @@ bool Box::Trace(const class SceneObject* parentObject, class Ray* inputRay, stru
     return true;
 }
 
+uint64_t Box::TracePacket(const RayPacketFrame& frame, uint64_t laneMask) const
+{
+    // Counted once per packet test rather than once per lane.
+    DIAGNOSTICS_STAT(DiagnosticsType::BOX_INTERSECTIONS);
+
+    // Unlike Box::Trace, the packet test errs on the side of reporting a hit; it only decides which rays keep traversing.
+    uint64_t hitMask = 0;
+#if BOX_PACKET_USE_SSE
+    const __m128 minX = _mm_set1_ps(minVertex.x), minY = _mm_set1_ps(minVertex.y), minZ = _mm_set1_ps(minVertex.z);
+    const __m128 maxX = _mm_set1_ps(maxVertex.x), maxY = _mm_set1_ps(maxVertex.y), maxZ = _mm_set1_ps(maxVertex.z);
+    const __m128 epsilon = _mm_set1_ps(SMALL_EPSILON);
+    const __m128 zero = _mm_setzero_ps();
+    for (int base = 0; base < RayPacket::MAX_RAYS; base += 4) {
+        const uint64_t groupMask = (laneMask >> base) & 0xF;
+        if (!groupMask) {
+            continue;
+        }
+
+        const __m128 tx0 = _mm_mul_ps(_mm_sub_ps(minX, _mm_load_ps(&frame.originX[base])), _mm_load_ps(&frame.inverseDirectionX[base]));
+        const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(maxX, _mm_load_ps(&frame.originX[base])), _mm_load_ps(&frame.inverseDirectionX[base]));
+        const __m128 ty0 = _mm_mul_ps(_mm_sub_ps(minY, _mm_load_ps(&frame.originY[base])), _mm_load_ps(&frame.inverseDirectionY[base]));
+        const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(maxY, _mm_load_ps(&frame.originY[base])), _mm_load_ps(&frame.inverseDirectionY[base]));
+        const __m128 tz0 = _mm_mul_ps(_mm_sub_ps(minZ, _mm_load_ps(&frame.originZ[base])), _mm_load_ps(&frame.inverseDirectionZ[base]));
+        const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(maxZ, _mm_load_ps(&frame.originZ[base])), _mm_load_ps(&frame.inverseDirectionZ[base]));
+
+        const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), _mm_min_ps(tz0, tz1));
+        const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), _mm_max_ps(tz0, tz1));
+
+        __m128 hit = _mm_cmple_ps(tNear, _mm_add_ps(tFar, epsilon));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(tFar, zero));
+        hit = _mm_and_ps(hit, _mm_cmple_ps(tNear, _mm_add_ps(_mm_load_ps(&frame.closestT[base]), epsilon)));
+        hitMask |= (static_cast<uint64_t>(_mm_movemask_ps(hit)) & groupMask) << base;
+    }
+#else
+    for (uint64_t remaining = laneMask; remaining;) {
+        const int lane = RayPacket::PopLane(remaining);
+        const glm::vec3 origin(frame.originX[lane], frame.originY[lane], frame.originZ[lane]);
+        const glm::vec3 inverseDirection(frame.inverseDirectionX[lane], frame.inverseDirectionY[lane], frame.inverseDirectionZ[lane]);
+        const glm::vec3 t0 = (minVertex - origin) * inverseDirection;
+        const glm::vec3 t1 = (maxVertex - origin) * inverseDirection;
+        const glm::vec3 dimMinT = glm::min(t0, t1);
+        const glm::vec3 dimMaxT = glm::max(t0, t1);
+        const float tNear = std::max(std::max(dimMinT.x, dimMinT.y), dimMinT.z);
+        const float tFar = std::min(std::min(dimMaxT.x, dimMaxT.y), dimMaxT.z);
+        if (tNear <= tFar + SMALL_EPSILON && tFar >= 0.f && tNear <= frame.closestT[lane] + SMALL_EPSILON) {
+            hitMask |= uint64_t(1) << lane;
+        }
+    }
+#endif
+    return hitMask;
+}
+
 Box Box::Expand(float delta) const
 {
     Box newBoundingBox;
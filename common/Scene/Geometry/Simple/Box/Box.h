@@ -14,6 +14,8 @@ public:
     float Volume() const;
 
     bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const;
+    // Slab test for several rays at once. Returns the subset of laneMask whose rays may hit the box before their closest hit.
+    uint64_t TracePacket(const struct RayPacketFrame& frame, uint64_t laneMask) const;
     
     Box Expand(float delta) const;
     Box Transform(glm::mat4 transformation) const;
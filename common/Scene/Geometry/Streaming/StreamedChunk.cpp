@@ -0,0 +1,95 @@
+#include "common/Scene/Geometry/Streaming/StreamedChunk.h"
+#include "common/Scene/Geometry/Streaming/StreamedGeometry.h"
+#include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/SceneObject.h"
+#include "common/Intersection/IntersectionState.h"
+#include "common/Rendering/Material/Material.h"
+#include "common/Rendering/Textures/Texture.h"
+
+StreamedChunk::StreamedChunk(class MeshObject* inputParent, std::shared_ptr<StreamedGeometry> inputGeometry, uint32_t inputChunkIndex):
+    parentMesh(inputParent), geometry(std::move(inputGeometry)), chunkIndex(inputChunkIndex)
+{
+    const StreamedChunkRecord& record = geometry->GetChunkRecord(chunkIndex);
+    boundingBox = Box(record.minVertex, record.maxVertex);
+}
+
+Box StreamedChunk::GetBoundingBox() const
+{
+    return boundingBox;
+}
+
+bool StreamedChunk::Trace(const SceneObject* parentObject, Ray* inputRay, IntersectionState* outputIntersection) const
+{
+    const StreamedChunkData& data = geometry->AcquireChunk(chunkIndex);
+    bool hitChunk = false;
+    for (size_t i = 0; i < data.triangles.size(); ++i) {
+        if (!Triangle::Intersect(data.triangles[i].positions, this, parentObject, inputRay, outputIntersection)) {
+            continue;
+        }
+
+        if (!outputIntersection) {
+            return true;
+        }
+        outputIntersection->primitiveElementIndex = static_cast<int>(i);
+        hitChunk = true;
+    }
+    return hitChunk;
+}
+
+const MeshObject* StreamedChunk::GetParentMeshObject() const
+{
+    return parentMesh;
+}
+
+bool StreamedChunk::HasNormalMap() const
+{
+    const Material* material = parentMesh->GetMaterial();
+    return (material && material->GetTexture(MaterialTextureSlot::NORMAL));
+}
+
+glm::vec3 StreamedChunk::GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const
+{
+    assert(HasNormalMap());
+    const Material* material = parentMesh->GetMaterial();
+    Texture* normalTexture = material->GetTexture(MaterialTextureSlot::NORMAL);
+    glm::vec3 normalMap = glm::normalize(glm::vec3(normalTexture->Sample(uv)) * 2.f - 1.f);
+    return glm::mat3(worldTangent, worldBitangent, worldNormal) * normalMap;
+}
+
+glm::vec3 StreamedChunk::ComputeIntersectionNormal(const IntersectionState& intersection) const
+{
+    const StreamedTriangle& triangle = geometry->AcquireChunk(chunkIndex).triangles[intersection.primitiveElementIndex];
+    const glm::mat3& normalTransform = intersection.primitiveParent->GetNormalMatrix();
+
+    if (triangle.attributeFlags & StreamedTriangle::HAS_NORMALS) {
+        glm::vec3 retNormal;
+        glm::vec3 retTangent;
+        glm::vec3 retBitangent;
+        for (int i = 0; i < 3; ++i) {
+            retNormal += intersection.primitiveIntersectionWeights[i] * normalTransform * triangle.normals[i];
+            retTangent += intersection.primitiveIntersectionWeights[i] * normalTransform * triangle.tangents[i];
+            retBitangent += intersection.primitiveIntersectionWeights[i] * normalTransform * triangle.bitangents[i];
+        }
+
+        if ((triangle.attributeFlags & StreamedTriangle::HAS_UVS) && HasNormalMap()) {
+            return glm::normalize(GetVertexNormalMap(InterpolateUV(triangle, intersection), retTangent, retBitangent, retNormal));
+        }
+        return glm::normalize(retNormal);
+    }
+    return glm::normalize(normalTransform * Triangle::ComputeFaceNormal(triangle.positions));
+}
+
+glm::vec2 StreamedChunk::ComputeIntersectionUV(const IntersectionState& intersection) const
+{
+    return InterpolateUV(geometry->AcquireChunk(chunkIndex).triangles[intersection.primitiveElementIndex], intersection);
+}
+
+glm::vec2 StreamedChunk::InterpolateUV(const StreamedTriangle& triangle, const IntersectionState& intersection)
+{
+    glm::vec2 retUV;
+    for (int i = 0; i < 3; ++i) {
+        retUV += intersection.primitiveIntersectionWeights[i] * triangle.uvs[i];
+    }
+    return retUV;
+}
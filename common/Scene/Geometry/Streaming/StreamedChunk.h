@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+
+// Leaf of a streamed mesh. Only the bounds of the chunk are kept in memory; its triangles are requested from the
+// StreamedGeometry whenever a ray reaches the chunk. Hits are recorded against the chunk itself with the index of
+// the triangle inside the chunk, so shading stays valid even if the triangles get evicted in the meantime.
+class StreamedChunk : public PrimitiveBase
+{
+public:
+    StreamedChunk(class MeshObject* inputParent, std::shared_ptr<class StreamedGeometry> inputGeometry, uint32_t inputChunkIndex);
+
+    // A chunk holds many triangles, so per-vertex access does not apply.
+    virtual void SetVertexPosition(int index, glm::vec3 position) override {}
+    virtual void SetVertexNormal(int index, glm::vec3 normal) override {}
+    virtual void SetVertexUV(int index, glm::vec2 uv) override {}
+    virtual void SetVertexTangentBitangent(int index, glm::vec3 tangent, glm::vec3 bitangent) override {}
+    virtual int GetTotalVertices() const override { return 0; }
+    virtual glm::vec3 GetVertexPosition(int index) const override { return glm::vec3(); }
+    virtual bool HasVertexNormals() const override { return false; }
+    virtual bool HasVertexUVs() const override { return false; }
+    virtual bool HasVertexTangentBitangents() const override { return false; }
+    virtual glm::vec3 GetVertexNormal(int index) const override { return glm::vec3(); }
+    virtual glm::vec2 GetVertexUV(int index) const override { return glm::vec2(); }
+    virtual glm::vec3 GetVertexTangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetVertexBitangent(int index) const override { return glm::vec3(); }
+    virtual glm::vec3 GetPrimitiveNormal() const override { return glm::vec3(); }
+
+    virtual void Finalize() override {}
+    virtual Box GetBoundingBox() const override;
+    virtual bool Trace(const class SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual const class MeshObject* GetParentMeshObject() const override;
+
+    virtual bool HasNormalMap() const override;
+    virtual glm::vec3 GetVertexNormalMap(glm::vec2 uv, const glm::vec3& worldTangent, const glm::vec3& worldBitangent, const glm::vec3& worldNormal) const override;
+
+    virtual glm::vec3 ComputeIntersectionNormal(const struct IntersectionState& intersection) const override;
+    virtual glm::vec2 ComputeIntersectionUV(const struct IntersectionState& intersection) const override;
+
+private:
+    static glm::vec2 InterpolateUV(const struct StreamedTriangle& triangle, const struct IntersectionState& intersection);
+
+    const class MeshObject* parentMesh;
+    std::shared_ptr<class StreamedGeometry> geometry;
+    uint32_t chunkIndex;
+    Box boundingBox;
+};
@@ -0,0 +1,86 @@
+#include "common/Scene/Geometry/Streaming/StreamedGeometry.h"
+#include "common/Scene/Geometry/Streaming/StreamedChunk.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include <cstring>
+
+StreamedGeometry::StreamedGeometry(size_t inputResidentBudgetBytes):
+    residentChunks(inputResidentBudgetBytes, DiagnosticsType::GEOMETRY_PAGE_HITS, DiagnosticsType::GEOMETRY_PAGE_FAULTS, DiagnosticsType::GEOMETRY_PAGE_EVICTIONS)
+{
+}
+
+bool StreamedGeometry::Open(const std::string& filename)
+{
+    if (!file.Open(filename)) {
+        return false;
+    }
+
+    StreamedGeometryHeader header;
+    if (file.GetSize() < sizeof(header)) {
+        std::cerr << "ERROR: " << filename << " is too small to be a streamed geometry file." << std::endl;
+        file.Close();
+        return false;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    const uint64_t tableSize = sizeof(StreamedMeshRecord) * static_cast<uint64_t>(header.meshCount) + sizeof(StreamedChunkRecord) * header.chunkCount;
+    if (!std::equal(std::begin(STREAMED_GEOMETRY_MAGIC), std::end(STREAMED_GEOMETRY_MAGIC), header.magic) ||
+        header.version != STREAMED_GEOMETRY_VERSION || header.tableOffset > file.GetSize() || tableSize > file.GetSize() - header.tableOffset) {
+        std::cerr << "ERROR: " << filename << " is not a valid streamed geometry file." << std::endl;
+        file.Close();
+        return false;
+    }
+
+    meshRecords.resize(header.meshCount);
+    chunkRecords.resize(header.chunkCount);
+    const uint8_t* tables = file.GetData() + header.tableOffset;
+    std::memcpy(meshRecords.data(), tables, sizeof(StreamedMeshRecord) * meshRecords.size());
+    std::memcpy(chunkRecords.data(), tables + sizeof(StreamedMeshRecord) * meshRecords.size(), sizeof(StreamedChunkRecord) * chunkRecords.size());
+
+    for (const StreamedChunkRecord& record : chunkRecords) {
+        if (record.offset > header.tableOffset || sizeof(StreamedTriangle) * static_cast<uint64_t>(record.triangleCount) > header.tableOffset - record.offset) {
+            std::cerr << "ERROR: " << filename << " has a chunk that lies outside of the file." << std::endl;
+            file.Close();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::shared_ptr<MeshObject>> StreamedGeometry::CreateMeshObjects()
+{
+    std::vector<std::shared_ptr<MeshObject>> meshes;
+    for (const StreamedMeshRecord& meshRecord : meshRecords) {
+        std::shared_ptr<MeshObject> newMesh = std::make_shared<MeshObject>();
+        for (uint32_t c = 0; c < meshRecord.chunkCount; ++c) {
+            newMesh->AddPrimitive(std::make_shared<StreamedChunk>(newMesh.get(), shared_from_this(), meshRecord.firstChunk + c));
+        }
+        meshes.push_back(std::move(newMesh));
+    }
+    return meshes;
+}
+
+const StreamedChunkData& StreamedGeometry::AcquireChunk(uint32_t chunkIndex)
+{
+    return residentChunks.FindOrCreatePinned(chunkIndex, [this, chunkIndex](size_t& chunkBytes) {
+        const StreamedChunkRecord& record = chunkRecords[chunkIndex];
+        chunkBytes = sizeof(StreamedTriangle) * record.triangleCount;
+
+        // Copy the triangles out of the mapping and let the OS drop the file pages again, so that only the
+        // chunks tracked by the cache count towards the resident memory.
+        std::shared_ptr<StreamedChunkData> data = std::make_shared<StreamedChunkData>();
+        data->triangles.resize(record.triangleCount);
+        std::memcpy(data->triangles.data(), file.GetData() + record.offset, chunkBytes);
+        file.Release(static_cast<size_t>(record.offset), chunkBytes);
+        return data;
+    });
+}
+
+void StreamedGeometry::SetResidentBudget(size_t inputResidentBudgetBytes)
+{
+    residentChunks.SetBudget(inputResidentBudgetBytes);
+}
+
+size_t StreamedGeometry::GetResidentBytes() const
+{
+    return residentChunks.GetUsedBytes();
+}
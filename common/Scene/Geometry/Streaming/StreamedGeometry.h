@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Streaming/StreamedGeometryFormat.h"
+#include "common/Utility/File/MappedFile.h"
+#include "common/Utility/Cache/LruCache.h"
+
+// Triangles of one chunk that have been paged in from the mapped file.
+struct StreamedChunkData
+{
+    std::vector<StreamedTriangle> triangles;
+};
+
+// Geometry file written by StreamedGeometryWriter. Only the mesh and chunk tables are kept in memory; the triangles
+// of a chunk are paged in when a ray reaches it and are evicted in least recently used order once the resident
+// triangles exceed the budget.
+class StreamedGeometry : public std::enable_shared_from_this<StreamedGeometry>
+{
+public:
+    StreamedGeometry(size_t inputResidentBudgetBytes);
+
+    // The filename is used as is since preprocessed files generally live outside of the asset directory.
+    bool Open(const std::string& filename);
+
+    // One MeshObject per mesh in the file. Every primitive of these meshes is a StreamedChunk.
+    std::vector<std::shared_ptr<class MeshObject>> CreateMeshObjects();
+
+    // Pages the chunk in if needed. Chunks stay pinned by the calling thread, so acquiring a chunk again on the same
+    // thread takes no lock; see LruCache::FindOrCreatePinned for how long the returned data stays valid.
+    const StreamedChunkData& AcquireChunk(uint32_t chunkIndex);
+    const StreamedChunkRecord& GetChunkRecord(uint32_t chunkIndex) const { return chunkRecords[chunkIndex]; }
+
+    void SetResidentBudget(size_t inputResidentBudgetBytes);
+    size_t GetResidentBytes() const;
+
+private:
+    MappedFile file;
+    std::vector<StreamedMeshRecord> meshRecords;
+    std::vector<StreamedChunkRecord> chunkRecords;
+    LruCache<uint32_t, StreamedChunkData> residentChunks;
+};
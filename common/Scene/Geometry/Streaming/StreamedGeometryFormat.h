@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/common.h"
+
+// On-disk layout of a preprocessed geometry file. Everything is written in native byte order:
+//   StreamedGeometryHeader
+//   triangle data for every chunk (StreamedTriangle[triangleCount], referenced by StreamedChunkRecord::offset)
+//   StreamedMeshRecord[meshCount]
+//   StreamedChunkRecord[chunkCount]   (tableOffset points at the first mesh record)
+
+const uint32_t STREAMED_GEOMETRY_VERSION = 1;
+const char STREAMED_GEOMETRY_MAGIC[8] = { 'C', 'H', 'U', 'N', 'K', 'G', 'E', 'O' };
+
+struct StreamedGeometryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t meshCount;
+    uint64_t chunkCount;
+    uint64_t tableOffset;
+};
+
+// The chunks of a mesh are stored next to each other.
+struct StreamedMeshRecord
+{
+    uint32_t firstChunk;
+    uint32_t chunkCount;
+};
+
+struct StreamedChunkRecord
+{
+    glm::vec3 minVertex;
+    glm::vec3 maxVertex;
+    uint64_t offset;
+    uint32_t triangleCount;
+    uint32_t meshIndex;
+};
+
+struct StreamedTriangle
+{
+    enum AttributeFlags : uint32_t
+    {
+        HAS_NORMALS = 1 << 0,
+        HAS_UVS = 1 << 1,
+        HAS_TANGENT_BITANGENTS = 1 << 2
+    };
+
+    std::array<glm::vec3, 3> positions;
+    std::array<glm::vec3, 3> normals;
+    std::array<glm::vec2, 3> uvs;
+    std::array<glm::vec3, 3> tangents;
+    std::array<glm::vec3, 3> bitangents;
+    uint32_t attributeFlags;
+};
+
+static_assert(std::is_trivially_copyable<StreamedTriangle>::value, "StreamedTriangle is copied straight out of the mapped file.");
@@ -0,0 +1,150 @@
+#include "common/Scene/Geometry/Streaming/StreamedGeometryWriter.h"
+#include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
+#include "common/Scene/Geometry/Simple/Box/Box.h"
+#include <algorithm>
+
+namespace
+{
+glm::vec3 ComputeCentroid(const StreamedTriangle& triangle)
+{
+    return (triangle.positions[0] + triangle.positions[1] + triangle.positions[2]) / 3.f;
+}
+}
+
+StreamedGeometryWriter::StreamedGeometryWriter(const std::string& filename, int inputTrianglesPerChunk):
+    output(filename, std::ios::binary | std::ios::trunc), trianglesPerChunk(std::max(inputTrianglesPerChunk, 1))
+{
+    if (!output) {
+        std::cerr << "ERROR: Failed to open " << filename << " for writing." << std::endl;
+        return;
+    }
+
+    // Reserve space for the header; it is filled in once the tables have been written.
+    StreamedGeometryHeader header = {};
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+StreamedGeometryWriter::~StreamedGeometryWriter()
+{
+    if (output.is_open()) {
+        Close();
+    }
+}
+
+bool StreamedGeometryWriter::IsOpen() const
+{
+    return output.is_open() && output.good();
+}
+
+void StreamedGeometryWriter::AddMesh(const MeshObject& mesh)
+{
+    if (!IsOpen()) {
+        return;
+    }
+
+    std::vector<StreamedTriangle> triangles;
+    for (size_t p = 0; p < mesh.GetTotalPrimitives(); ++p) {
+        const PrimitiveBase* primitive = mesh.GetPrimitive(p);
+        const int totalVertices = primitive->GetTotalVertices();
+        if (totalVertices < 3) {
+            std::cerr << "WARNING: Streamed geometry only supports vertex based primitives. Skipping a primitive in " << mesh.GetName() << "." << std::endl;
+            continue;
+        }
+
+        uint32_t attributeFlags = 0;
+        attributeFlags |= primitive->HasVertexNormals() ? StreamedTriangle::HAS_NORMALS : 0;
+        attributeFlags |= primitive->HasVertexUVs() ? StreamedTriangle::HAS_UVS : 0;
+        attributeFlags |= primitive->HasVertexTangentBitangents() ? StreamedTriangle::HAS_TANGENT_BITANGENTS : 0;
+
+        for (int v = 1; v + 1 < totalVertices; ++v) {
+            const int indices[3] = { 0, v, v + 1 };
+            StreamedTriangle triangle;
+            for (int i = 0; i < 3; ++i) {
+                triangle.positions[i] = primitive->GetVertexPosition(indices[i]);
+                triangle.normals[i] = primitive->GetVertexNormal(indices[i]);
+                triangle.uvs[i] = primitive->GetVertexUV(indices[i]);
+                triangle.tangents[i] = primitive->GetVertexTangent(indices[i]);
+                triangle.bitangents[i] = primitive->GetVertexBitangent(indices[i]);
+            }
+            triangle.attributeFlags = attributeFlags;
+            triangles.push_back(triangle);
+        }
+    }
+
+    StreamedMeshRecord meshRecord;
+    meshRecord.firstChunk = static_cast<uint32_t>(chunkRecords.size());
+    WriteChunks(triangles, 0, triangles.size(), static_cast<uint32_t>(meshRecords.size()));
+    meshRecord.chunkCount = static_cast<uint32_t>(chunkRecords.size()) - meshRecord.firstChunk;
+    meshRecords.push_back(meshRecord);
+}
+
+void StreamedGeometryWriter::WriteChunks(std::vector<StreamedTriangle>& triangles, size_t begin, size_t end, uint32_t meshIndex)
+{
+    if (begin == end) {
+        return;
+    }
+
+    if (end - begin > static_cast<size_t>(trianglesPerChunk)) {
+        // Median split along the longest axis of the centroids, same as the BVH builds its nodes.
+        Box centroidBounds;
+        centroidBounds.Reset();
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec3 centroid = ComputeCentroid(triangles[i]);
+            centroidBounds.minVertex = glm::min(centroidBounds.minVertex, centroid);
+            centroidBounds.maxVertex = glm::max(centroidBounds.maxVertex, centroid);
+        }
+        const glm::vec3 extent = centroidBounds.maxVertex - centroidBounds.minVertex;
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+
+        const size_t middle = begin + (end - begin) / 2;
+        std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+            [axis](const StreamedTriangle& a, const StreamedTriangle& b) {
+                return ComputeCentroid(a)[axis] < ComputeCentroid(b)[axis];
+            });
+        WriteChunks(triangles, begin, middle, meshIndex);
+        WriteChunks(triangles, middle, end, meshIndex);
+        return;
+    }
+
+    StreamedChunkRecord chunkRecord;
+    chunkRecord.minVertex = glm::vec3(std::numeric_limits<float>::max());
+    chunkRecord.maxVertex = glm::vec3(std::numeric_limits<float>::lowest());
+    for (size_t i = begin; i < end; ++i) {
+        for (int v = 0; v < 3; ++v) {
+            chunkRecord.minVertex = glm::min(chunkRecord.minVertex, triangles[i].positions[v]);
+            chunkRecord.maxVertex = glm::max(chunkRecord.maxVertex, triangles[i].positions[v]);
+        }
+    }
+    chunkRecord.offset = static_cast<uint64_t>(output.tellp());
+    chunkRecord.triangleCount = static_cast<uint32_t>(end - begin);
+    chunkRecord.meshIndex = meshIndex;
+    output.write(reinterpret_cast<const char*>(&triangles[begin]), sizeof(StreamedTriangle) * (end - begin));
+    chunkRecords.push_back(chunkRecord);
+}
+
+bool StreamedGeometryWriter::Close()
+{
+    if (!output.is_open()) {
+        return false;
+    }
+
+    StreamedGeometryHeader header;
+    std::copy(std::begin(STREAMED_GEOMETRY_MAGIC), std::end(STREAMED_GEOMETRY_MAGIC), header.magic);
+    header.version = STREAMED_GEOMETRY_VERSION;
+    header.meshCount = static_cast<uint32_t>(meshRecords.size());
+    header.chunkCount = chunkRecords.size();
+    header.tableOffset = static_cast<uint64_t>(output.tellp());
+
+    output.write(reinterpret_cast<const char*>(meshRecords.data()), sizeof(StreamedMeshRecord) * meshRecords.size());
+    output.write(reinterpret_cast<const char*>(chunkRecords.data()), sizeof(StreamedChunkRecord) * chunkRecords.size());
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const bool success = output.good();
+    if (!success) {
+        std::cerr << "ERROR: Failed to write the streamed geometry file." << std::endl;
+    }
+    output.close();
+    return success;
+}
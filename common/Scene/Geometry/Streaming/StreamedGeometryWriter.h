@@ -0,0 +1,30 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Streaming/StreamedGeometryFormat.h"
+#include <fstream>
+
+// Converts meshes into the chunked file read by StreamedGeometry. Each mesh is split into spatially coherent chunks
+// and written out as soon as it is added, so the source meshes can be released one at a time.
+class StreamedGeometryWriter
+{
+public:
+    StreamedGeometryWriter(const std::string& filename, int inputTrianglesPerChunk = 64);
+    ~StreamedGeometryWriter();
+
+    bool IsOpen() const;
+
+    // Faces with more than three vertices are fan triangulated. Primitives without vertices are skipped.
+    void AddMesh(const class MeshObject& mesh);
+
+    // Writes the mesh and chunk tables. Returns false if any write failed.
+    bool Close();
+
+private:
+    void WriteChunks(std::vector<StreamedTriangle>& triangles, size_t begin, size_t end, uint32_t meshIndex);
+
+    std::ofstream output;
+    int trianglesPerChunk;
+    std::vector<StreamedMeshRecord> meshRecords;
+    std::vector<StreamedChunkRecord> chunkRecords;
+};
@@ -1,29 +1,45 @@
 #include "common/Scene/Lights/Area/AreaLight.h"
 
 AreaLight::AreaLight(const glm::vec2& size):
-    samplesToUse(4), lightSize(size)
+    samplesToUse(4), minSamplesToUse(0), lightSize(size)
 {
-    sampler = make_unique<JitterColorSampler>();
-    sampler->SetGridSize(glm::ivec3(2, 2, 1));
 }
 
-void AreaLight::ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const
+Ray AreaLight::ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const
 {
     origin += normal * LARGE_EPSILON;
-    std::random_device rd;
-    std::unique_ptr<SamplerState> sampleState = sampler->CreateSampler(rd, samplesToUse, 2);
-    for (int i = 0; i < samplesToUse; ++i) {
-        glm::vec3 sample = sampler->ComputeSampleCoordinate(*sampleState.get()) - 0.5f;
-        sample.x *= lightSize.x;
-        sample.y *= lightSize.y;
-        sample.z = 0.f;
-
-        const glm::vec3 lightPosition = glm::vec3(GetObjectToWorldMatrix() * glm::vec4(sample, 1.f));
-        const glm::vec3 rayDirection = glm::normalize(lightPosition - origin);
-        const float distanceToOrigin = glm::distance(origin, lightPosition);
-        output.emplace_back(origin, rayDirection, distanceToOrigin);
+    const glm::vec2 sample = (u - 0.5f) * lightSize;
+
+    const glm::vec3 lightPosition = glm::vec3(GetObjectToWorldMatrix() * glm::vec4(sample, 0.f, 1.f));
+    const glm::vec3 rayDirection = glm::normalize(lightPosition - origin);
+    const float distanceToOrigin = glm::distance(origin, lightPosition);
+    return Ray(origin, rayDirection, distanceToOrigin);
+}
+
+int AreaLight::GetSampleCount() const
+{
+    return std::min(samplesToUse, MAX_SAMPLES);
+}
+
+int AreaLight::GetMinSampleCount() const
+{
+    return (minSamplesToUse > 0) ? std::min(minSamplesToUse, GetSampleCount()) : GetSampleCount();
+}
+
+void AreaLight::ComputeSamples(glm::vec3 origin, glm::vec3 normal, const glm::vec2* u, int count, LightSample* samples) const
+{
+    // Same points as ComputeSampleRay, with the transform and the attenuation looked up once for all samples.
+    const glm::vec3 radiance = GetLightColor() * ComputeSampleAttenuation(origin);
+    const glm::mat4 objectToWorld = GetObjectToWorldMatrix();
+    origin += normal * LARGE_EPSILON;
+    for (int i = 0; i < count; ++i) {
+        const glm::vec2 sample = (u[i] - 0.5f) * lightSize;
+        const glm::vec3 lightPosition = glm::vec3(objectToWorld * glm::vec4(sample, 0.f, 1.f));
+        samples[i].direction = glm::normalize(lightPosition - origin);
+        samples[i].distance = glm::distance(origin, lightPosition);
+        samples[i].radiance = radiance;
+        samples[i].pdf = 1.f;
     }
-    
 }
 
 float AreaLight::ComputeLightAttenuation(glm::vec3 origin) const
@@ -35,12 +51,59 @@ float AreaLight::ComputeLightAttenuation(glm::vec3 origin) const
     return 1.f / static_cast<float>(samplesToUse);
 }
 
-void AreaLight::GenerateRandomPhotonRay(Ray& ray) const
+Box AreaLight::ComputeLightBoundingBox() const
+{
+    const glm::vec3 halfSize(0.5f * lightSize, 0.f);
+    return Box(-halfSize, halfSize).Transform(GetObjectToWorldMatrix());
+}
+
+void AreaLight::ComputeEmissionCone(glm::vec3& axis, float& cosHalfAngle) const
 {
+    // Points behind the light are not lit, see ComputeLightAttenuation.
+    axis = glm::normalize(glm::vec3(GetForwardDirection()));
+    cosHalfAngle = 0.f;
 }
 
-void AreaLight::SetSamplerAttributes(glm::ivec3 inputGridSize, int numSamples)
+float AreaLight::ComputeSampleAttenuation(glm::vec3 origin) const
 {
-    sampler->SetGridSize(inputGridSize);
-    samplesToUse = numSamples;
-}
\ No newline at end of file
+    // ComputeLightAttenuation splits the light among samplesToUse rays; a single sample carries all of it.
+    return ComputeLightAttenuation(origin) * static_cast<float>(samplesToUse);
+}
+
+void AreaLight::GenerateRandomPhotonRay(Ray& ray, RandomStream& random) const
+{
+}
+
+void AreaLight::SetSampleCount(int numSamples)
+{
+    samplesToUse = ClampSampleCount(numSamples);
+    minSamplesToUse = 0;
+}
+
+void AreaLight::SetAdaptiveSampling(int minSamples, int maxSamples)
+{
+    // A single sample cannot disagree with itself.
+    if (minSamples < 2) {
+        std::cerr << "WARNING: Adaptive area light sampling needs at least 2 initial samples, got " << minSamples << "; using 2." << std::endl;
+        minSamples = 2;
+    }
+    if (maxSamples < minSamples) {
+        std::cerr << "WARNING: Adaptive area light sampling got fewer samples (" << maxSamples << ") than initial samples (" << minSamples << "); using " << minSamples << "." << std::endl;
+        maxSamples = minSamples;
+    }
+    samplesToUse = ClampSampleCount(maxSamples);
+    minSamplesToUse = std::min(minSamples, samplesToUse);
+}
+
+int AreaLight::ClampSampleCount(int numSamples)
+{
+    if (numSamples < 1) {
+        std::cerr << "WARNING: Area lights need at least 1 sample per shading point, got " << numSamples << "; using 1." << std::endl;
+        return 1;
+    }
+    if (numSamples > MAX_SAMPLES) {
+        std::cerr << "WARNING: Area lights are sampled at most " << MAX_SAMPLES << " times per shading point, got " << numSamples << "; using " << MAX_SAMPLES << "." << std::endl;
+        return MAX_SAMPLES;
+    }
+    return numSamples;
+}
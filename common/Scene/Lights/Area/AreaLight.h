@@ -1,22 +1,40 @@
 #pragma once
 
 #include "common/Scene/Lights/Light.h"
-#include "common/Sampling/Jitter/JitterColorSampler.h"
 
 class AreaLight : public Light
 {
 public:
     AreaLight(const glm::vec2& size);
 
-    virtual void ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const override;
     virtual float ComputeLightAttenuation(glm::vec3 origin) const override;
+    virtual Ray ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const override;
+    virtual float ComputeSampleAttenuation(glm::vec3 origin) const override;
+    virtual int GetSampleCount() const override;
+    virtual int GetMinSampleCount() const override;
+    virtual void ComputeSamples(glm::vec3 origin, glm::vec3 normal, const glm::vec2* u, int count, LightSample* samples) const override;
 
-    virtual void GenerateRandomPhotonRay(Ray& ray) const override;
+    virtual Box ComputeLightBoundingBox() const override;
+    virtual void ComputeEmissionCone(glm::vec3& axis, float& cosHalfAngle) const override;
+
+    virtual void GenerateRandomPhotonRay(Ray& ray, class RandomStream& random) const override;
 
     // Sampler Attributes
-    void SetSamplerAttributes(glm::ivec3 inputGridSize, int numSamples);
+    // Samples per shading point. Renderers place them with Light::GenerateSampleCoordinates (a jittered grid for square
+    // counts). Counts above MAX_SAMPLES are capped with a warning.
+    void SetSampleCount(int numSamples);
+    // Shading points take minSamples samples and only go up to maxSamples in the penumbra, i.e. where some of the
+    // first samples are occluded and some are not. Works best with square counts where the square root of minSamples
+    // divides that of maxSamples (e.g. 4 and 16), since then all samples together still form one jittered grid.
+    // maxSamples replaces the sample count of SetSampleCount, and SetSampleCount turns adaptive sampling off.
+    // minSamples below 2 and maxSamples below minSamples are raised with a warning.
+    void SetAdaptiveSampling(int minSamples, int maxSamples);
 private:
-    std::unique_ptr<JitterColorSampler> sampler;
+    // Clamps a requested sample count to [1, MAX_SAMPLES], warning when it has to.
+    static int ClampSampleCount(int numSamples);
+
     int samplesToUse;
+    // 0 unless the light is sampled adaptively.
+    int minSamplesToUse;
     glm::vec2 lightSize;
 };
\ No newline at end of file
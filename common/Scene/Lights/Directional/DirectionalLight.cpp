@@ -1,9 +1,9 @@
 #include "common/Scene/Lights/Directional/DirectionalLight.h"
 
-void DirectionalLight::ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const
+Ray DirectionalLight::ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const
 {
     const glm::vec3 rayDirection = -1.f * glm::vec3(GetForwardDirection());
-    output.emplace_back(origin + normal * LARGE_EPSILON, rayDirection);
+    return Ray(origin + normal * LARGE_EPSILON, rayDirection);
 }
 
 float DirectionalLight::ComputeLightAttenuation(glm::vec3 origin) const
@@ -11,6 +11,11 @@ float DirectionalLight::ComputeLightAttenuation(glm::vec3 origin) const
     return 1.f;
 }
 
-void DirectionalLight::GenerateRandomPhotonRay(Ray& ray) const
+bool DirectionalLight::IsInfinite() const
+{
+    return true;
+}
+
+void DirectionalLight::GenerateRandomPhotonRay(Ray& ray, RandomStream& random) const
 {
 }
\ No newline at end of file
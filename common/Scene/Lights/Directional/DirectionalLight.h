@@ -5,8 +5,9 @@
 class DirectionalLight : public Light
 {
 public:
-    virtual void ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const override;
     virtual float ComputeLightAttenuation(glm::vec3 origin) const override;
+    virtual Ray ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const override;
+    virtual bool IsInfinite() const override;
 
-    virtual void GenerateRandomPhotonRay(Ray& ray) const override;
+    virtual void GenerateRandomPhotonRay(Ray& ray, class RandomStream& random) const override;
 };
\ No newline at end of file
@@ -1,4 +1,51 @@
 #include "common/Scene/Lights/Light.h"
+#include "common/Sampling/ColorSampler.h"
+#include "common/Utility/Random/RandomStream.h"
+#include "common/Utility/Color/Luminance.h"
+
+namespace
+{
+// The integer square root of count if count is a square, 0 otherwise.
+int ComputeSquareRoot(int count)
+{
+    const int root = static_cast<int>(std::sqrt(static_cast<float>(count)) + 0.5f);
+    return (root * root == count) ? root : 0;
+}
+
+void GenerateRandomPermutation(RandomStream& random, int count, int* output)
+{
+    for (int i = 0; i < count; ++i) {
+        output[i] = i;
+    }
+    for (int i = count - 1; i > 0; --i) {
+        std::swap(output[i], output[std::min(static_cast<int>(random.Next() * static_cast<float>(i + 1)), i)]);
+    }
+}
+
+void GenerateStratifiedCoordinates(RandomStream& random, int count, glm::vec2* u)
+{
+    // Square counts get a jittered grid.
+    const int gridSize = ComputeSquareRoot(count);
+    if (gridSize > 0) {
+        for (int i = 0; i < count; ++i) {
+            const glm::vec2 cell(static_cast<float>(i % gridSize), static_cast<float>(i / gridSize));
+            const float jitterX = random.Next();
+            const float jitterY = random.Next();
+            u[i] = (cell + glm::vec2(jitterX, jitterY)) / static_cast<float>(gridSize);
+        }
+        return;
+    }
+
+    // Other counts get one sample in every row and column of a count x count grid (N-rooks), with the columns shuffled.
+    std::array<int, Light::MAX_SAMPLES> columns;
+    GenerateRandomPermutation(random, count, columns.data());
+    for (int i = 0; i < count; ++i) {
+        const float jitterX = random.Next();
+        const float jitterY = random.Next();
+        u[i] = glm::vec2(static_cast<float>(i) + jitterX, static_cast<float>(columns[i]) + jitterY) / static_cast<float>(count);
+    }
+}
+}
 
 glm::vec3 Light::GetLightColor() const
 {
@@ -8,4 +55,102 @@ glm::vec3 Light::GetLightColor() const
 void Light::SetLightColor(glm::vec3 input)
 {
     lightColor = input;
+}
+
+int Light::GetSampleCount() const
+{
+    return 1;
+}
+
+int Light::GetMinSampleCount() const
+{
+    return GetSampleCount();
+}
+
+void Light::ComputeSamples(glm::vec3 origin, glm::vec3 normal, const glm::vec2* u, int count, LightSample* samples) const
+{
+    const glm::vec3 radiance = GetLightColor() * ComputeSampleAttenuation(origin);
+    for (int i = 0; i < count; ++i) {
+        const Ray sampleRay = ComputeSampleRay(origin, normal, u[i]);
+        samples[i].direction = sampleRay.GetRayDirection();
+        samples[i].distance = sampleRay.GetMaxT();
+        samples[i].radiance = radiance;
+        samples[i].pdf = 1.f;
+    }
+}
+
+void Light::GenerateSampleCoordinates(uint32_t key, int count, glm::vec2* u, int prefixCount, const ColorSampler* sampler)
+{
+    assert(count <= MAX_SAMPLES);
+    glm::vec3 sequenceSample;
+    if (sampler && sampler->ComputeSequenceSample(key, 0, sequenceSample)) {
+        for (int i = 0; i < count; ++i) {
+            sampler->ComputeSequenceSample(key, static_cast<uint32_t>(i), sequenceSample);
+            u[i] = glm::vec2(sequenceSample);
+        }
+        return;
+    }
+
+    RandomStream random(key);
+    if (prefixCount <= 0 || prefixCount >= count) {
+        GenerateStratifiedCoordinates(random, count, u);
+        return;
+    }
+
+    // If both counts are squares and the blocks of the prefix are made of whole grid cells, the prefix takes a random
+    // cell of every block and the rest fill in the remaining cells, so that all coordinates together form one jittered grid.
+    const int gridSize = ComputeSquareRoot(count);
+    const int blockCount = ComputeSquareRoot(prefixCount);
+    if (gridSize > 0 && blockCount > 0 && gridSize % blockCount == 0) {
+        const int blockSize = gridSize / blockCount;
+        const int cellsPerBlock = blockSize * blockSize;
+        std::array<int, MAX_SAMPLES> cellOrder;
+        for (int block = 0; block < prefixCount; ++block) {
+            const glm::vec2 blockOrigin(static_cast<float>((block % blockCount) * blockSize), static_cast<float>((block / blockCount) * blockSize));
+            GenerateRandomPermutation(random, cellsPerBlock, cellOrder.data());
+            for (int round = 0; round < cellsPerBlock; ++round) {
+                const glm::vec2 cell(static_cast<float>(cellOrder[round] % blockSize), static_cast<float>(cellOrder[round] / blockSize));
+                const float jitterX = random.Next();
+                const float jitterY = random.Next();
+                u[round * prefixCount + block] = (blockOrigin + cell + glm::vec2(jitterX, jitterY)) / static_cast<float>(gridSize);
+            }
+        }
+        return;
+    }
+
+    GenerateStratifiedCoordinates(random, prefixCount, u);
+    GenerateStratifiedCoordinates(random, count - prefixCount, u + prefixCount);
+}
+
+bool Light::GeneratePhotonRay(Ray& ray, const glm::vec2& u) const
+{
+    return false;
+}
+
+float Light::ComputeSampleAttenuation(glm::vec3 origin) const
+{
+    return ComputeLightAttenuation(origin);
+}
+
+bool Light::IsInfinite() const
+{
+    return false;
+}
+
+Box Light::ComputeLightBoundingBox() const
+{
+    const glm::vec3 lightPosition = glm::vec3(GetPosition());
+    return Box(lightPosition, lightPosition);
+}
+
+void Light::ComputeEmissionCone(glm::vec3& axis, float& cosHalfAngle) const
+{
+    axis = glm::vec3(GetForwardDirection());
+    cosHalfAngle = -1.f;
+}
+
+float Light::ComputePower() const
+{
+    // Every light hands out its color once per shading point (area lights split it among their samples).
+    return ComputeLuminance(lightColor);
 }
\ No newline at end of file
@@ -3,17 +3,68 @@
 #include "common/Scene/SceneObject.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
 
+// One sample of a light as seen from a shading point, written by Light::ComputeSamples.
+struct LightSample
+{
+    // Shadow rays start slightly above the surface, like the rays of ComputeSampleRay.
+    Ray CreateShadowRay(const glm::vec3& origin, const glm::vec3& normal) const
+    {
+        return Ray(origin + normal * LARGE_EPSILON, direction, distance);
+    }
+
+    // Normalized, from the shading point towards the sampled point of the light.
+    glm::vec3 direction;
+    // To the sampled point; the largest float for lights without a position.
+    float distance;
+    // Light color times ComputeSampleAttenuation; black if the light does not reach the shading point.
+    glm::vec3 radiance;
+    // Density of the sample over the [0, 1)^2 sample coordinates; radiance / pdf estimates the whole light.
+    float pdf;
+};
+
 class Light : public SceneObject
 {
 public:
-    virtual void ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const = 0;
+    // Most samples callers take of a light at once; ComputeSamples writes into caller-owned arrays of this size.
+    static const int MAX_SAMPLES = 64;
+
     virtual float ComputeLightAttenuation(glm::vec3 origin) const = 0;
 
+    // Number of samples a shading point should take of this light, at most MAX_SAMPLES.
+    virtual int GetSampleCount() const;
+    // Lights that are sampled adaptively are first sampled this many times; callers only take the remaining samples up
+    // to GetSampleCount when the visibility of the first ones disagrees. Equal to GetSampleCount otherwise.
+    virtual int GetMinSampleCount() const;
+    // Writes one sample per coordinate u[i] in [0, 1)^2 to samples[i] without allocating. Averaging
+    // radiance / pdf over the samples that are not occluded gives the light that reaches origin.
+    virtual void ComputeSamples(glm::vec3 origin, glm::vec3 normal, const glm::vec2* u, int count, LightSample* samples) const;
+    // Fills u[0, count) with coordinates for ComputeSamples, stratified over [0, 1)^2 and drawn from a RandomStream with the given key.
+    // The first prefixCount coordinates are stratified on their own as well, so that callers can stop after them. If sampler has a
+    // sequence of its own (see ColorSampler::ComputeSequenceSample), the coordinates are the first count points of its sequence for
+    // the key instead; Sobol points are stratified at power-of-two prefixes, Halton points at any prefix.
+    static void GenerateSampleCoordinates(uint32_t key, int count, glm::vec2* u, int prefixCount = 0, const class ColorSampler* sampler = nullptr);
+
+    // A single sample of the light as seen from origin: u in [0, 1)^2 picks the point on the light (lights without an extent ignore it).
+    // Averaging the response to these rays over uniform u, weighted by ComputeSampleAttenuation, gives the light that reaches origin.
+    virtual Ray ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const = 0;
+    virtual float ComputeSampleAttenuation(glm::vec3 origin) const;
+
     virtual glm::vec3 GetLightColor() const;
     void SetLightColor(glm::vec3 input);
 
+    // Bounds used by the LightTree to estimate how much the light can contribute to a point.
+    // Lights without a position (e.g. directional lights) are kept out of the tree and always sampled.
+    virtual bool IsInfinite() const;
+    virtual Box ComputeLightBoundingBox() const;
+    // Cone (axis and cosine of the half angle) that contains every direction the light emits into.
+    virtual void ComputeEmissionCone(glm::vec3& axis, float& cosHalfAngle) const;
+    virtual float ComputePower() const;
+
     // Photon Mapping Utility Functions
-    virtual void GenerateRandomPhotonRay(Ray& ray) const = 0;
+    virtual void GenerateRandomPhotonRay(Ray& ray, class RandomStream& random) const = 0;
+    // Emits the photon from sample coordinates u in [0, 1)^2 instead, so that a ColorSampler sequence can stratify the emission.
+    // Returns false for lights that only implement GenerateRandomPhotonRay.
+    virtual bool GeneratePhotonRay(Ray& ray, const glm::vec2& u) const;
 
 protected:
     glm::vec3 lightColor;
@@ -1,13 +1,14 @@
 #include "common/Scene/Lights/Point/PointLight.h"
+#include "common/Utility/Random/RandomStream.h"
 
 
-void PointLight::ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const
+Ray PointLight::ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const
 {
     origin += normal * LARGE_EPSILON;
     const glm::vec3 lightPosition = glm::vec3(GetPosition());
     const glm::vec3 rayDirection = glm::normalize(lightPosition - origin);
     const float distanceToOrigin = glm::distance(origin, lightPosition);
-    output.emplace_back(origin, rayDirection, distanceToOrigin);
+    return Ray(origin, rayDirection, distanceToOrigin);
 }
 
 float PointLight::ComputeLightAttenuation(glm::vec3 origin) const
@@ -15,22 +16,30 @@ float PointLight::ComputeLightAttenuation(glm::vec3 origin) const
     return 1.f;
 }
 
-float rand01l() {
-    return ((float)rand() ) / (((float) RAND_MAX) + 1.f);
-}
-
-void PointLight::GenerateRandomPhotonRay(Ray& ray) const
+void PointLight::GenerateRandomPhotonRay(Ray& ray, RandomStream& random) const
 {
     // Assignment 8 TODO: Fill in the random point light samples here.
     
     float x, y, z;
     
     do {
-        x = ( rand01l() - 0.5f ) * 2.f;
-        y = ( rand01l() - 0.5f ) * 2.f;
-        z = ( rand01l() - 0.5f ) * 2.f;
+        x = ( random.Next() - 0.5f ) * 2.f;
+        y = ( random.Next() - 0.5f ) * 2.f;
+        z = ( random.Next() - 0.5f ) * 2.f;
     } while ( x*x + y*y + z*z > 1.f );
     
     ray.SetRayDirection( glm::normalize( glm::vec3(x,y,z) ) );
     ray.SetRayPosition( glm::vec3( PointLight::GetPosition() ) );
 }
+
+
+bool PointLight::GeneratePhotonRay(Ray& ray, const glm::vec2& u) const
+{
+    // Uniform over the sphere, like the rejection sampling of GenerateRandomPhotonRay.
+    const float z = 1.f - 2.f * u.x;
+    const float radius = std::sqrt(std::max(1.f - z * z, 0.f));
+    const float phi = 2.f * PI * u.y;
+    ray.SetRayDirection(glm::vec3(radius * std::cos(phi), radius * std::sin(phi), z));
+    ray.SetRayPosition(glm::vec3(GetPosition()));
+    return true;
+}
\ No newline at end of file
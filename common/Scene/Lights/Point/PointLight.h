@@ -5,8 +5,9 @@
 class PointLight : public Light
 {
 public:
-    virtual void ComputeSampleRays(std::vector<Ray>& output, glm::vec3 origin, glm::vec3 normal) const override;
     virtual float ComputeLightAttenuation(glm::vec3 origin) const override;
+    virtual Ray ComputeSampleRay(glm::vec3 origin, glm::vec3 normal, const glm::vec2& u) const override;
 
-    virtual void GenerateRandomPhotonRay(Ray& ray) const override;
+    virtual void GenerateRandomPhotonRay(Ray& ray, class RandomStream& random) const override;
+    virtual bool GeneratePhotonRay(Ray& ray, const glm::vec2& u) const override;
 };
@@ -0,0 +1,170 @@
+#include "common/Scene/Lights/Tree/LightTree.h"
+#include "common/Scene/Lights/Light.h"
+
+void LightTree::Build(const std::vector<std::shared_ptr<Light>>& lights)
+{
+    nodes.clear();
+    infiniteLights.clear();
+
+    std::vector<BuildEntry> entries;
+    for (size_t i = 0; i < lights.size(); ++i) {
+        const Light* light = lights[i].get();
+        if (light->IsInfinite()) {
+            infiniteLights.push_back(i);
+            continue;
+        }
+
+        BuildEntry entry;
+        entry.lightIndex = i;
+        entry.lightBounds.bounds = light->ComputeLightBoundingBox();
+        light->ComputeEmissionCone(entry.lightBounds.emissionAxis, entry.lightBounds.cosEmissionAngle);
+        entry.lightBounds.power = light->ComputePower();
+
+        // Lights without any power cannot light anything, so they are never worth a shadow ray.
+        if (entry.lightBounds.power > 0.f) {
+            entries.push_back(entry);
+        }
+    }
+
+    if (entries.empty()) {
+        return;
+    }
+    nodes.reserve(2 * entries.size() - 1);
+    BuildNode(entries, 0, entries.size());
+}
+
+int LightTree::BuildNode(std::vector<BuildEntry>& entries, size_t begin, size_t end)
+{
+    const int nodeIndex = static_cast<int>(nodes.size());
+    nodes.emplace_back();
+
+    if (end - begin == 1) {
+        nodes[nodeIndex].lightBounds = entries[begin].lightBounds;
+        nodes[nodeIndex].secondChild = -1;
+        nodes[nodeIndex].lightIndex = static_cast<int>(entries[begin].lightIndex);
+        return nodeIndex;
+    }
+
+    // Median split along the axis in which the light centers are spread the most.
+    Box centerBounds;
+    for (size_t i = begin; i < end; ++i) {
+        const glm::vec3 center = entries[i].lightBounds.bounds.Center();
+        centerBounds.IncludeBox(Box(center, center));
+    }
+    const glm::vec3 extent = centerBounds.maxVertex - centerBounds.minVertex;
+    const int splitAxis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(entries.begin() + begin, entries.begin() + middle, entries.begin() + end, [splitAxis](const BuildEntry& a, const BuildEntry& b) {
+        return a.lightBounds.bounds.Center()[splitAxis] < b.lightBounds.bounds.Center()[splitAxis];
+    });
+
+    BuildNode(entries, begin, middle);
+    const int secondChild = BuildNode(entries, middle, end);
+
+    nodes[nodeIndex].lightBounds = Union(nodes[nodeIndex + 1].lightBounds, nodes[secondChild].lightBounds);
+    nodes[nodeIndex].secondChild = secondChild;
+    nodes[nodeIndex].lightIndex = -1;
+    return nodeIndex;
+}
+
+bool LightTree::SampleLight(const glm::vec3& point, float u, size_t& lightIndex, float& probability) const
+{
+    if (nodes.empty() || ComputeImportance(nodes[0].lightBounds, point) <= 0.f) {
+        return false;
+    }
+
+    const float maximumU = 1.f - std::numeric_limits<float>::epsilon();
+    int currentNode = 0;
+    probability = 1.f;
+    while (nodes[currentNode].lightIndex < 0) {
+        const int firstChild = currentNode + 1;
+        const int secondChild = nodes[currentNode].secondChild;
+        const float firstImportance = ComputeImportance(nodes[firstChild].lightBounds, point);
+        const float secondImportance = ComputeImportance(nodes[secondChild].lightBounds, point);
+        if (firstImportance + secondImportance <= 0.f) {
+            return false;
+        }
+
+        // Reuse u for the next level by remapping the part of [0, 1) that selected the child back onto [0, 1).
+        const float firstProbability = firstImportance / (firstImportance + secondImportance);
+        if (u < firstProbability) {
+            currentNode = firstChild;
+            probability *= firstProbability;
+            u = std::min(u / firstProbability, maximumU);
+        } else {
+            currentNode = secondChild;
+            probability *= 1.f - firstProbability;
+            u = std::min((u - firstProbability) / (1.f - firstProbability), maximumU);
+        }
+    }
+
+    lightIndex = static_cast<size_t>(nodes[currentNode].lightIndex);
+    return probability > 0.f;
+}
+
+LightTree::LightBounds LightTree::Union(const LightBounds& a, const LightBounds& b)
+{
+    LightBounds result;
+    result.bounds = a.bounds;
+    result.bounds.IncludeBox(b.bounds);
+    result.power = a.power + b.power;
+
+    // Smallest cone around both emission cones.
+    result.emissionAxis = a.emissionAxis;
+    result.cosEmissionAngle = -1.f;
+    if (a.cosEmissionAngle <= -1.f || b.cosEmissionAngle <= -1.f) {
+        return result;
+    }
+
+    const float angleA = std::acos(glm::clamp(a.cosEmissionAngle, -1.f, 1.f));
+    const float angleB = std::acos(glm::clamp(b.cosEmissionAngle, -1.f, 1.f));
+    const float angleBetween = std::acos(glm::clamp(glm::dot(a.emissionAxis, b.emissionAxis), -1.f, 1.f));
+    if (std::min(angleBetween + angleB, PI) <= angleA) {
+        result.cosEmissionAngle = a.cosEmissionAngle;
+        return result;
+    }
+    if (std::min(angleBetween + angleA, PI) <= angleB) {
+        result.emissionAxis = b.emissionAxis;
+        result.cosEmissionAngle = b.cosEmissionAngle;
+        return result;
+    }
+
+    const float angle = 0.5f * (angleA + angleBetween + angleB);
+    const glm::vec3 rotationAxis = glm::cross(a.emissionAxis, b.emissionAxis);
+    if (angle >= PI || glm::dot(rotationAxis, rotationAxis) < SMALL_EPSILON) {
+        return result;
+    }
+
+    // Rotate the axis of a towards the axis of b so that the new cone just touches the far side of both.
+    const float rotation = angle - angleA;
+    const glm::vec3 orthogonal = glm::normalize(glm::cross(glm::normalize(rotationAxis), a.emissionAxis));
+    result.emissionAxis = glm::normalize(std::cos(rotation) * a.emissionAxis + std::sin(rotation) * orthogonal);
+    result.cosEmissionAngle = std::cos(angle);
+    return result;
+}
+
+float LightTree::ComputeImportance(const LightBounds& lightBounds, const glm::vec3& point)
+{
+    const glm::vec3 center = lightBounds.bounds.Center();
+    const float radius = 0.5f * glm::length(lightBounds.bounds.maxVertex - lightBounds.bounds.minVertex);
+    const glm::vec3 toPoint = point - center;
+    const float distanceSquared = glm::dot(toPoint, toPoint);
+
+    float cosOrientation = 1.f;
+    if (lightBounds.cosEmissionAngle > -1.f && distanceSquared > radius * radius) {
+        // Smallest angle between the emission cone and the directions from the bounds to the point.
+        const float distance = std::sqrt(distanceSquared);
+        const float angleToPoint = std::acos(glm::clamp(glm::dot(lightBounds.emissionAxis, toPoint / distance), -1.f, 1.f));
+        const float emissionAngle = std::acos(glm::clamp(lightBounds.cosEmissionAngle, -1.f, 1.f));
+        const float boundsAngle = std::asin(std::min(radius / distance, 1.f));
+        cosOrientation = std::cos(std::max(angleToPoint - emissionAngle - boundsAngle, 0.f));
+        if (cosOrientation <= 0.f) {
+            return 0.f;
+        }
+    }
+
+    // Points inside the bounds could be arbitrarily close to any of the lights.
+    const float clampedDistanceSquared = std::max(std::max(distanceSquared, radius * radius), SMALL_EPSILON);
+    return lightBounds.power * cosOrientation / clampedDistanceSquared;
+}
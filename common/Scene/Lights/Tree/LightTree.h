@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common/common.h"
+#include "common/Scene/Geometry/Simple/Box/Box.h"
+
+// Bounding volume hierarchy over the lights of a scene that is used to pick a light in proportion to an estimate of how much
+// it contributes to a shading point, so that scenes with many lights do not have to trace a shadow ray to every one of them.
+// Each node bounds the position, the emission directions and the total power of the lights below it.
+//
+// The estimate only uses the light side (power, distance and emission cone): the materials also light points from behind
+// through their specular term, so the receiver's normal cannot be used to rule lights out.
+class LightTree
+{
+public:
+    // Lights that report IsInfinite() are not placed in the tree; they are listed in GetInfiniteLights() instead.
+    void Build(const std::vector<std::shared_ptr<class Light>>& lights);
+
+    // Picks one of the lights in the tree using the uniform random number u in [0, 1). Returns false if the tree is empty or
+    // no light in it can reach the point.
+    bool SampleLight(const glm::vec3& point, float u, size_t& lightIndex, float& probability) const;
+
+    const std::vector<size_t>& GetInfiniteLights() const
+    {
+        return infiniteLights;
+    }
+
+    bool IsEmpty() const
+    {
+        return nodes.empty();
+    }
+
+private:
+    struct LightBounds
+    {
+        Box bounds;
+        glm::vec3 emissionAxis;
+        float cosEmissionAngle;
+        float power;
+    };
+
+    struct Node
+    {
+        LightBounds lightBounds;
+        // Interior nodes store their first child right after themselves.
+        int secondChild;
+        // -1 for interior nodes.
+        int lightIndex;
+    };
+
+    struct BuildEntry
+    {
+        LightBounds lightBounds;
+        size_t lightIndex;
+    };
+
+    int BuildNode(std::vector<BuildEntry>& entries, size_t begin, size_t end);
+
+    static LightBounds Union(const LightBounds& a, const LightBounds& b);
+    static float ComputeImportance(const LightBounds& lightBounds, const glm::vec3& point);
+
+    std::vector<Node> nodes;
+    std::vector<size_t> infiniteLights;
+};
@@ -1,9 +1,9 @@
 #include "common/Scene/Scene.h"
+#include "common/Scene/SceneObject.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
-#include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
-#include "common/Scene/Geometry/Mesh/MeshObject.h"
-#include "common/Rendering/Material/Material.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Acceleration/AccelerationCommon.h"
+#include "common/Scene/Lights/Tree/LightTree.h"
 
 const float LARGERRR_EPSILON = LARGE_EPSILON;
 const float SMALLERRR_EPSILON = SMALL_EPSILON;
@@ -32,40 +32,22 @@ bool Scene::Trace(class Ray* inputRay, IntersectionState* outputIntersection) co
 {
     assert(inputRay);
     DIAGNOSTICS_STAT(DiagnosticsType::RAYS_CREATED);
+    return acceleration->Trace(nullptr, inputRay, outputIntersection);
+}
 
-    bool didIntersect = acceleration->Trace(nullptr, inputRay, outputIntersection);
-    if (outputIntersection != nullptr && didIntersect) {
-        const MeshObject* intersectedMesh = outputIntersection->intersectedPrimitive->GetParentMeshObject();
-        assert(intersectedMesh);
-        const Material* currentMaterial = intersectedMesh->GetMaterial();
-        assert(currentMaterial);
-
-        const glm::vec3 intersectionPoint = outputIntersection->intersectionRay.GetRayPosition(outputIntersection->intersectionT);
-        const float NdR = glm::dot(inputRay->GetRayDirection(), outputIntersection->ComputeNormal());
-        // send out reflection ray.
-        if (currentMaterial->IsReflective() && outputIntersection->remainingReflectionBounces > 0) {
-            outputIntersection->reflectionIntersection = std::make_shared<IntersectionState>(outputIntersection->remainingReflectionBounces - 1, outputIntersection->remainingRefractionBounces);
-
-            Ray reflectionRay;
-            PerformRaySpecularReflection(reflectionRay, *inputRay, intersectionPoint, NdR, *outputIntersection);
-            Trace(&reflectionRay, outputIntersection->reflectionIntersection.get());
-        }
-
-        // send out refraction ray.
-        if (currentMaterial->IsTransmissive() && outputIntersection->remainingRefractionBounces > 0) {
-            outputIntersection->refractionIntersection = std::make_shared<IntersectionState>(outputIntersection->remainingReflectionBounces, outputIntersection->remainingRefractionBounces - 1);
-
-            // If we're going into the mesh, set the target IOR to be the IOR of the mesh.
-            float targetIOR = (NdR < SMALLERRR_EPSILON) ? currentMaterial->GetIOR() : 1.f;
+bool Scene::TraceAnyHit(class Ray* inputRay, IntersectionState& anyHit) const
+{
+    assert(inputRay);
+    DIAGNOSTICS_STAT(DiagnosticsType::RAYS_CREATED);
+    return acceleration->TraceAnyHit(nullptr, inputRay, &anyHit);
+}
 
-            Ray refractionRay;
-            PerformRayRefraction(refractionRay, *inputRay, intersectionPoint, NdR, *outputIntersection, targetIOR);
-            outputIntersection->refractionIntersection->currentIOR = targetIOR;
-            Trace(&refractionRay, outputIntersection->refractionIntersection.get());
-        }
+uint64_t Scene::TracePacket(RayPacket& packet) const
+{
+    for (int i = 0; i < packet.totalRays; ++i) {
+        DIAGNOSTICS_STAT(DiagnosticsType::RAYS_CREATED);
     }
-
-    return didIntersect;
+    return acceleration->TracePacket(nullptr, packet, packet.GetLaneMask());
 }
 
 void Scene::PerformRaySpecularReflection(Ray& outputRay, const Ray& inputRay, const glm::vec3& intersectionPoint, const float NdR, const IntersectionState& state) const
@@ -106,4 +88,7 @@ void Scene::Finalize()
     }
     assert(acceleration);
     acceleration->Initialize(sceneObjects);
+
+    lightTree = std::make_shared<LightTree>();
+    lightTree->Build(sceneLights);
 }
@@ -15,9 +15,27 @@ public:
 
     // if outputIntersection is NULL, this merely checks whether or not the inputRay hits something.
     // if outputIntersection is NOT NULL, then this will check whether or not the inputRay hits something,
-    //      and if it does, it will store that information and perform reflection/refraction and keep going.
+    //      and if it does, it will store the closest hit. Reflection/refraction rays are spawned by the renderer while shading.
     bool Trace(class Ray* inputRay, IntersectionState* outputIntersection) const;
 
+    // Trace with an outputIntersection for callers that know the exact type of the top level acceleration structure, so that
+    // the traversal binds statically (see RenderKernel). The caller has to include the header of AccelerationType.
+    template<typename AccelerationType>
+    bool TraceClosestHit(class Ray* inputRay, IntersectionState& outputIntersection) const
+    {
+        assert(inputRay);
+        DIAGNOSTICS_STAT(DiagnosticsType::RAYS_CREATED);
+        const AccelerationType& typedAcceleration = static_cast<const AccelerationType&>(*acceleration);
+        return typedAcceleration.AccelerationType::TraceClosestHit(nullptr, inputRay, outputIntersection);
+    }
+
+    // Whether the inputRay hits anything, like Trace without an outputIntersection, but also stores the hit that ended
+    // the traversal. Used to find out which primitive blocks a shadow ray without looking for the closest one.
+    bool TraceAnyHit(class Ray* inputRay, IntersectionState& anyHit) const;
+
+    // Closest hit query for all rays of the packet. Returns the lanes that hit something.
+    uint64_t TracePacket(struct RayPacket& packet) const;
+
     size_t GetTotalObjects() const
     {
         return sceneObjects.size();
@@ -45,6 +63,17 @@ public:
         return nullptr;
     }
 
+    const class AccelerationStructure* GetAccelerationStructure() const
+    {
+        return acceleration.get();
+    }
+
+    // Built by Finalize; used to pick lights in proportion to their contribution instead of sampling every light.
+    const class LightTree* GetLightTree() const
+    {
+        return lightTree.get();
+    }
+
     void AddSceneObject(std::shared_ptr<SceneObject> object);
     void AddLight(std::shared_ptr<Light> light);
 
@@ -57,4 +86,5 @@ private:
 
     std::vector<std::shared_ptr<SceneObject>> sceneObjects;
     std::vector<std::shared_ptr<Light>> sceneLights;
+    std::shared_ptr<class LightTree> lightTree;
 };
\ No newline at end of file
@@ -1,12 +1,13 @@
 #include "common/Scene/SceneObject.h"
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
 #include "common/Scene/Geometry/Ray/Ray.h"
+#include "common/Scene/Geometry/Ray/RayPacket.h"
 #include "common/Intersection/IntersectionState.h"
 
 const float SceneObject::MINIMUM_SCALE = 0.01f;
 
 SceneObject::SceneObject():
-    worldToObjectMatrix(1.f), objectToWorldMatrix(1.f), position(0.f, 0.f, 0.f, 1.f), rotation(1.f, 0.f, 0.f, 0.f), scale(1.f), nameSet(false)
+    worldToObjectMatrix(1.f), objectToWorldMatrix(1.f), normalMatrix(1.f), position(0.f, 0.f, 0.f, 1.f), rotation(1.f, 0.f, 0.f, 0.f), scale(1.f), nameSet(false)
 {
 }
 
@@ -32,6 +33,7 @@ void SceneObject::UpdateTransformationMatrix()
     objectToWorldMatrix = glm::mat4_cast(rotation) * objectToWorldMatrix;
     objectToWorldMatrix = glm::translate(glm::mat4(1.f), glm::vec3(position)) * objectToWorldMatrix;
     worldToObjectMatrix = glm::inverse(objectToWorldMatrix);
+    normalMatrix = glm::mat3(glm::transpose(worldToObjectMatrix));
 }
 
 glm::vec4 SceneObject::GetForwardDirection() const
@@ -168,6 +170,32 @@ bool SceneObject::Trace(const SceneObject* parentObject, Ray* inputRay, Intersec
     return hit;
 }
 
+const AccelerationStructure* SceneObject::GetNestedAcceleration(const SceneObject*& parentObject) const
+{
+    parentObject = this;
+    return acceleration.get();
+}
+
+uint64_t SceneObject::TracePacket(const SceneObject* parentObject, RayPacket& packet, uint64_t laneMask) const
+{
+    uint64_t activeMask = 0;
+    while (laneMask) {
+        const int lane = RayPacket::PopLane(laneMask);
+        if (!packet.rays[lane]->IsObjectMasked(GetUniqueId())) {
+            activeMask |= uint64_t(1) << lane;
+        }
+    }
+    if (!activeMask) {
+        return 0;
+    }
+
+    const uint64_t hitMask = acceleration->TracePacket(this, packet, activeMask);
+    for (uint64_t missMask = activeMask & ~hitMask; missMask;) {
+        packet.rays[RayPacket::PopLane(missMask)]->SetRayMask(GetUniqueId());
+    }
+    return hitMask;
+}
+
 std::string SceneObject::GetChildObjectNames() const
 {
     std::ostringstream oss;
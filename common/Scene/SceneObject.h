@@ -11,6 +11,8 @@ public:
 
     virtual glm::mat4 GetObjectToWorldMatrix() const;
     virtual glm::mat4 GetWorldToObjectMatrix() const;
+    // Transforms object space normals to world space; kept up to date with the transform so that shading does not invert it per hit.
+    const glm::mat3& GetNormalMatrix() const { return normalMatrix; }
 
     virtual glm::vec4 GetForwardDirection() const;
     virtual glm::vec4 GetRightDirection() const;
@@ -54,6 +56,8 @@ public:
     }
 
     virtual bool Trace(const SceneObject* parentObject, class Ray* inputRay, struct IntersectionState* outputIntersection) const override;
+    virtual const class AccelerationStructure* GetNestedAcceleration(const SceneObject*& parentObject) const override;
+    virtual uint64_t TracePacket(const SceneObject* parentObject, struct RayPacket& packet, uint64_t laneMask) const override;
 
     virtual std::string GetHumanIdentifier() const override;
     std::string GetChildObjectNames() const;
@@ -65,6 +69,7 @@ protected:
     virtual void UpdateTransformationMatrix();
     glm::mat4 worldToObjectMatrix;
     glm::mat4 objectToWorldMatrix;
+    glm::mat3 normalMatrix;
 
     glm::vec4 position;
     glm::quat rotation;
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "common/common.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Thread safe least recently used cache with a budget in bytes. Values are handed out as shared pointers, so a value
+// stays valid for as long as a caller holds it, even after it has been evicted. The most recently used value is never
+// evicted, which lets budgets smaller than a single value still make progress.
+template<typename Key, typename Value>
+class LruCache
+{
+public:
+    // Values every thread keeps pinned for FindOrCreatePinned.
+    static const int PINNED_VALUES_PER_THREAD = 8;
+
+    LruCache(size_t inputBudgetBytes, DiagnosticsType inputHitStat, DiagnosticsType inputMissStat, DiagnosticsType inputEvictionStat):
+        cacheId(++globalCacheCount), generation(0), usedBytes(0), budgetBytes(inputBudgetBytes), hitStat(inputHitStat), missStat(inputMissStat), evictionStat(inputEvictionStat)
+    {
+    }
+
+    // FindOrCreate for lookups on the hot path. Every thread pins the values it looked up last, so looking a pinned value
+    // up again neither locks nor touches a reference count; only values the thread has not pinned go through the shared
+    // cache. The reference stays valid while the calling thread looks up fewer than PINNED_VALUES_PER_THREAD other keys
+    // of this cache. Pinned values keep their memory alive after being evicted, and using them does not count as a use
+    // for the eviction order.
+    template<typename Builder>
+    const Value& FindOrCreatePinned(const Key& key, Builder builder)
+    {
+        struct PinnedValue
+        {
+            uint64_t cacheId;
+            uint64_t generation;
+            Key key;
+            std::shared_ptr<const Value> value;
+        };
+        static thread_local std::array<PinnedValue, PINNED_VALUES_PER_THREAD> pinnedValues;
+        static thread_local int nextPinnedValue = 0;
+
+        const uint64_t currentGeneration = generation.load(std::memory_order_relaxed);
+        for (const PinnedValue& pinned : pinnedValues) {
+            if (pinned.cacheId == cacheId && pinned.generation == currentGeneration && pinned.key == key) {
+                DIAGNOSTICS_STAT(hitStat);
+                return *pinned.value;
+            }
+        }
+
+        PinnedValue& newPin = pinnedValues[nextPinnedValue];
+        nextPinnedValue = (nextPinnedValue + 1) % PINNED_VALUES_PER_THREAD;
+        newPin.value = FindOrCreate(key, builder);
+        newPin.cacheId = cacheId;
+        newPin.generation = currentGeneration;
+        newPin.key = key;
+        return *newPin.value;
+    }
+
+    // Returns the cached value for the key. On a miss, builder(size_t& outBytes) creates the value outside of the lock.
+    template<typename Builder>
+    std::shared_ptr<const Value> FindOrCreate(const Key& key, Builder builder)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto cached = entries.find(key);
+            if (cached != entries.end()) {
+                DIAGNOSTICS_STAT(hitStat);
+                leastRecentlyUsed.splice(leastRecentlyUsed.begin(), leastRecentlyUsed, cached->second.lruPosition);
+                return cached->second.value;
+            }
+        }
+
+        DIAGNOSTICS_STAT(missStat);
+        size_t valueBytes = 0;
+        std::shared_ptr<const Value> value = builder(valueBytes);
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto cached = entries.find(key);
+        if (cached != entries.end()) {
+            // Someone else built the same value in the meantime; keep theirs.
+            leastRecentlyUsed.splice(leastRecentlyUsed.begin(), leastRecentlyUsed, cached->second.lruPosition);
+            return cached->second.value;
+        }
+
+        leastRecentlyUsed.push_front(key);
+        Entry& newEntry = entries[key];
+        newEntry.value = value;
+        newEntry.bytes = valueBytes;
+        newEntry.lruPosition = leastRecentlyUsed.begin();
+        usedBytes += valueBytes;
+        EvictToBudget();
+        return value;
+    }
+
+    void SetBudget(size_t inputBudgetBytes)
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        budgetBytes = inputBudgetBytes;
+        EvictToBudget();
+    }
+
+    size_t GetUsedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return usedBytes;
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        // Makes every thread drop its pins the next time it looks a value up.
+        ++generation;
+        entries.clear();
+        leastRecentlyUsed.clear();
+        usedBytes = 0;
+    }
+
+private:
+    void EvictToBudget()
+    {
+        while (usedBytes > budgetBytes && leastRecentlyUsed.size() > 1) {
+            auto evicted = entries.find(leastRecentlyUsed.back());
+            usedBytes -= evicted->second.bytes;
+            entries.erase(evicted);
+            leastRecentlyUsed.pop_back();
+            DIAGNOSTICS_STAT(evictionStat);
+        }
+    }
+
+    struct Entry
+    {
+        std::shared_ptr<const Value> value;
+        size_t bytes;
+        typename std::list<Key>::iterator lruPosition;
+    };
+
+    // Tells apart the pinned values of different caches on the same thread.
+    static std::atomic<uint64_t> globalCacheCount;
+    const uint64_t cacheId;
+    std::atomic<uint64_t> generation;
+
+    mutable std::mutex cacheMutex;
+    std::unordered_map<Key, Entry> entries;
+    std::list<Key> leastRecentlyUsed;
+    size_t usedBytes;
+    size_t budgetBytes;
+
+    DiagnosticsType hitStat;
+    DiagnosticsType missStat;
+    DiagnosticsType evictionStat;
+};
+
+template<typename Key, typename Value>
+std::atomic<uint64_t> LruCache<Key, Value>::globalCacheCount(0);
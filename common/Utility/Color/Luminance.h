@@ -0,0 +1,9 @@
+#pragma once
+
+#include "common/common.h"
+
+// Relative luminance of a linear RGB color with Rec. 709 primaries.
+inline float ComputeLuminance(const glm::vec3& color)
+{
+    return glm::dot(color, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+}
@@ -11,11 +11,53 @@ Diagnostics* Diagnostics::Get()
 
 Diagnostics::Diagnostics()
 {
+    finishedThreadTotals.fill(0);
+}
+
+Diagnostics::ThreadStatistics::ThreadStatistics()
+{
+    for (size_t i = 0; i < counters.size(); ++i) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+
+    Diagnostics* diagnostics = Diagnostics::Get();
+    std::lock_guard<std::mutex> lock(diagnostics->threadStatisticsMutex);
+    diagnostics->threadStatistics.push_back(this);
+}
+
+Diagnostics::ThreadStatistics::~ThreadStatistics()
+{
+    Diagnostics* diagnostics = Diagnostics::Get();
+    std::lock_guard<std::mutex> lock(diagnostics->threadStatisticsMutex);
+    for (size_t i = 0; i < counters.size(); ++i) {
+        diagnostics->finishedThreadTotals[i] += counters[i].load(std::memory_order_relaxed);
+    }
+    diagnostics->threadStatistics.erase(std::find(diagnostics->threadStatistics.begin(), diagnostics->threadStatistics.end(), this));
+}
+
+Diagnostics::ThreadStatistics& Diagnostics::GetThreadStatistics()
+{
+    static thread_local ThreadStatistics statistics;
+    return statistics;
 }
 
 void Diagnostics::IncrementStat(DiagnosticsType type)
 {
-    ++statisticsAggregator[type];
+    // Only the owning thread writes the counter, so a plain load and store is enough.
+    std::atomic<uint64_t>& counter = GetThreadStatistics().counters[static_cast<size_t>(type)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+Diagnostics::StatTotals Diagnostics::GatherStatistics()
+{
+    std::lock_guard<std::mutex> lock(threadStatisticsMutex);
+    StatTotals totals = finishedThreadTotals;
+    for (const ThreadStatistics* statistics : threadStatistics) {
+        for (size_t i = 0; i < totals.size(); ++i) {
+            totals[i] += statistics->counters[i].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
 }
 
 void Diagnostics::Log(const std::string& log)
@@ -25,10 +67,23 @@ void Diagnostics::Log(const std::string& log)
 
 void Diagnostics::Print()
 {
+    const StatTotals statisticsAggregator = GatherStatistics();
     std::cout << "====================== DIAGNOSTICS START ======================" << std::endl;
-    std::cout << "Ray-Triangle Intersections: " << statisticsAggregator[DiagnosticsType::TRIANGLE_INTERSECTIONS] << std::endl;
-    std::cout << "Ray-Box Intersections: " << statisticsAggregator[DiagnosticsType::BOX_INTERSECTIONS] << std::endl;
-    std::cout << "Rays Created: " << statisticsAggregator[DiagnosticsType::RAYS_CREATED] << std::endl;
+    std::cout << "Ray-Triangle Intersections: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::TRIANGLE_INTERSECTIONS)] << std::endl;
+    std::cout << "Ray-Quad Intersections: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::QUAD_INTERSECTIONS)] << std::endl;
+    std::cout << "Ray-Analytic Intersections: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::ANALYTIC_INTERSECTIONS)] << std::endl;
+    std::cout << "Ray-Box Intersections: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::BOX_INTERSECTIONS)] << std::endl;
+    std::cout << "Rays Created: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::RAYS_CREATED)] << std::endl;
+    std::cout << "Geometry Page Hits: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::GEOMETRY_PAGE_HITS)] << std::endl;
+    std::cout << "Geometry Page Faults: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::GEOMETRY_PAGE_FAULTS)] << std::endl;
+    std::cout << "Geometry Page Evictions: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::GEOMETRY_PAGE_EVICTIONS)] << std::endl;
+    std::cout << "Tessellation Cache Hits: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::TESSELLATION_CACHE_HITS)] << std::endl;
+    std::cout << "Tessellation Cache Misses: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::TESSELLATION_CACHE_MISSES)] << std::endl;
+    std::cout << "Tessellation Cache Evictions: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::TESSELLATION_CACHE_EVICTIONS)] << std::endl;
+    std::cout << "Occluder Cache Hits: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::OCCLUDER_CACHE_HITS)] << std::endl;
+    std::cout << "Occluder Cache Misses: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::OCCLUDER_CACHE_MISSES)] << std::endl;
+    std::cout << "Light Samples: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::LIGHT_SAMPLES)] << std::endl;
+    std::cout << "Penumbra Refinements: " << statisticsAggregator[static_cast<size_t>(DiagnosticsType::PENUMBRA_REFINEMENTS)] << std::endl;
     std::cout << "====================== DIAGNOSTICS END ========================" << std::endl;
 }
 
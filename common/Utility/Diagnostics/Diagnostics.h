@@ -5,8 +5,20 @@
 enum class DiagnosticsType
 {
     TRIANGLE_INTERSECTIONS = 0,
+    QUAD_INTERSECTIONS,
+    ANALYTIC_INTERSECTIONS,
     BOX_INTERSECTIONS,
     RAYS_CREATED,
+    GEOMETRY_PAGE_HITS,
+    GEOMETRY_PAGE_FAULTS,
+    GEOMETRY_PAGE_EVICTIONS,
+    TESSELLATION_CACHE_HITS,
+    TESSELLATION_CACHE_MISSES,
+    TESSELLATION_CACHE_EVICTIONS,
+    OCCLUDER_CACHE_HITS,
+    OCCLUDER_CACHE_MISSES,
+    LIGHT_SAMPLES,
+    PENUMBRA_REFINEMENTS,
     MAX
 };
 
@@ -18,7 +30,11 @@ enum class DiagnosticsType
 #define DIAGNOSTICS_LOG(S) Diagnostics::Get()->Log(S)
 
 #include <memory>
-#include <map>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 class Diagnostics
 {
@@ -31,8 +47,26 @@ public:
     void Print();
     void Log(const std::string& log);
 private:
+    using StatTotals = std::array<uint64_t, static_cast<size_t>(DiagnosticsType::MAX)>;
 
-    std::map<DiagnosticsType, int> statisticsAggregator;
+    // Stats are incremented from every render thread, so every thread counts into its own counters and no increment
+    // contends with another thread. The counters are only atomic so that Print may read them while threads still run.
+    struct ThreadStatistics
+    {
+        ThreadStatistics();
+        ~ThreadStatistics();
+
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(DiagnosticsType::MAX)> counters;
+    };
+
+    static ThreadStatistics& GetThreadStatistics();
+    StatTotals GatherStatistics();
+
+    std::mutex threadStatisticsMutex;
+    std::vector<ThreadStatistics*> threadStatistics;
+
+    // What threads that have already finished counted.
+    StatTotals finishedThreadTotals;
 };
 
 #else
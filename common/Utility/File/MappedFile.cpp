@@ -0,0 +1,127 @@
+#include "common/Utility/File/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile():
+    data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+{
+}
+#else
+MappedFile::MappedFile():
+    data(nullptr), size(0), fileDescriptor(-1)
+{
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filename)
+{
+    Close();
+#ifdef _WIN32
+    fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        std::cerr << "ERROR: Failed to open " << filename << " for mapping." << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        std::cerr << "ERROR: " << filename << " is empty or its size could not be read." << std::endl;
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        std::cerr << "ERROR: Failed to map " << filename << "." << std::endl;
+        Close();
+        return false;
+    }
+    data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    fileDescriptor = open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::cerr << "ERROR: Failed to open " << filename << " for mapping." << std::endl;
+        return false;
+    }
+
+    struct stat fileStats;
+    if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0) {
+        std::cerr << "ERROR: " << filename << " is empty or its size could not be read." << std::endl;
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileStats.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapping != MAP_FAILED) {
+        data = static_cast<const uint8_t*>(mapping);
+        // Chunks are visited in whatever order the rays go, so readahead mostly wastes memory.
+        madvise(mapping, size, MADV_RANDOM);
+    }
+#endif
+
+    if (!data) {
+        std::cerr << "ERROR: Failed to map " << filename << "." << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    if (fileDescriptor >= 0) {
+        close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+void MappedFile::Release(size_t offset, size_t length) const
+{
+    if (!data || offset >= size) {
+        return;
+    }
+    length = std::min(length, size - offset);
+#ifdef _WIN32
+    // The working set manager trims clean mapped pages by itself.
+#else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = offset - (offset % pageSize);
+    madvise(const_cast<uint8_t*>(data) + alignedOffset, length + (offset - alignedOffset), MADV_DONTNEED);
+#endif
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "common/common.h"
+
+// Read-only memory mapping of an entire file. Pages are brought in by the OS on first access.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    const uint8_t* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+    // Hints that a range is not going to be read again soon so the OS may drop its pages.
+    void Release(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+};
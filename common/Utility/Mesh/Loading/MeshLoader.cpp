@@ -1,6 +1,7 @@
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
 #include "common/Utility/Mesh/Loading/MeshLoader.h"
 #include "common/Scene/Geometry/Primitives/Triangle/Triangle.h"
+#include "common/Scene/Geometry/Primitives/Quad/Quad.h"
 #include "common/Scene/Geometry/Primitives/PrimitiveBase.h"
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
@@ -11,6 +12,95 @@
 #include <map>
 #include <queue>
 
+namespace
+{
+// Twice the signed area of the 2D triangle abc; positive if it turns counterclockwise.
+float ComputeSignedArea(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// Splits a polygon with more than 3 vertices into triangles that keep its winding. Convex polygons are fanned from their first
+// vertex; the rest are ear-clipped in the plane of their largest normal component, like Assimp's triangulation, so that concave
+// polygons do not get overlapping or missing triangles.
+std::vector<std::array<unsigned int, 3>> TriangulatePolygon(const aiFace& face, const std::vector<glm::vec3>& allPosition)
+{
+    const unsigned int totalVertices = face.mNumIndices;
+
+    // Newell's method gives the normal of non-planar polygons too.
+    glm::vec3 normal;
+    for (unsigned int i = 0; i < totalVertices; ++i) {
+        normal += glm::cross(allPosition[face.mIndices[i]], allPosition[face.mIndices[(i + 1) % totalVertices]]);
+    }
+    const glm::vec3 absNormal = glm::abs(normal);
+    const int axis = (absNormal.x > absNormal.y) ? ((absNormal.x > absNormal.z) ? 0 : 2) : ((absNormal.y > absNormal.z) ? 1 : 2);
+    // Swapping the two remaining axes for a negative normal makes the projected polygon counterclockwise.
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+    if (normal[axis] < 0.f) {
+        std::swap(uAxis, vAxis);
+    }
+    std::vector<glm::vec2> projected(totalVertices);
+    for (unsigned int i = 0; i < totalVertices; ++i) {
+        const glm::vec3& position = allPosition[face.mIndices[i]];
+        projected[i] = glm::vec2(position[uAxis], position[vAxis]);
+    }
+
+    std::vector<unsigned int> remaining(totalVertices);
+    for (unsigned int i = 0; i < totalVertices; ++i) {
+        remaining[i] = i;
+    }
+
+    bool isConvex = true;
+    for (unsigned int i = 0; i < totalVertices && isConvex; ++i) {
+        isConvex = ComputeSignedArea(projected[(i + totalVertices - 1) % totalVertices], projected[i], projected[(i + 1) % totalVertices]) >= 0.f;
+    }
+
+    std::vector<std::array<unsigned int, 3>> triangles;
+    while (!isConvex && remaining.size() > 3) {
+        const size_t totalRemaining = remaining.size();
+        bool clippedEar = false;
+        for (size_t i = 0; i < totalRemaining && !clippedEar; ++i) {
+            const unsigned int previous = remaining[(i + totalRemaining - 1) % totalRemaining];
+            const unsigned int current = remaining[i];
+            const unsigned int next = remaining[(i + 1) % totalRemaining];
+            if (ComputeSignedArea(projected[previous], projected[current], projected[next]) <= 0.f) {
+                continue;
+            }
+
+            // An ear must not contain any other vertex of the polygon.
+            bool isEar = true;
+            for (size_t k = 0; k < totalRemaining && isEar; ++k) {
+                const unsigned int other = remaining[k];
+                if (other == previous || other == current || other == next) {
+                    continue;
+                }
+                isEar = !(ComputeSignedArea(projected[previous], projected[current], projected[other]) >= 0.f &&
+                    ComputeSignedArea(projected[current], projected[next], projected[other]) >= 0.f &&
+                    ComputeSignedArea(projected[next], projected[previous], projected[other]) >= 0.f);
+            }
+            if (!isEar) {
+                continue;
+            }
+
+            triangles.push_back({ { face.mIndices[previous], face.mIndices[current], face.mIndices[next] } });
+            remaining.erase(remaining.begin() + i);
+            clippedEar = true;
+        }
+
+        // Self-intersecting or degenerate polygons may have no ear left; fan what remains of them.
+        if (!clippedEar) {
+            break;
+        }
+    }
+
+    for (size_t v = 1; v + 1 < remaining.size(); ++v) {
+        triangles.push_back({ { face.mIndices[remaining[0]], face.mIndices[remaining[v]], face.mIndices[remaining[v + 1]] } });
+    }
+    return triangles;
+}
+}
+
 namespace MeshLoader
 {
 
@@ -43,7 +133,7 @@ void LoadFaceIntoPrimitive(const aiFace& face, PrimitiveBase& primitive, std::ve
     }
 }
 
-std::vector<std::shared_ptr<MeshObject>> LoadMesh(const std::string& filename, std::vector<std::shared_ptr<aiMaterial>>* outputMaterials)
+std::vector<std::shared_ptr<MeshObject>> LoadMesh(const std::string& filename, std::vector<std::shared_ptr<aiMaterial>>* outputMaterials, bool keepQuads)
 {
 
 #ifndef ASSET_PATH
@@ -55,10 +145,11 @@ std::vector<std::shared_ptr<MeshObject>> LoadMesh(const std::string& filename, s
 
     const std::string completeFilename = std::string(STRINGIFY(ASSET_PATH)) + "/" + filename;
 
+    // Quads and larger polygons are split up below (see TriangulatePolygon) when we keep quads, so only ask Assimp to triangulate otherwise.
     const aiScene* scene = importer.ReadFile(completeFilename.c_str(),
             aiProcess_GenNormals |
             aiProcess_CalcTangentSpace       | 
-            aiProcess_Triangulate            |
+            (keepQuads ? 0 : aiProcess_Triangulate) |
             aiProcess_JoinIdenticalVertices  |
             aiProcess_FixInfacingNormals |
             aiProcess_FindInstances |
@@ -130,6 +221,18 @@ std::vector<std::shared_ptr<MeshObject>> LoadMesh(const std::string& filename, s
                 if (face.mNumIndices == 3) {
                     newPrimitive = std::make_shared<Triangle>(newMesh.get());
                     LoadFaceIntoPrimitive(face, *newPrimitive.get(), allPosition, allNormals, allUV, allTangents, allBitangents);
+                } else if (keepQuads && face.mNumIndices == 4 && 
+                    Quad::IsPlanarAndConvex(allPosition[face.mIndices[0]], allPosition[face.mIndices[1]], allPosition[face.mIndices[2]], allPosition[face.mIndices[3]])) {
+                    newPrimitive = std::make_shared<Quad>(newMesh.get());
+                    LoadFaceIntoPrimitive(face, *newPrimitive.get(), allPosition, allNormals, allUV, allTangents, allBitangents);
+                } else if (keepQuads && face.mNumIndices > 3) {
+                    // Non-planar or concave quads and larger polygons get split into triangles.
+                    for (std::array<unsigned int, 3>& indices : TriangulatePolygon(face, allPosition)) {
+                        std::shared_ptr<PrimitiveBase> polygonTriangle = std::make_shared<Triangle>(newMesh.get());
+                        LoadFaceIntoPrimitive(3, indices.data(), *polygonTriangle.get(), allPosition, allNormals, allUV, allTangents, allBitangents);
+                        newMesh->AddPrimitive(polygonTriangle);
+                    }
+                    continue;
                 } else {
                     std::cerr << "WARNING: Input mesh has an unsupported primitive type. Skipping face with: " << face.mNumIndices << " vertices." << std::endl;
                     continue;
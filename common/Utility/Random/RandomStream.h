@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/common.h"
+#include <cstring>
+
+// Counter-based random numbers: the n-th number of a stream is a hash of the stream's key and n. A stream is two integers,
+// costs nothing to create and returns the same numbers no matter which thread asks or in which order streams are used,
+// so keys built from e.g. the render seed, pixel and sample index give reproducible images independent of thread count.
+class RandomStream
+{
+public:
+    explicit RandomStream(uint32_t inputKey):
+        key(inputKey), counter(0)
+    {
+    }
+
+    // Uniform number in [0, 1).
+    float Next()
+    {
+        return ToFloat(Hash(key, counter++));
+    }
+
+    // PCG output permutation (Jarzynski and Olano, "Hash Functions for GPU Rendering").
+    static uint32_t Hash(uint32_t value)
+    {
+        const uint32_t state = value * 747796405u + 2891336453u;
+        const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    static uint32_t Hash(uint32_t a, uint32_t b)
+    {
+        return Hash(Hash(a) + b);
+    }
+
+    static uint32_t Hash(uint32_t a, uint32_t b, uint32_t c)
+    {
+        return Hash(Hash(Hash(a) + b) + c);
+    }
+
+    static uint32_t Hash(const glm::vec3& value)
+    {
+        uint32_t bits[3];
+        std::memcpy(bits, &value[0], sizeof(bits));
+        return Hash(bits[0], bits[1], bits[2]);
+    }
+
+    // Uses the top 24 bits so that the result is exactly representable and below 1.
+    static float ToFloat(uint32_t value)
+    {
+        return static_cast<float>(value >> 8) * (1.f / 16777216.f);
+    }
+
+private:
+    uint32_t key;
+    uint32_t counter;
+};
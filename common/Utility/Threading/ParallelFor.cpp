@@ -0,0 +1,41 @@
+#include "common/Utility/Threading/ParallelFor.h"
+#include <atomic>
+#include <thread>
+
+int GetDefaultThreadCount()
+{
+    // hardware_concurrency is allowed to return 0 when the value is unknown.
+    return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body, int threadCount)
+{
+    if (!count) {
+        return;
+    }
+
+    grainSize = std::max(grainSize, size_t(1));
+    const size_t totalRanges = (count + grainSize - 1) / grainSize;
+    if (threadCount <= 0) {
+        threadCount = GetDefaultThreadCount();
+    }
+    threadCount = static_cast<int>(std::min(static_cast<size_t>(threadCount), totalRanges));
+
+    std::atomic<size_t> nextRange(0);
+    auto worker = [&]() {
+        for (size_t range = nextRange++; range < totalRanges; range = nextRange++) {
+            const size_t begin = range * grainSize;
+            body(begin, std::min(begin + grainSize, count));
+        }
+    };
+
+    // The calling thread works too, so a single thread never pays for spawning one.
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "common/common.h"
+
+// Calls body(begin, end) for consecutive ranges of at most grainSize indices that together cover [0, count). Ranges
+// are handed out dynamically to the worker threads, so callers must not rely on which thread runs which range, but
+// range boundaries always fall on multiples of grainSize. A threadCount of 0 uses every hardware thread.
+void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body, int threadCount = 0);
+
+int GetDefaultThreadCount();
@@ -7,6 +7,13 @@
 #include "common/Scene/Camera/Camera.h"
 #include "common/Scene/Camera/Perspective/PerspectiveCamera.h"
 #include "common/Scene/Geometry/Mesh/MeshObject.h"
+#include "common/Scene/Geometry/Primitives/Quad/Quad.h"
+#include "common/Scene/Geometry/Primitives/Sphere/Sphere.h"
+#include "common/Scene/Geometry/Primitives/Plane/Plane.h"
+#include "common/Scene/Geometry/Primitives/Disk/Disk.h"
+#include "common/Scene/Geometry/Primitives/Displaced/TessellationCache.h"
+#include "common/Scene/Geometry/Streaming/StreamedGeometry.h"
+#include "common/Scene/Geometry/Streaming/StreamedGeometryWriter.h"
 #include "common/Scene/Lights/Light.h"
 #include "common/Scene/Lights/Point/PointLight.h"
 #include "common/Scene/Lights/Area/AreaLight.h"